@@ -1,9 +1,15 @@
 #include "Application.hpp"
 
+#include <cstdlib>
+
 #include "core/CpuImpl.hpp"
+#include "core/CpuFactory.hpp"
+#include "core/AotCpuImpl.hpp"
 #include "core/BusImpl.hpp"
 #include "core/MemoryImpl.hpp"
+#include "core/TracingMemory.hpp"
 #include "core/GraphicsImpl.hpp"
+#include "core/SchedulerImpl.hpp"
 
 #include "graphics/SFMLGraphicsServiceImpl.hpp"
 
@@ -12,31 +18,85 @@
 
 #include "facades/RomFacadeImpl.hpp"
 #include "facades/RomFileInputStream.hpp"
+#include "facades/MappedRomInputStream.hpp"
 #include "facades/SFMLGraphicsFacadeImpl.hpp"
 #include "facades/InstructionExecutionFacadeImpl.hpp"
+#include "facades/SnapshotFacadeImpl.hpp"
+#include "facades/TranslationCache.hpp"
+
+namespace
+{
+    const char* TRANSLATION_CACHE_DIRECTORY = ".chip16-cache";
+
+    // Environment variable selecting cpu backend, "interpreter" or "jit"
+    const char* CPU_BACKEND_VARIABLE = "CHIP16_CPU_BACKEND";
+
+#if defined(CHIP16_JIT)
+    const CpuBackend DEFAULT_CPU_BACKEND = CpuBackend::JIT;
+#else
+    const CpuBackend DEFAULT_CPU_BACKEND = CpuBackend::INTERPRETER;
+#endif
+
+    std::shared_ptr<RecompilingCpuBase> createCpu(const std::shared_ptr<RecompilingCpuBase::MemoryType>& memory,
+        const std::shared_ptr<StaticBusImpl>& bus)
+    {
+#if defined(CHIP16_AOT)
+        return std::make_shared<AotCpuImpl>(memory, bus, getTranslatedProgram());
+#else
+        const char* backendName = std::getenv(CPU_BACKEND_VARIABLE);
+        const auto backend = backendName != nullptr
+            ? CpuFactory::parseBackend(backendName, DEFAULT_CPU_BACKEND)
+            : DEFAULT_CPU_BACKEND;
+        return CpuFactory::create(backend, memory, bus);
+#endif
+    }
+}
 
 Application::Application()
 {
     window.create(sf::VideoMode{320, 240, 32}, "Chip16 emulator", sf::Style::Close);
     viewManager = std::make_unique<SFMLViewManager>(window);
 
+    // Core objects are created before the injector, as backend of the cpu is selected at runtime
+    auto graphics = std::make_shared<GraphicsImpl>();
+    auto bus = std::make_shared<StaticBusImpl>(graphics);
+    auto memoryImpl = std::make_shared<MemoryImpl>();
+#if defined(CHIP16_TRACE_MEMORY)
+    // Cpu accesses memory through the interface, so its accesses are logged
+    auto memory = std::make_shared<TracingMemory>(memoryImpl);
+#else
+    auto memory = memoryImpl;
+#endif
+    auto cpu = createCpu(memory, bus);
+    cpu->setLazyFlags(true);
+    cpu->setDeadFlagsElimination(true);
+    cpu->setInstructionFusion(true);
+    cpu->setIdleLoopDetection(true);
+
     auto injector = boost::di::make_injector(
         
-        // Core interfaces
-        boost::di::bind<Cpu>.to<CpuImpl>(),
-        boost::di::bind<Bus>.to<BusImpl>(),
-        boost::di::bind<Memory>.to<MemoryImpl>(),
-        boost::di::bind<Graphics>.to<GraphicsImpl>(),
+        // Core interfaces, concrete types share instances with interfaces
+        boost::di::bind<Cpu>.to(std::static_pointer_cast<Cpu>(cpu)),
+        boost::di::bind<Bus>.to(std::static_pointer_cast<Bus>(bus)),
+        boost::di::bind<StaticBusImpl>.to(bus),
+        boost::di::bind<Memory>.to(std::static_pointer_cast<Memory>(memory)),
+        boost::di::bind<MemoryImpl>.to(memoryImpl),
+        boost::di::bind<Graphics>.to(std::static_pointer_cast<Graphics>(graphics)),
+        boost::di::bind<GraphicsImpl>.to(graphics),
+        boost::di::bind<Scheduler, SchedulerImpl>.to<SchedulerImpl>(),
 
         // Graphics
         boost::di::bind<GraphicsService<sf::RenderTexture>>.to<SFMLGraphicsServiceImpl>(),
 
         // Facades
         boost::di::bind<GraphicsFacade<sf::RenderTexture>>.to<SFMLGraphicsFacadeImpl>(),
-        boost::di::bind<InstructionExecutionFacade>.to<InstructionExecutionFacadeImpl>()
+        boost::di::bind<InstructionExecutionFacade>.to<InstructionExecutionFacadeImpl>(),
+        boost::di::bind<SnapshotFacade>.to<SnapshotFacadeImpl>()
     );
 
-    romFacade = injector.create<std::shared_ptr<RomFacadeImpl>>();
+    auto romFacadeImpl = injector.create<std::shared_ptr<RomFacadeImpl>>();
+    romFacadeImpl->setTranslationCache(std::make_shared<TranslationCache>(TRANSLATION_CACHE_DIRECTORY));
+    romFacade = romFacadeImpl;
 
     std::shared_ptr<EmulationSFMLView> emulationView = injector.create<std::shared_ptr<EmulationSFMLView>>();
     viewManager->addView(emulationView);
@@ -48,7 +108,11 @@ void Application::run(int argc, char ** argv)
     if(argc > 1)
         filename = argv[1];
 
+#if CHIP16_MMAP_SUPPORTED
+    bool romLoaded = romFacade->loadRomIntoMemory(std::make_shared<MappedRomInputStream>(filename));
+#else
     bool romLoaded = romFacade->loadRomIntoMemory(std::make_shared<RomFileInputStream>(filename));
+#endif
     if(!romLoaded)
         return;
     
@@ -74,5 +138,6 @@ void Application::run(int argc, char ** argv)
         viewManager->update(elapsedTime);
         viewManager->renderAll();
     }
+    romFacade->saveTranslationCache();
     window.close();
 }
\ No newline at end of file
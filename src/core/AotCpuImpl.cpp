@@ -0,0 +1,141 @@
+#include "AotCpuImpl.hpp"
+#include "MemoryImpl.hpp"
+#include "BusImpl.hpp"
+#include "GraphicsImpl.hpp"
+
+#include "../utils/Crc32.hpp"
+
+Logger AotCpuImpl::LOG(STRINGIFY(AotCpuImpl));
+
+AotCpuImpl::AotCpuImpl(const std::shared_ptr<MemoryType>& memory, const std::shared_ptr<BusType>& bus, const TranslatedProgram& program)
+    : RecompilingCpuBase(memory, bus)
+    , blocks(0x10000, BlockEntry{ nullptr, BlockState::UNVERIFIED })
+    , executingBlock(nullptr)
+    , executingBlockInvalidated(false)
+    , executedInstructions(0)
+{
+    for (auto i = 0u; i < program.blocksCount; i++)
+    {
+        const auto& block = program.blocks[i];
+        blocks[block.startAddress].block = &block;
+        for (u32 page = block.startAddress >> PAGE_SHIFT; page <= ((block.endAddress - 1) >> PAGE_SHIFT); page++)
+            pageBlocks[page].push_back(block.startAddress);
+    }
+    LOG.info("Loaded ", program.blocksCount, " translated blocks");
+}
+
+void AotCpuImpl::step()
+{
+    executeNextBlock();
+}
+
+StopReason AotCpuImpl::run(unsigned maxCycles)
+{
+    startRun();
+    const auto start = cycles;
+    while (cycles - start < maxCycles)
+    {
+        if (cycles != start && isBreakpoint(registers.pc))
+            return StopReason::BREAKPOINT;
+
+        executeNextBlock();
+        if (stopRequested)
+        {
+            if (stopReason == StopReason::IDLE_LOOP)
+                skipIdleLoop(start + maxCycles);
+            return stopReason;
+        }
+    }
+    return StopReason::BUDGET_EXHAUSTED;
+}
+
+void AotCpuImpl::executeNextBlock()
+{
+    auto& entry = blocks[registers.pc];
+    // Translated block cannot stop at breakpoint inside it
+    if (entry.block == nullptr || containsBreakpoint(entry.block->startAddress, entry.block->endAddress)
+        || !verifyBlock(entry))
+    {
+        executeNextInstruction();
+        return;
+    }
+
+    executingBlock = entry.block;
+    executingBlockInvalidated = false;
+    executedInstructions = (entry.block->endAddress - entry.block->startAddress) / 4;
+    entry.block->function(*this);
+    executingBlock = nullptr;
+    cycles += executedInstructions;
+}
+
+void AotCpuImpl::onMemoryWrite(u16 addr, unsigned size)
+{
+    RecompilingCpuBase::onMemoryWrite(addr, size);
+
+    if (size >= 0x10000)
+    {
+        for (auto& entry : blocks)
+            entry.state = BlockState::UNVERIFIED;
+        executingBlockInvalidated = executingBlock != nullptr;
+        return;
+    }
+
+    const u32 end = addr + size;
+    for (u32 page = addr >> PAGE_SHIFT; page <= ((end - 1) >> PAGE_SHIFT); page++)
+    {
+        for (auto start : pageBlocks[page % PAGES_COUNT])
+        {
+            auto& entry = blocks[start];
+            if (entry.block->startAddress < end && addr < entry.block->endAddress)
+            {
+                entry.state = BlockState::UNVERIFIED;
+                if (entry.block == executingBlock)
+                    executingBlockInvalidated = true;
+            }
+        }
+    }
+}
+
+bool AotCpuImpl::interpret(u16 addr, u16 opcode, u16 operand)
+{
+    registers.pc = addr + 4;
+    executeDecodedInstruction(decodeInstruction(opcode, operand));
+    if (!executingBlockInvalidated && !stopRequested)
+        return true;
+
+    // Block left early is charged only for the executed part
+    if (executingBlock != nullptr)
+        executedInstructions = (addr + 4 - executingBlock->startAddress) / 4;
+    return false;
+}
+
+void AotCpuImpl::noteIdleLoop(u16 start, u8 length)
+{
+    // Skipped iterations must not pass over a breakpoint
+    if (!idleLoopDetection || containsBreakpoint(start, start + length * 4u))
+        return;
+    noteIdleLoopJump(start, length);
+}
+
+bool AotCpuImpl::evaluateCondition(unsigned index)
+{
+    return evaluateBranchCondition(index);
+}
+
+bool AotCpuImpl::verifyBlock(BlockEntry& entry)
+{
+    if (entry.state == BlockState::UNVERIFIED)
+    {
+        const auto size = entry.block->endAddress - entry.block->startAddress;
+        // Code is read by reference, so the verification does not hit read watchpoints
+        const auto* code = memory->readByteReference(entry.block->startAddress);
+        // Result of the verification holds until the block is overwritten
+        memory->markCode(entry.block->startAddress, size);
+
+        const bool matches = Crc32::checksum(code, code + size) == entry.block->checksum;
+        entry.state = matches ? BlockState::VERIFIED : BlockState::MISMATCHED;
+        if (!matches)
+            LOG.debug("Code at address ", logHex(entry.block->startAddress), " differs from translated block");
+    }
+    return entry.state == BlockState::VERIFIED;
+}
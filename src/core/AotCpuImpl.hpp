@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "CpuImpl.hpp"
+#include "TranslatedProgram.hpp"
+
+/**
+ * Cpu executing blocks translated ahead of time from the ROM into C++.
+ * Code of each block is verified against its checksum before first execution and after
+ * being overwritten, so blocks not matching memory and addresses never seen by the translator
+ * (e.g. targets of computed jumps) are executed by the interpreter inherited from RecompilingCpuBase.
+ *
+ * Public operations below step() form the interface used by translated code.
+ */
+class AotCpuImpl : public RecompilingCpuBase
+{
+public:
+    AotCpuImpl(const std::shared_ptr<MemoryType>& memory, const std::shared_ptr<BusType>& bus, const TranslatedProgram& program);
+
+    ~AotCpuImpl() = default;
+
+    void step() override;
+
+    StopReason run(unsigned maxCycles) override;
+
+    void onMemoryWrite(u16 addr, unsigned size) override;
+
+    /**
+     * Returns registers without computing pending flags, unlike getRegisters().
+     * Translated code reads flags only through evaluateCondition().
+     *
+     * @return Reference to registers.
+     */
+    CpuRegisters& getRawRegisters();
+
+    /**
+     * Executes single instruction with the interpreter.
+     *
+     * @param addr Address of the instruction.
+     * @param opcode First word of the instruction.
+     * @param operand Second word of the instruction.
+     * @return False if the instruction has overwritten currently executed block or stopped the cpu,
+     *         true otherwise.
+     */
+    bool interpret(u16 addr, u16 opcode, u16 operand);
+
+    /**
+     * Evaluates condition of conditional jump or call.
+     *
+     * @param index Condition index as encoded in the instruction.
+     * @return True if condition is met.
+     */
+    bool evaluateCondition(unsigned index);
+
+    /**
+     * Notes taken or not taken jump closing a loop found idle by the translator, see IdleLoopAnalysis.
+     * With idle loop detection enabled, the jump completing a second whole iteration of the loop stops
+     * the cpu with StopReason::IDLE_LOOP, as in the interpreter.
+     *
+     * @param start Address of the first instruction of the loop.
+     * @param length Number of instructions of the loop.
+     */
+    void noteIdleLoop(u16 start, u8 length);
+
+    /**
+     * Adds operands and updates flags.
+     *
+     * @return 16-bit result of the addition.
+     */
+    u16 add(unsigned operand1, unsigned operand2);
+
+    /**
+     * Subtracts second operand from the first one and updates flags.
+     *
+     * @return 16-bit result of the subtraction.
+     */
+    u16 subtract(unsigned operand1, unsigned operand2);
+
+    /**
+     * Updates zero and negative flags using result of bitwise operation.
+     *
+     * @return Unchanged result.
+     */
+    u16 updateLogicalFlags(u16 result);
+
+private:
+    enum class BlockState : u8
+    {
+        UNVERIFIED,
+        VERIFIED,
+        MISMATCHED
+    };
+
+    struct BlockEntry
+    {
+        const TranslatedBlock* block;
+        BlockState state;
+    };
+
+    void executeNextBlock();
+    bool verifyBlock(BlockEntry& entry);
+
+    static constexpr unsigned PAGE_SHIFT = 8;
+    static constexpr unsigned PAGES_COUNT = 0x10000 >> PAGE_SHIFT;
+
+    std::vector<BlockEntry> blocks;
+    std::array<std::vector<u16>, PAGES_COUNT> pageBlocks;
+    const TranslatedBlock* executingBlock;
+    bool executingBlockInvalidated;
+    unsigned executedInstructions;  // Instructions of executing block up to the one leaving it
+
+    static Logger LOG;
+};
+
+inline CpuRegisters& AotCpuImpl::getRawRegisters()
+{
+    return registers;
+}
+
+inline u16 AotCpuImpl::add(unsigned operand1, unsigned operand2)
+{
+    const unsigned result = operand1 + operand2;
+    setAdditionFlags(operand1, operand2, result);
+    return result & 0xFFFF;
+}
+
+inline u16 AotCpuImpl::subtract(unsigned operand1, unsigned operand2)
+{
+    const unsigned result = operand1 + negate(operand2);
+    setSubtractionFlags(operand1, operand2, result);
+    return result & 0xFFFF;
+}
+
+inline u16 AotCpuImpl::updateLogicalFlags(u16 result)
+{
+    setLogicalFlags(result);
+    return result;
+}
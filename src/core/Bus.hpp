@@ -40,10 +40,10 @@ public:
      *
      * @param x Position x.
      * @param y Position y.
-     * @param start Iterator to first byte containing sprite data.
+     * @param start Pointer to first byte containing sprite data.
      * @return True if any pixel from drawed sprite collides with existing one, otherwise false.
      */
-    virtual bool drawSprite(u16 x, u16 y, std::vector<u8>::const_iterator start) = 0;
+    virtual bool drawSprite(u16 x, u16 y, const u8* start) = 0;
 
     /**
      * Sets HFlip flag.
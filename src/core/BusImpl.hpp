@@ -1,17 +1,26 @@
 #pragma once
 
+#include <memory>
+
 #include "Bus.hpp"
 #include "Graphics.hpp"
 #include "../log/Logger.hpp"
 
-class BusImpl : public Bus
+class GraphicsImpl;
+
+/**
+ * Bus forwarding requests of cpu to graphics of given type.
+ * Instantiated with final graphics implementation the forwarded calls are resolved statically.
+ */
+template <typename GraphicsT>
+class BasicBus final : public Bus
 {
 public:
-    BusImpl() = default;
+    BasicBus() = default;
 
-    BusImpl(const std::shared_ptr<Graphics>& graphics);
+    BasicBus(const std::shared_ptr<GraphicsT>& graphics);
 
-    ~BusImpl() = default;
+    ~BasicBus() = default;
 
     void loadPalette(const Palette& palette) override;
 
@@ -21,7 +30,7 @@ public:
 
     void setSpriteDimensions(u8 width, u8 height) override;
 
-    bool drawSprite(u16 x, u16 y, std::vector<u8>::const_iterator) override;
+    bool drawSprite(u16 x, u16 y, const u8*) override;
 
     void setHFlip(bool flip) override;
 
@@ -32,7 +41,81 @@ public:
     void setVBlank(bool value) const override;
 
 private:
-    std::shared_ptr<Graphics> graphics;
+    std::shared_ptr<GraphicsT> graphics;
 
     static Logger LOG;
-};
\ No newline at end of file
+};
+
+/**
+ * Bus accessing graphics through virtual interface.
+ */
+using BusImpl = BasicBus<Graphics>;
+
+/**
+ * Bus statically bound to graphics implementation used by the emulator.
+ */
+using StaticBusImpl = BasicBus<GraphicsImpl>;
+
+template <typename GraphicsT>
+Logger BasicBus<GraphicsT>::LOG(STRINGIFY(BusImpl));
+
+template <typename GraphicsT>
+inline BasicBus<GraphicsT>::BasicBus(const std::shared_ptr<GraphicsT>& graphics)
+    : graphics(graphics)
+{
+}
+
+template <typename GraphicsT>
+inline void BasicBus<GraphicsT>::loadPalette(const Palette& palette)
+{
+    LOG.debug("Loading palette.");
+    graphics->loadPalette(palette);
+}
+
+template <typename GraphicsT>
+inline void BasicBus<GraphicsT>::clearScreen()
+{
+    graphics->clearScreen();
+}
+
+template <typename GraphicsT>
+inline void BasicBus<GraphicsT>::setBackgroundColorIndex(u8 index)
+{
+    graphics->setBackgroundColorIndex(index);
+}
+
+template <typename GraphicsT>
+inline void BasicBus<GraphicsT>::setSpriteDimensions(u8 width, u8 height)
+{
+    graphics->setSpriteDimensions(width, height);
+}
+
+template <typename GraphicsT>
+inline bool BasicBus<GraphicsT>::drawSprite(u16 x, u16 y, const u8* start)
+{
+    return graphics->drawSprite(x, y, start);
+}
+
+template <typename GraphicsT>
+inline void BasicBus<GraphicsT>::setHFlip(bool flip)
+{
+    graphics->setHFlip(flip);
+}
+
+template <typename GraphicsT>
+inline void BasicBus<GraphicsT>::setVFlip(bool flip)
+{
+    graphics->setVFlip(flip);
+}
+
+template <typename GraphicsT>
+inline bool BasicBus<GraphicsT>::isVBlank() const
+{
+    return graphics->isVBlank();
+}
+
+template <typename GraphicsT>
+inline void BasicBus<GraphicsT>::setVBlank(bool value) const
+{
+    graphics->setVBlank(value);
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Types.hpp"
+
+/**
+ * Range of code decoded or translated by the cpu, persisted between runs of the same program.
+ * Decoded instructions and native code refer to host addresses valid only within one process,
+ * so the range is decoded or translated again when it is imported.
+ */
+struct CachedBlock
+{
+    u16 startAddress;
+    u16 size;       // Number of bytes of code
+    u32 checksum;   // CRC32 of the code, block is imported only while memory contains the same code
+};
@@ -1,11 +1,39 @@
 #pragma once
 
+#include <vector>
+
 #include "Types.hpp"
+#include "CachedBlock.hpp"
+#include "../utils/Random.hpp"
 #include "CpuRegisters.hpp"
+#include "StopReason.hpp"
 
 class Cpu
 {
 public:
+    /**
+     * State of the cpu restored by restoreSnapshot().
+     * Decoded and translated code is not part of the state, it follows content of memory.
+     */
+    struct Snapshot
+    {
+        CpuRegisters registers;
+        std::uint64_t cycles;
+        Random random;
+    };
+
+#if defined(CHIP16_WATCHPOINTS)
+    /**
+     * Access of watched memory range which stopped run() with StopReason::WATCHPOINT.
+     */
+    struct WatchpointHit
+    {
+        u16 pc;     // Address of the instruction which accessed the range
+        u16 addr;   // Address of the first accessed byte
+        bool write;
+    };
+#endif
+
 	virtual ~Cpu() = default;
 
     /**
@@ -36,10 +64,107 @@ public:
      */
 	virtual void executeInstruction(u16 opcode) = 0;
 
+    /**
+     * Fetches, decodes and executes instruction at program counter.
+     * Decoded instructions are cached, so repeated execution skips decoding.
+     * Recompiling implementations execute the whole basic block starting at program counter.
+     */
+    virtual void step() = 0;
+
+    /**
+     * Executes instructions until the cycle budget is exhausted or execution has to be stopped.
+     * Each instruction takes one cycle. Recompiling implementations check the budget between blocks,
+     * so it may be exceeded by the last executed block.
+     * Breakpoint at initial program counter is ignored, which allows to resume stopped execution.
+     *
+     * @param maxCycles Maximal number of cycles to execute.
+     * @return Reason of stopping the execution.
+     */
+    virtual StopReason run(unsigned maxCycles) = 0;
+
+    /**
+     * Sets or clears breakpoint stopping run() before execution of instruction at given address.
+     *
+     * @param addr Address of the instruction.
+     * @param enabled True to set breakpoint, false to clear it.
+     */
+    virtual void setBreakpoint(u16 addr, bool enabled) = 0;
+
+    /**
+     * Returns number of cycles executed since the cpu was created.
+     *
+     * @return Cycle counter.
+     */
+    virtual std::uint64_t getCycles() const = 0;
+
+    /**
+     * Advances cycle counter without executing instructions.
+     * Used to fast-forward time while cpu is idle waiting for an external event.
+     *
+     * @param count Number of cycles to skip.
+     */
+    virtual void skipCycles(std::uint64_t count) = 0;
+
+    /**
+     * Reseeds generator of values returned by RND.
+     * Runs of the same program started with the same seed are reproducible.
+     *
+     * @param seed New seed.
+     */
+    virtual void setRandomSeed(std::uint64_t seed) = 0;
+
+    /**
+     * Returns last seed of generator of values returned by RND.
+     * Unless set explicitly, the seed is chosen non-deterministically when the cpu is created.
+     *
+     * @return Seed.
+     */
+    virtual std::uint64_t getRandomSeed() const = 0;
+
+    /**
+     * Returns code decoded or translated so far, to be imported by a later run of the same program.
+     *
+     * @return Blocks of decoded or translated code.
+     */
+    virtual std::vector<CachedBlock> exportCode() const = 0;
+
+    /**
+     * Decodes or translates given blocks in advance, so their first executions run at full speed.
+     * Blocks whose code differs from the current content of memory are skipped.
+     *
+     * @param blocks Blocks previously returned by exportCode().
+     * @return Number of imported blocks.
+     */
+    virtual unsigned importCode(const std::vector<CachedBlock>& blocks) = 0;
+
+    /**
+     * Captures registers, cycle counter and state of generator of values returned by RND.
+     *
+     * @return Snapshot of the cpu.
+     */
+    virtual Snapshot takeSnapshot() const = 0;
+
+    /**
+     * Restores state captured by takeSnapshot().
+     *
+     * @param snapshot Snapshot of the cpu.
+     */
+    virtual void restoreSnapshot(const Snapshot& snapshot) = 0;
+
     /**
      * Returns struct containing cpu internal registers.
      *
      * @return Cpu registers.
      */
     virtual CpuRegisters& getRegisters() = 0;
+
+#if defined(CHIP16_WATCHPOINTS)
+    /**
+     * Returns the access which stopped the last run() with StopReason::WATCHPOINT.
+     * Watchpoints are set on MemoryImpl, the cpu only stops after the instruction hitting them.
+     *
+     * @return Watchpoint hit.
+     */
+    virtual WatchpointHit getWatchpointHit() const = 0;
+#endif
 };
\ No newline at end of file
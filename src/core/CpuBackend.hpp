@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Types.hpp"
+
+/**
+ * Implementation executing chip16 code, selected at runtime.
+ */
+enum class CpuBackend : u8
+{
+    INTERPRETER,    // Interpreter executing instructions from the decode cache
+    JIT             // Dynamic recompiler translating hot blocks into x86-64 code
+};
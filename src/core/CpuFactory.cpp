@@ -0,0 +1,46 @@
+#include "CpuFactory.hpp"
+#include "JitCpuImpl.hpp"
+#include "MemoryImpl.hpp"
+#include "BusImpl.hpp"
+#include "GraphicsImpl.hpp"
+
+Logger CpuFactory::LOG(STRINGIFY(CpuFactory));
+
+bool CpuFactory::isSupported(CpuBackend backend)
+{
+    switch (backend)
+    {
+    case CpuBackend::INTERPRETER:
+        return true;
+    case CpuBackend::JIT:
+        return CHIP16_JIT_SUPPORTED;
+    }
+    return false;
+}
+
+std::shared_ptr<RecompilingCpuBase> CpuFactory::create(CpuBackend backend,
+    const std::shared_ptr<RecompilingCpuBase::MemoryType>& memory,
+    const std::shared_ptr<RecompilingCpuBase::BusType>& bus)
+{
+    if (!isSupported(backend))
+    {
+        LOG.warn("Cpu backend is not supported on this platform, using interpreter");
+        backend = CpuBackend::INTERPRETER;
+    }
+
+#if CHIP16_JIT_SUPPORTED
+    if (backend == CpuBackend::JIT)
+        return std::make_shared<JitCpuImpl>(memory, bus);
+#endif
+    return std::make_shared<RecompilingCpuBase>(memory, bus);
+}
+
+CpuBackend CpuFactory::parseBackend(const std::string& name, CpuBackend fallback)
+{
+    if (name == "interpreter")
+        return CpuBackend::INTERPRETER;
+    if (name == "jit")
+        return CpuBackend::JIT;
+    LOG.warn("Unknown cpu backend ", name);
+    return fallback;
+}
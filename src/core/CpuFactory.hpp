@@ -0,0 +1,48 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "CpuBackend.hpp"
+#include "CpuImpl.hpp"
+#include "../log/Logger.hpp"
+
+/**
+ * Creates cpu executing code with the backend selected at runtime.
+ * Cpus of all backends extend RecompilingCpuBase, so they are configured the same way.
+ */
+class CpuFactory
+{
+public:
+    /**
+     * Checks whether backend can execute code on this platform.
+     *
+     * @param backend Backend to check.
+     * @return True if backend is supported.
+     */
+    static bool isSupported(CpuBackend backend);
+
+    /**
+     * Creates cpu with given backend, falls back to the interpreter when the backend is not supported.
+     *
+     * @param backend Requested backend.
+     * @param memory Memory accessed by cpu.
+     * @param bus Bus accessed by cpu.
+     * @return Created cpu.
+     */
+    static std::shared_ptr<RecompilingCpuBase> create(CpuBackend backend,
+        const std::shared_ptr<RecompilingCpuBase::MemoryType>& memory,
+        const std::shared_ptr<RecompilingCpuBase::BusType>& bus);
+
+    /**
+     * Parses name of backend, "interpreter" or "jit".
+     *
+     * @param name Name of backend.
+     * @param fallback Backend returned for unknown name.
+     * @return Named backend or fallback.
+     */
+    static CpuBackend parseBackend(const std::string& name, CpuBackend fallback);
+
+private:
+    static Logger LOG;
+};
@@ -14,4 +14,26 @@ union CpuFlags
 		u8 o : 1; // Overflow
 		u8 n : 1; // Negative
 	};
-};
\ No newline at end of file
+};
+
+/**
+ * Kind of operation whose flags have not been written into CpuFlags yet.
+ */
+enum class FlagsOperation : u8
+{
+	NONE,
+	ADDITION,	// Updates carry, zero, overflow and negative
+	SUBTRACTION,	// Updates borrow, zero, overflow and negative
+	LOGICAL		// Updates zero and negative
+};
+
+/**
+ * Operands and result of the last flag-writing operation, kept when flags are evaluated lazily.
+ */
+struct PendingFlags
+{
+	FlagsOperation operation;
+	u16 operand1;
+	u16 operand2;
+	u32 result;
+};
@@ -1,15 +1,145 @@
 #include "CpuImpl.hpp"
+#include "MemoryImpl.hpp"
+#include "BusImpl.hpp"
+#include "GraphicsImpl.hpp"
+#include "../utils/Crc32.hpp"
 
-Logger CpuImpl::LOG(STRINGIFY(CpuImpl));
+template <typename MemoryT, typename BusT>
+Logger BasicCpu<MemoryT, BusT>::LOG(STRINGIFY(CpuImpl));
 
-CpuImpl::CpuImpl(const std::shared_ptr<Memory>& memory, const std::shared_ptr<Bus>& bus)
-    : memory(memory)
+template <typename MemoryT, typename BusT>
+constexpr typename BasicCpu<MemoryT, BusT>::InstructionHandler BasicCpu<MemoryT, BusT>::getOperationHandler(Operation operation)
+{
+    switch (operation)
+    {
+    case Operation::NOP:                              return &BasicCpu::executeNop;
+    case Operation::CLEAR_SCREEN:                     return &BasicCpu::executeClearScreen;
+    case Operation::VBLNK:                            return &BasicCpu::executeVBlnk;
+    case Operation::BACKGROUND_COLOR:                 return &BasicCpu::executeBackgroundColor;
+    case Operation::SPRITE_DIMENSIONS:                return &BasicCpu::executeSpriteDimensions;
+    case Operation::DRAW_SPRITE_IMMEDIATE:            return &BasicCpu::executeDrawSpriteImmediate;
+    case Operation::DRAW_SPRITE_INDIRECT:             return &BasicCpu::executeDrawSpriteIndirect;
+    case Operation::RANDOM:                           return &BasicCpu::executeRandom;
+    case Operation::FLIP:                             return &BasicCpu::executeFlip;
+    case Operation::SOUND_STOP:                       return &BasicCpu::executeSound;
+    case Operation::SOUND_500HZ:                      return &BasicCpu::executeSound;
+    case Operation::SOUND_1000HZ:                     return &BasicCpu::executeSound;
+    case Operation::SOUND_1500HZ:                     return &BasicCpu::executeSound;
+    case Operation::SOUND_TONE:                       return &BasicCpu::executeSound;
+    case Operation::SOUND_GENERATOR:                  return &BasicCpu::executeSound;
+    case Operation::JUMP:                             return &BasicCpu::executeJump;
+    case Operation::JUMP_CARRY:                       return &BasicCpu::executeJumpCarry;
+    case Operation::JUMP_CONDITIONALLY:               return &BasicCpu::executeJumpConditionally;
+    case Operation::JUMP_REGS_EQUAL:                  return &BasicCpu::executeJumpRegsEqual;
+    case Operation::CALL:                             return &BasicCpu::executeCall;
+    case Operation::RETURN:                           return &BasicCpu::executeReturn;
+    case Operation::JUMP_INDIRECT:                    return &BasicCpu::executeJumpIndirect;
+    case Operation::CALL_CONDITIONALLY:               return &BasicCpu::executeCallConditionally;
+    case Operation::CALL_INDIRECT:                    return &BasicCpu::executeCallIndirect;
+    case Operation::LOAD_REGISTER_IMMEDIATE:          return &BasicCpu::executeLoadRegisterImmediate;
+    case Operation::LOAD_SP_IMMEDIATE:                return &BasicCpu::executeLoadSpImmediate;
+    case Operation::LOAD_REGISTER_INDIRECT:           return &BasicCpu::executeLoadRegisterIndirect;
+    case Operation::LOAD_REGISTER_INDEXED:            return &BasicCpu::executeLoadRegisterIndexed;
+    case Operation::MOVE_REGISTER:                    return &BasicCpu::executeMoveRegister;
+    case Operation::STORE_INDIRECT:                   return &BasicCpu::executeStoreIndirect;
+    case Operation::STORE_INDEXED:                    return &BasicCpu::executeStoreIndexed;
+    case Operation::ADD_IMMEDIATE:                    return &BasicCpu::executeAddImmediate;
+    case Operation::ADD_REGISTER:                     return &BasicCpu::executeAddRegister;
+    case Operation::ADD_REGISTERS:                    return &BasicCpu::executeAddRegisters;
+    case Operation::SUBTRACT_IMMEDIATE:               return &BasicCpu::executeSubtractImmediate;
+    case Operation::SUBTRACT_REGISTER:                return &BasicCpu::executeSubtractRegister;
+    case Operation::SUBTRACT_REGISTERS:               return &BasicCpu::executeSubtractRegisters;
+    case Operation::COMPARE_IMMEDIATE:                return &BasicCpu::executeCompareImmediate;
+    case Operation::COMPARE_REGISTER:                 return &BasicCpu::executeCompareRegister;
+    case Operation::BITWISE_AND_IMMEDIATE:            return &BasicCpu::executeBitwiseAndImmediate;
+    case Operation::BITWISE_AND_REGISTER:             return &BasicCpu::executeBitwiseAndRegister;
+    case Operation::BITWISE_AND_REGISTERS:            return &BasicCpu::executeBitwiseAndRegisters;
+    case Operation::BITWISE_TEST_IMMEDIATE:           return &BasicCpu::executeBitwiseTestImmediate;
+    case Operation::BITWISE_TEST_REGISTER:            return &BasicCpu::executeBitwiseTestRegister;
+    case Operation::BITWISE_OR_IMMEDIATE:             return &BasicCpu::executeBitwiseOrImmediate;
+    case Operation::BITWISE_OR_REGISTER:              return &BasicCpu::executeBitwiseOrRegister;
+    case Operation::BITWISE_OR_REGISTERS:             return &BasicCpu::executeBitwiseOrRegisters;
+    case Operation::BITWISE_XOR_IMMEDIATE:            return &BasicCpu::executeBitwiseXorImmediate;
+    case Operation::BITWISE_XOR_REGISTER:             return &BasicCpu::executeBitwiseXorRegister;
+    case Operation::BITWISE_XOR_REGISTERS:            return &BasicCpu::executeBitwiseXorRegisters;
+    case Operation::MULTIPLY_IMMEDIATE:               return &BasicCpu::executeMultiplyImmediate;
+    case Operation::MULTIPLY_REGISTER:                return &BasicCpu::executeMultiplyRegister;
+    case Operation::MULTIPLY_REGISTERS:               return &BasicCpu::executeMultiplyRegisters;
+    case Operation::DIVIDE_IMMEDIATE:                 return &BasicCpu::executeDivideImmediate;
+    case Operation::DIVIDE_REGISTER:                  return &BasicCpu::executeDivideRegister;
+    case Operation::DIVIDE_REGISTERS:                 return &BasicCpu::executeDivideRegisters;
+    case Operation::MODULO_IMMEDIATE:                 return &BasicCpu::executeModuloImmediate;
+    case Operation::MODULO_REGISTER:                  return &BasicCpu::executeModuloRegister;
+    case Operation::MODULO_REGISTERS:                 return &BasicCpu::executeModuloRegisters;
+    case Operation::REMAINDER_IMMEDIATE:              return &BasicCpu::executeRemainderImmediate;
+    case Operation::REMAINDER_REGISTER:               return &BasicCpu::executeRemainderRegister;
+    case Operation::REMAINDER_REGISTERS:              return &BasicCpu::executeRemainderRegisters;
+    case Operation::LOGICAL_SHIFT_LEFT_IMMEDIATE:     return &BasicCpu::executeLogicalShiftLeftImmediate;
+    case Operation::LOGICAL_SHIFT_RIGHT_IMMEDIATE:    return &BasicCpu::executeLogicalShiftRightImmediate;
+    case Operation::ARITHMETIC_SHIFT_RIGHT_IMMEDIATE: return &BasicCpu::executeArithmeticShiftRightImmediate;
+    case Operation::LOGICAL_SHIFT_LEFT_INDIRECT:      return &BasicCpu::executeLogicalShiftLeftIndirect;
+    case Operation::LOGICAL_SHIFT_RIGHT_INDIRECT:     return &BasicCpu::executeLogicalShiftRightIndirect;
+    case Operation::ARITHMETIC_SHIFT_RIGHT_INDIRECT:  return &BasicCpu::executeArithmeticShiftRightIndirect;
+    case Operation::PUSH:                             return &BasicCpu::executePush;
+    case Operation::POP:                              return &BasicCpu::executePop;
+    case Operation::PUSH_ALL:                         return &BasicCpu::executePushAll;
+    case Operation::POP_ALL:                          return &BasicCpu::executePopAll;
+    case Operation::PUSH_FLAGS:                       return &BasicCpu::executePushFlags;
+    case Operation::POP_FLAGS:                        return &BasicCpu::executePopFlags;
+    case Operation::LOAD_PALETTE_ABSOLUTE:            return &BasicCpu::executeLoadPaletteAbsolute;
+    case Operation::LOAD_PALETTE_INDIRECT:            return &BasicCpu::executeLoadPaletteIndirect;
+    case Operation::NOT_IMMEDIATE:                    return &BasicCpu::executeNotImmediate;
+    case Operation::NOT_REGISTER:                     return &BasicCpu::executeNotRegister;
+    case Operation::NOT_REGISTER_INDIRECT:            return &BasicCpu::executeNotRegisterIndirect;
+    case Operation::NEG_IMMEDIATE:                    return &BasicCpu::executeNegImmediate;
+    case Operation::NEG_REGISTER:                     return &BasicCpu::executeNegRegister;
+    case Operation::NEG_REGISTER_INDIRECT:            return &BasicCpu::executeNegRegisterIndirect;
+    case Operation::INVALID:                          return &BasicCpu::executeInvalidInstruction;
+    }
+    return &BasicCpu::executeInvalidInstruction;
+}
+
+template <typename MemoryT, typename BusT>
+template <std::size_t... Opcodes>
+constexpr std::array<typename BasicCpu<MemoryT, BusT>::InstructionHandler, sizeof...(Opcodes)> BasicCpu<MemoryT, BusT>::generateHandlerTable(std::index_sequence<Opcodes...>)
+{
+    return { getOperationHandler(InstructionSet::describe(Opcodes).operation)... };
+}
+
+template <typename MemoryT, typename BusT>
+constexpr std::array<typename BasicCpu<MemoryT, BusT>::InstructionHandler, InstructionSet::OPCODES_COUNT> BasicCpu<MemoryT, BusT>::HANDLERS =
+    generateHandlerTable(std::make_index_sequence<InstructionSet::OPCODES_COUNT>());
+
+template <typename MemoryT, typename BusT>
+constexpr std::array<typename BasicCpu<MemoryT, BusT>::FusionRule, BasicCpu<MemoryT, BusT>::FUSION_RULES_COUNT> BasicCpu<MemoryT, BusT>::FUSION_RULES = {{
+    { "CMPI+Jx",     2, { Operation::COMPARE_IMMEDIATE, Operation::JUMP_CONDITIONALLY },
+        &BasicCpu::executeCompareImmediateJump },
+    { "SUBI+Jx",     2, { Operation::SUBTRACT_IMMEDIATE, Operation::JUMP_CONDITIONALLY },
+        &BasicCpu::executeSubtractImmediateJump },
+    { "LDI+ADD",     2, { Operation::LOAD_REGISTER_IMMEDIATE, Operation::ADD_REGISTER },
+        &BasicCpu::executeLoadImmediateAdd },
+    { "LDM+ADDI+STM", 3, { Operation::LOAD_REGISTER_INDIRECT, Operation::ADD_IMMEDIATE, Operation::STORE_INDIRECT },
+        &BasicCpu::executeLoadAddImmediateStore }
+}};
+
+template <typename MemoryT, typename BusT>
+BasicCpu<MemoryT, BusT>::BasicCpu(const std::shared_ptr<MemoryT>& memory, const std::shared_ptr<BusT>& bus)
+    : registers()
+    , memory(memory)
     , bus(bus)
-    , registers()
 {
+    this->memory->setWriteObserver(this);
+}
+
+template <typename MemoryT, typename BusT>
+BasicCpu<MemoryT, BusT>::~BasicCpu()
+{
+    if (memory)
+        memory->setWriteObserver(nullptr);
 }
 
-u16 CpuImpl::fetchOpcode()
+template <typename MemoryT, typename BusT>
+u16 BasicCpu<MemoryT, BusT>::fetchOpcode()
 {
     LOG.debug("Fetching opcode.");
     u16 opcode = memory->readWord(registers.pc);
@@ -18,885 +148,1458 @@ u16 CpuImpl::fetchOpcode()
     return opcode;
 }
 
-u16 CpuImpl::popFromStack()
+template <typename MemoryT, typename BusT>
+u16 BasicCpu<MemoryT, BusT>::popFromStack()
 {
     LOG.debug("Popping from stack.");
     registers.sp -= 2;
     return memory->readWord(registers.sp);
 }
 
-void CpuImpl::pushIntoStack(u16 value)
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::pushIntoStack(u16 value)
 {
     LOG.debug("Pushing into stack: ", logHex(value));
     memory->writeWord(registers.sp, value);
     registers.sp += 2;
 }
 
-void CpuImpl::executeInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::executeInstruction(u16 opcode)
 {
     LOG.debug("Executing opcode: ", logHex(opcode));
-    const auto group = decodeNibble(opcode, 3);
-    bool result = false;
+    const auto& descriptor = InstructionSet::describe(opcode >> 8);
+    const u16 operand = descriptor.usesOperandWord ? memory->readWord(registers.pc) : 0;
+    // Handlers expect program counter to point past the whole instruction
+    registers.pc += 2;
+    executeFetchedInstruction(opcode + operand * 0x10000u);
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::step()
+{
+    executeNextInstruction();
+}
 
-    if (validateInstructionIndex(opcode))
+template <typename MemoryT, typename BusT>
+StopReason BasicCpu<MemoryT, BusT>::run(unsigned maxCycles)
+{
+    startRun();
+    const auto start = cycles;
+    while (cycles - start < maxCycles)
     {
-        switch (group)
+        if (cycles != start && isBreakpoint(registers.pc))
+            return StopReason::BREAKPOINT;
+
+        executeNextInstruction();
+        if (stopRequested)
         {
-        case 0x0:
-            result = executeMiscInstruction(opcode);
-            break;
-        case 0x1:
-            result = executeJumpInstruction(opcode);
-            break;
-        case 0x2:
-            result = executeLoadInstruction(opcode);
-            break;
-        case 0x3:
-            result = executeStoreInstruction(opcode);
-            break;
-        case 0x4:
-            result = executeAdditionInstruction(opcode);
-            break;
-        case 0x5:
-            result = executeSubtractionInstruction(opcode);
-            break;
-        case 0x6:
-            result = executeBitwiseAndInstruction(opcode);
-            break;
-        case 0x7:
-            result = executeBitwiseOrInstruction(opcode);
-            break;
-        case 0x8:
-            result = executeBitwiseXorInstruction(opcode);
-            break;
-        case 0x9:
-            result = executeMultiplicationInstruction(opcode);
-            break;
-        case 0xA:
-            result = executeDivisionInstruction(opcode);
-            break;
-        case 0xB:
-            result = executeShiftInstruction(opcode);
-            break;
-        case 0xC:
-            result = executeStackInstruction(opcode);
-            break;
-        case 0xD:
-            result = executePaletteInstruction(opcode);
-            break;
-        case 0xE:
-            result = executeNegationInstruction(opcode);
-            break;
+            if (stopReason == StopReason::IDLE_LOOP)
+                skipIdleLoop(start + maxCycles);
+            return stopReason;
         }
     }
+    return StopReason::BUDGET_EXHAUSTED;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setBreakpoint(u16 addr, bool enabled)
+{
+    if (breakpoints[addr] == enabled)
+        return;
 
-    if (!result) 
-        LOG.error("Unknown opcode: ", logHex(opcode));
+    breakpoints[addr] = enabled;
+    if (enabled)
+        breakpointsCount++;
+    else
+        breakpointsCount--;
+    // Fused sequences and compiled blocks must not run over the breakpoint
+    onMemoryWrite(addr, 4);
 }
 
-CpuRegisters& CpuImpl::getRegisters()
+template <typename MemoryT, typename BusT>
+std::uint64_t BasicCpu<MemoryT, BusT>::getCycles() const
 {
-    return registers;
+    return cycles;
 }
 
-bool CpuImpl::validateInstructionIndex(u16 opcode)
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::skipCycles(std::uint64_t count)
 {
-    static const unsigned MAX_INDEXES[] = {
-        0xE, 0x8, 0x4, 0x1,
-        0x2, 0x4, 0x4, 0x2,
-        0x2, 0x2, 0x8, 0x5, 
-        0x5, 0x1, 0x5
-    };
-    return decodeNibble(opcode, 2) <= MAX_INDEXES[decodeNibble(opcode, 3)];
+    cycles += count;
 }
 
-bool CpuImpl::executeMiscInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setRandomSeed(std::uint64_t seed)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
-    
-    if (innerInstructionIndex == 0)
-    {
-        // NOP
+    random.setSeed(seed);
+}
+
+template <typename MemoryT, typename BusT>
+std::uint64_t BasicCpu<MemoryT, BusT>::getRandomSeed() const
+{
+    return random.getSeed();
+}
+
+template <typename MemoryT, typename BusT>
+std::vector<CachedBlock> BasicCpu<MemoryT, BusT>::exportCode() const
+{
+    // Consecutive decoded instructions are merged into one block
+    static constexpr u32 MAX_BLOCK_SIZE = 0x8000;
+
+    std::vector<CachedBlock> blocks;
+    u32 addr = 0;
+    while (addr + 4 <= 0x10000)
+    {
+        u32 end = addr;
+        while (end + 4 <= 0x10000 && end - addr < MAX_BLOCK_SIZE && decodeCache.find(end) != nullptr)
+            end += 4;
+        if (end == addr)
+        {
+            addr++;
+            continue;
+        }
+
+        // Code is read by reference, so it does not hit read watchpoints
+        const auto* code = memory->readByteReference(addr);
+        blocks.push_back(CachedBlock{ static_cast<u16>(addr), static_cast<u16>(end - addr),
+            static_cast<u32>(Crc32::checksum(code, code + (end - addr))) });
+        addr = end;
     }
-    else if (innerInstructionIndex == 1)
+    return blocks;
+}
+
+template <typename MemoryT, typename BusT>
+unsigned BasicCpu<MemoryT, BusT>::importCode(const std::vector<CachedBlock>& blocks)
+{
+    unsigned imported = 0;
+    for (const auto& block : blocks)
     {
-        bus->clearScreen();
+        if (!matchesMemory(block))
+            continue;
+
+        for (u32 addr = block.startAddress; addr < block.startAddress + block.size; addr += 4)
+            if (decodeCache.find(addr) == nullptr)
+                decodeIntoCache(addr);
+        imported++;
     }
-    else if (innerInstructionIndex == 2)
+    return imported;
+}
+
+template <typename MemoryT, typename BusT>
+typename BasicCpu<MemoryT, BusT>::Snapshot BasicCpu<MemoryT, BusT>::takeSnapshot() const
+{
+    // Lazily evaluated flags are captured as pending operation
+    return Snapshot{ registers, cycles, random };
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::restoreSnapshot(const Snapshot& snapshot)
+{
+    registers = snapshot.registers;
+    cycles = snapshot.cycles;
+    random = snapshot.random;
+    idleLoopLength = 0;
+    stopRequested = false;
+}
+
+template <typename MemoryT, typename BusT>
+CpuRegisters& BasicCpu<MemoryT, BusT>::getRegisters()
+{
+    materializeFlags();
+    // Registers may be modified in the middle of idle loop
+    idleLoopLength = 0;
+    return registers;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setLazyFlags(bool enabled)
+{
+    materializeFlags();
+    lazyFlags = enabled;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setDeadFlagsElimination(bool enabled)
+{
+    deadFlagsElimination = enabled;
+    onMemoryWrite(0, 0x10000);
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setDeadFlagsCrossCheck(bool enabled)
+{
+    deadFlagsCrossCheck = enabled;
+    uncheckedDeadFlags = 0;
+    onMemoryWrite(0, 0x10000);
+}
+
+template <typename MemoryT, typename BusT>
+unsigned BasicCpu<MemoryT, BusT>::getDeadFlagsCheckFailures() const
+{
+    return deadFlagsCheckFailures;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setInstructionFusion(bool enabled)
+{
+    instructionFusion = enabled;
+    onMemoryWrite(0, 0x10000);
+}
+
+template <typename MemoryT, typename BusT>
+std::vector<std::pair<const char*, std::uint64_t>> BasicCpu<MemoryT, BusT>::getFusionStatistics() const
+{
+    std::vector<std::pair<const char*, std::uint64_t>> statistics;
+    for (auto rule = 0u; rule < FUSION_RULES.size(); rule++)
+        statistics.emplace_back(FUSION_RULES[rule].name, fusionCounts[rule]);
+    return statistics;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setIdleLoopDetection(bool enabled)
+{
+    idleLoopDetection = enabled;
+    onMemoryWrite(0, 0x10000);
+}
+
+template <typename MemoryT, typename BusT>
+std::vector<std::pair<u16, std::uint64_t>> BasicCpu<MemoryT, BusT>::getIdleLoopStatistics() const
+{
+    return { idleLoopCycles.begin(), idleLoopCycles.end() };
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::onMemoryWrite(u16 addr, unsigned size)
+{
+    // Dead flags and fusion of an instruction depend on instructions decoded after it,
+    // idle loop detected at a jump depends on instructions preceding it
+    const unsigned lookbehind = (getDecodeWindow() - 1) * 4;
+    const unsigned lookahead = idleLoopDetection ? (IdleLoopAnalysis::MAX_LOOP_INSTRUCTIONS - 1) * 4 : 0;
+    decodeCache.invalidate(addr - lookbehind, size + lookbehind + lookahead);
+}
+
+template <typename MemoryT, typename BusT>
+const typename BasicCpu<MemoryT, BusT>::DecodedInstruction& BasicCpu<MemoryT, BusT>::decodeIntoCache(u16 addr)
+{
+    std::vector<DecodedInstruction> instructions;
+    u16 current = addr;
+    do
+    {
+        const auto word = memory->readInstruction(current);
+        LOG.debug("Decoding instruction: ", logHex(word), " at address ", logHex(current));
+        instructions.push_back(decodeInstruction(word));
+        current += 4;
+    } while (instructions.size() < getDecodeWindow()
+        && !InstructionSet::endsBasicBlock(InstructionSet::describe(instructions.back().opcode >> 8).operation));
+
+    memory->markCode(addr, instructions.size() * 4);
+    for (auto i = 0u; i < instructions.size(); i++)
+        detectIdleLoop(addr + i * 4, instructions[i]);
+    eliminateDeadFlags(instructions);
+    fuseInstructions(addr, instructions);
+    return decodeCache.insert(addr, instructions.front());
+}
+
+template <typename MemoryT, typename BusT>
+unsigned BasicCpu<MemoryT, BusT>::getDecodeWindow() const
+{
+    if (deadFlagsElimination)
+        return FLAGS_ANALYSIS_WINDOW;
+    return instructionFusion ? MAX_FUSED_INSTRUCTIONS : 1;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::fuseInstructions(u16 addr, std::vector<DecodedInstruction>& instructions)
+{
+    // Cross-check tracks flags of every executed instruction separately
+    if (!instructionFusion || deadFlagsCrossCheck)
+        return;
+
+    for (auto rule = 0u; rule < FUSION_RULES.size(); rule++)
     {
-        if (!bus->isVBlank())
+        const auto& fusion = FUSION_RULES[rule];
+        if (fusion.length > instructions.size())
+            continue;
+
+        bool matches = true;
+        for (auto i = 0u; i < fusion.length; i++)
         {
-            registers.pc -= 4;
+            const auto& instruction = instructions[i];
+            const auto operation = InstructionSet::describe(instruction.opcode >> 8).operation;
+            // Invalid condition is reported by the handler of the jump itself
+            matches = matches && operation == fusion.operations[i]
+                && !(operation == Operation::JUMP_CONDITIONALLY && instruction.x == 0xF);
         }
-        else
+        if (!matches || containsBreakpoint(addr, addr + fusion.length * 4))
+            continue;
+
+#if defined(CHIP16_WATCHPOINTS)
+        // Watchpoint hit by an instruction before the last one would stop the cpu
+        // only after the whole sequence, so such sequences are not fused
+        bool accessesMemoryEarly = false;
+        for (auto i = 0u; i + 1 < fusion.length; i++)
         {
-            bus->setVBlank(false);
+            const auto operation = fusion.operations[i];
+            accessesMemoryEarly = accessesMemoryEarly || operation == Operation::LOAD_REGISTER_INDIRECT
+                || operation == Operation::LOAD_REGISTER_INDEXED || InstructionSet::writesMemory(operation);
         }
-        
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        const auto COLOR_INDEX = decodeNibble(memory->readWord(registers.pc), 2);
-        bus->setBackgroundColorIndex(COLOR_INDEX);
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        const auto word = memory->readWord(registers.pc);
-        const auto WIDTH = (word >> 8) & 0xFF;
-        const auto HEIGHT = word & 0xFF;
-        bus->setSpriteDimensions(WIDTH, HEIGHT);
-    }
-    else if (innerInstructionIndex == 5)
-    {
-        const auto POS_X = registers.r[decodeNibble(opcode, 0)];
-        const auto POS_Y = registers.r[decodeNibble(opcode, 1)];
-        const auto addr = memory->readWord(registers.pc);
-        registers.flags.c = bus->drawSprite(POS_X, POS_Y, memory->readByteReference(addr));
-    }
-    else if (innerInstructionIndex == 6)
-    {
-        const auto POS_X = registers.r[decodeNibble(opcode, 0)];
-        const auto POS_Y = registers.r[decodeNibble(opcode, 1)];
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        const auto addr = registers.r[REG_INDEX_Z];
-        registers.flags.c = bus->drawSprite(POS_X, POS_Y, memory->readByteReference(addr));
-    }
-    else if (innerInstructionIndex == 7)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto max = memory->readWord(registers.pc);
-        registers.r[REG_INDEX] = Random::get(u16(0), max);
+        if (accessesMemoryEarly)
+            continue;
+#endif
+
+        // Following instructions stay cached for jumps into the middle of the sequence
+        const DecodedInstruction* next = nullptr;
+        for (auto i = fusion.length - 1; i > 0; i--)
+        {
+            instructions[i].next = next;
+            next = &decodeCache.insert(addr + i * 4, instructions[i]);
+        }
+        instructions[0].handler = fusion.handler;
+        instructions[0].fusionRule = rule;
+        instructions[0].length = fusion.length;
+        instructions[0].next = next;
+        LOG.debug("Fusing ", fusion.name, " at address ", logHex(addr));
+        return;
     }
-    else if (innerInstructionIndex == 8)
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::noteIdleLoopJump(u16 start, u8 length)
+{
+    if (registers.pc != start)
     {
-        const auto flipFlags = memory->readWord(registers.pc) & 0x3;
-        bus->setHFlip(flipFlags & 0x2);
-        bus->setVFlip(flipFlags & 0x1);
+        idleLoopLength = 0;
+        return;
     }
-    else if (innerInstructionIndex == 9)
+
+    // Body of the loop does not branch, so taking the jump again means a whole iteration has been executed
+    if (idleLoopStart == start && idleLoopLength == length)
+        requestStop(StopReason::IDLE_LOOP);
+    idleLoopStart = start;
+    idleLoopLength = length;
+}
+
+template <typename MemoryT, typename BusT>
+typename BasicCpu<MemoryT, BusT>::DecodedInstruction BasicCpu<MemoryT, BusT>::decodeInstruction(u32 word)
+{
+    return decodeInstruction(word & 0xFFFF, word >> 16);
+}
+
+template <typename MemoryT, typename BusT>
+typename BasicCpu<MemoryT, BusT>::DecodedInstruction BasicCpu<MemoryT, BusT>::decodeInstruction(u16 opcode, u16 operand)
+{
+    DecodedInstruction instruction;
+    instruction.handler = HANDLERS[opcode >> 8];
+    instruction.opcode = opcode;
+    instruction.x = decodeNibble(opcode, 0);
+    instruction.y = decodeNibble(opcode, 1);
+    instruction.z = decodeNibble(operand, 2);
+    instruction.immediate = operand;
+    instruction.deadFlags = 0;
+    instruction.evaluateFlags = true;
+    instruction.fusionRule = 0;
+    instruction.length = 1;
+    instruction.idleLoopLength = 0;
+    instruction.next = nullptr;
+    return instruction;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::executeDecodedInstruction(const DecodedInstruction& instruction)
+{
+    if (deadFlagsCrossCheck)
+        checkDeadFlags(instruction);
+    if (!(this->*instruction.handler)(instruction))
     {
-        // TODO: Implement instruction
+        LOG.error("Unknown opcode: ", logHex(instruction.opcode));
+        requestStop(StopReason::INVALID_OPCODE);
     }
-    else if (innerInstructionIndex == 9)
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::executeFetchedInstruction(u32 word)
+{
+    // Instruction executed out of order may interrupt iteration of idle loop
+    idleLoopLength = 0;
+    executeDecodedInstruction(decodeInstruction(word));
+}
+
+template <typename MemoryT, typename BusT>
+const typename BasicCpu<MemoryT, BusT>::DecodedInstruction& BasicCpu<MemoryT, BusT>::executeNextInstruction()
+{
+    const auto* instruction = decodeCache.find(registers.pc);
+    if (instruction == nullptr)
+        instruction = &decodeIntoCache(registers.pc);
+    registers.pc += instruction->length * 4;
+    cycles += instruction->length;
+    executeDecodedInstruction(*instruction);
+    return *instruction;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::startRun()
+{
+    stopRequested = false;
+    // Memory polled by idle loop is written only by the host between runs,
+    // writes into data pages are not reported to the cpu
+    idleLoopLength = 0;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::matchesMemory(const CachedBlock& block) const
+{
+    if (block.size == 0 || block.size % 4 != 0 || block.startAddress + block.size > 0x10000)
+        return false;
+
+    const auto* code = memory->readByteReference(block.startAddress);
+    return Crc32::checksum(code, code + block.size) == block.checksum;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::requestStop(StopReason reason)
+{
+    stopRequested = true;
+    stopReason = reason;
+}
+
+#if defined(CHIP16_WATCHPOINTS)
+template <typename MemoryT, typename BusT>
+Cpu::WatchpointHit BasicCpu<MemoryT, BusT>::getWatchpointHit() const
+{
+    return watchpointHit;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::onWatchpointHit(u16 addr, bool write)
+{
+    // Further accesses of the stopping instruction do not replace the first hit
+    if (stopRequested && stopReason == StopReason::WATCHPOINT)
+        return;
+
+    // Handlers access memory with program counter pointing past the instruction
+    watchpointHit = WatchpointHit{ static_cast<u16>(registers.pc - 4), addr, write };
+    requestStop(StopReason::WATCHPOINT);
+}
+#endif
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isBreakpoint(u16 addr) const
+{
+    return breakpointsCount != 0 && breakpoints[addr];
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::containsBreakpoint(u16 start, u32 end) const
+{
+    if (breakpointsCount == 0)
+        return false;
+
+    // Breakpoint at the first instruction does not prevent its execution
+    for (u32 addr = start + 1; addr < end; addr++)
     {
-        // TODO: Implement instruction
+        if (breakpoints[addr & 0xFFFF])
+            return true;
     }
-    else if (innerInstructionIndex == 0xA)
+    return false;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::detectIdleLoop(u16 addr, DecodedInstruction& instruction)
+{
+    const u16 start = instruction.immediate;
+    if (!idleLoopDetection || start > addr || (addr - start) % 4 != 0
+        || static_cast<unsigned>(addr - start) / 4 >= IdleLoopAnalysis::MAX_LOOP_INSTRUCTIONS)
+        return;
+
+    // Skipped iterations must not pass over a breakpoint
+    if (isBreakpoint(start) || containsBreakpoint(start, addr + 4u))
+        return;
+
+    std::vector<std::pair<u16, u16>> loop;
+    for (u16 current = start; current != addr; current += 4)
     {
-        // TODO: Implement instruction
+        const auto word = memory->readInstruction(current);
+        loop.emplace_back(word & 0xFFFF, word >> 16);
     }
-    else if (innerInstructionIndex == 0xB)
+    loop.emplace_back(instruction.opcode, instruction.immediate);
+    if (IdleLoopAnalysis::isIdleLoop(loop))
     {
-        // TODO: Implement instruction
+        memory->markCode(start, loop.size() * 4);
+        instruction.idleLoopLength = loop.size();
     }
-    else if (innerInstructionIndex == 0xC)
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::skipIdleLoop(std::uint64_t limit)
+{
+    if (idleLoopLength == 0 || cycles >= limit)
+        return;
+
+    // Whole iterations keep program counter at the start of the loop, so skipping them is exact
+    const auto skipped = (limit - cycles) / idleLoopLength * idleLoopLength;
+    cycles += skipped;
+    if (idleLoopCycles.find(idleLoopStart) == idleLoopCycles.end())
+        LOG.info("Idle loop detected at address ", logHex(idleLoopStart));
+    idleLoopCycles[idleLoopStart] += skipped;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::eliminateDeadFlags(std::vector<DecodedInstruction>& instructions)
+{
+    if (!deadFlagsElimination)
+        return;
+
+    std::vector<Operation> operations;
+    for (const auto& instruction : instructions)
+        operations.push_back(InstructionSet::describe(instruction.opcode >> 8).operation);
+
+    const auto deadFlags = FlagsLiveness::findDeadFlags(operations);
+    for (auto i = 0u; i < instructions.size(); i++)
     {
-        // TODO: Implement instruction
+        const auto written = InstructionSet::flagsWritten(operations[i]);
+        instructions[i].deadFlags = deadFlags[i];
+        instructions[i].evaluateFlags = deadFlagsCrossCheck || written == 0 || deadFlags[i] != written;
     }
-    else if (innerInstructionIndex == 0xD)
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::checkDeadFlags(const DecodedInstruction& instruction)
+{
+    const auto operation = InstructionSet::describe(instruction.opcode >> 8).operation;
+    const auto read = InstructionSet::flagsRead(operation) & uncheckedDeadFlags;
+    if (read != 0)
     {
-        // TODO: Implement instruction
+        LOG.error("Instruction ", logHex(instruction.opcode), " reads flags ", logHex(read), " considered dead");
+        deadFlagsCheckFailures++;
     }
-    else if (innerInstructionIndex == 0xE)
+
+    uncheckedDeadFlags &= ~InstructionSet::flagsWritten(operation);
+    uncheckedDeadFlags |= instruction.deadFlags;
+    if (InstructionSet::endsBasicBlock(operation) && uncheckedDeadFlags != 0)
     {
-        // TODO: Implement instruction
+        LOG.error("Flags ", logHex(uncheckedDeadFlags), " considered dead leave basic block");
+        deadFlagsCheckFailures++;
+        uncheckedDeadFlags = 0;
     }
-    registers.pc += 2;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeInvalidInstruction(const DecodedInstruction&)
+{
+    return false;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeNop(const DecodedInstruction&)
+{
     return true;
 }
 
-bool CpuImpl::executeJumpInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeClearScreen(const DecodedInstruction&)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    bus->clearScreen();
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        registers.pc = memory->readWord(registers.pc);
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        registers.pc = registers.flags.c == 1 ? memory->readWord(registers.pc) : registers.pc + 2;
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        if (decodeNibble(opcode, 0) == 0xF) 
-        {
-            registers.pc += 2;
-            return false;
-        }
-        registers.pc = evaluateBranchCondition(decodeNibble(opcode, 0)) ?
-            memory->readWord(registers.pc) : registers.pc + 2;
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        registers.pc = registers.r[decodeNibble(opcode, 0)] == registers.r[decodeNibble(opcode, 1)] ?
-            memory->readWord(registers.pc) : registers.pc + 2;
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        auto addr = memory->readWord(registers.pc);
-        pushIntoStack(registers.pc + 2);
-        registers.pc = addr;
-    }
-    else if (innerInstructionIndex == 5)
-    {
-        registers.pc = popFromStack();
-    }
-    else if (innerInstructionIndex == 6)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeVBlnk(const DecodedInstruction&)
+{
+    if (!bus->isVBlank())
     {
-        registers.pc = registers.r[decodeNibble(opcode, 0)];
+        registers.pc -= 4;
+        requestStop(StopReason::VBLANK);
     }
-    else if (innerInstructionIndex == 7)
-    {
-        if (decodeNibble(opcode, 0) == 0xF)
-        {
-            registers.pc += 2;
-            return false;
-        }
-        auto addr = memory->readWord(registers.pc);
-        bool condition = evaluateBranchCondition(decodeNibble(opcode, 0));
-        if(condition)
-            pushIntoStack(registers.pc + 2);
-        registers.pc = condition ? addr : registers.pc + 2;
-    }
-    else if (innerInstructionIndex == 8)
+    else
     {
-        auto addr = registers.r[decodeNibble(opcode, 0)];
-        pushIntoStack(registers.pc + 2);
-        registers.pc = addr;
+        bus->setVBlank(false);
     }
     return true;
 }
 
-bool CpuImpl::executeLoadInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBackgroundColor(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto COLOR_INDEX = instruction.z;
+    bus->setBackgroundColorIndex(COLOR_INDEX);
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto word = memory->readWord(registers.pc);
-        registers.r[REG_INDEX] = word;
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto word = memory->readWord(registers.pc);
-        registers.sp = word;
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto addr = memory->readWord(registers.pc);
-        const auto word = memory->readWord(addr);
-        registers.r[REG_INDEX] = word;
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto addr = registers.r[REG_INDEX_Y];
-        const auto word = memory->readWord(addr);
-        registers.r[REG_INDEX_X] = word;
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        registers.r[REG_INDEX_X] = registers.r[REG_INDEX_Y];
-    }
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeSpriteDimensions(const DecodedInstruction& instruction)
+{
+    const auto word = instruction.immediate;
+    const auto WIDTH = (word >> 8) & 0xFF;
+    const auto HEIGHT = word & 0xFF;
+    bus->setSpriteDimensions(WIDTH, HEIGHT);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeDrawSpriteImmediate(const DecodedInstruction& instruction)
+{
+    const auto POS_X = registers.r[instruction.x];
+    const auto POS_Y = registers.r[instruction.y];
+    const auto addr = instruction.immediate;
+    materializeFlags();
+    registers.flags.c = bus->drawSprite(POS_X, POS_Y, memory->readByteReference(addr));
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeDrawSpriteIndirect(const DecodedInstruction& instruction)
+{
+    const auto POS_X = registers.r[instruction.x];
+    const auto POS_Y = registers.r[instruction.y];
+    const auto REG_INDEX_Z = instruction.z;
+    const auto addr = registers.r[REG_INDEX_Z];
+    materializeFlags();
+    registers.flags.c = bus->drawSprite(POS_X, POS_Y, memory->readByteReference(addr));
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeRandom(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto max = instruction.immediate;
+    registers.r[REG_INDEX] = random.get(u16(0), max);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeFlip(const DecodedInstruction& instruction)
+{
+    const auto flipFlags = instruction.immediate & 0x3;
+    bus->setHFlip(flipFlags & 0x2);
+    bus->setVFlip(flipFlags & 0x1);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeSound(const DecodedInstruction&)
+{
+    // TODO: Implement instruction
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeJump(const DecodedInstruction& instruction)
+{
+    registers.pc = instruction.immediate;
+    if (instruction.idleLoopLength != 0)
+        noteIdleLoopJump(instruction.immediate, instruction.idleLoopLength);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeJumpCarry(const DecodedInstruction& instruction)
+{
+    materializeFlags();
+    if (registers.flags.c == 1)
+        registers.pc = instruction.immediate;
+    if (instruction.idleLoopLength != 0)
+        noteIdleLoopJump(instruction.immediate, instruction.idleLoopLength);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeJumpConditionally(const DecodedInstruction& instruction)
+{
+    if (instruction.x == 0xF) 
+        return false;
+    if (evaluateBranchCondition(instruction.x))
+        registers.pc = instruction.immediate;
+    if (instruction.idleLoopLength != 0)
+        noteIdleLoopJump(instruction.immediate, instruction.idleLoopLength);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeJumpRegsEqual(const DecodedInstruction& instruction)
+{
+    if (registers.r[instruction.x] == registers.r[instruction.y])
+        registers.pc = instruction.immediate;
+    if (instruction.idleLoopLength != 0)
+        noteIdleLoopJump(instruction.immediate, instruction.idleLoopLength);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeCall(const DecodedInstruction& instruction)
+{
+    auto addr = instruction.immediate;
+    pushIntoStack(registers.pc);
+    registers.pc = addr;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeReturn(const DecodedInstruction&)
+{
+    registers.pc = popFromStack();
     return true;
 }
 
-bool CpuImpl::executeStoreInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeJumpIndirect(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    registers.pc = registers.r[instruction.x];
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeCallConditionally(const DecodedInstruction& instruction)
+{
+    if (instruction.x == 0xF)
+        return false;
+    if (evaluateBranchCondition(instruction.x))
     {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto addr = memory->readWord(registers.pc);
-        memory->writeWord(addr, registers.r[REG_INDEX]);
+        pushIntoStack(registers.pc);
+        registers.pc = instruction.immediate;
     }
-    else if (innerInstructionIndex == 1)
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeCallIndirect(const DecodedInstruction& instruction)
+{
+    auto addr = registers.r[instruction.x];
+    pushIntoStack(registers.pc);
+    registers.pc = addr;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLoadRegisterImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto word = instruction.immediate;
+    registers.r[REG_INDEX] = word;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLoadSpImmediate(const DecodedInstruction& instruction)
+{
+    const auto word = instruction.immediate;
+    registers.sp = word;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLoadRegisterIndirect(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto addr = instruction.immediate;
+    const auto word = memory->readWord(addr);
+    registers.r[REG_INDEX] = word;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLoadRegisterIndexed(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto addr = registers.r[REG_INDEX_Y];
+    const auto word = memory->readWord(addr);
+    registers.r[REG_INDEX_X] = word;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeMoveRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    registers.r[REG_INDEX_X] = registers.r[REG_INDEX_Y];
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeStoreIndirect(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto addr = instruction.immediate;
+    memory->writeWord(addr, registers.r[REG_INDEX]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeStoreIndexed(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto addr = registers.r[REG_INDEX_Y];
+    memory->writeWord(addr, registers.r[REG_INDEX_X]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeAddImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const unsigned operand1 = instruction.immediate;
+    const unsigned operand2 = registers.r[REG_INDEX];
+    const unsigned result = operand1 + operand2;
+    if (instruction.evaluateFlags)
+        setAdditionFlags(operand1, operand2, result);
+    registers.r[REG_INDEX] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeAddRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const unsigned operand1 = registers.r[REG_INDEX_X];
+    const unsigned operand2 = registers.r[REG_INDEX_Y];
+    const unsigned result = operand1 + operand2;
+    if (instruction.evaluateFlags)
+        setAdditionFlags(operand1, operand2, result);
+    registers.r[REG_INDEX_X] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeAddRegisters(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    const unsigned operand1 = registers.r[REG_INDEX_X];
+    const unsigned operand2 = registers.r[REG_INDEX_Y];
+    const unsigned result = operand1 + operand2;
+    if (instruction.evaluateFlags)
+        setAdditionFlags(operand1, operand2, result);
+    registers.r[REG_INDEX_Z] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeSubtractImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const unsigned operand1 = registers.r[REG_INDEX];
+    const unsigned operand2 = instruction.immediate;
+    const unsigned result = operand1 + negate(operand2);
+    if (instruction.evaluateFlags)
+        setSubtractionFlags(operand1, operand2, result);
+    registers.r[REG_INDEX] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeSubtractRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const unsigned operand1 = registers.r[REG_INDEX_X];
+    const unsigned operand2 = registers.r[REG_INDEX_Y];
+    const unsigned result = operand1 + negate(operand2);
+    if (instruction.evaluateFlags)
+        setSubtractionFlags(operand1, operand2, result);
+    registers.r[REG_INDEX_X] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeSubtractRegisters(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    const unsigned operand1 = registers.r[REG_INDEX_X];
+    const unsigned operand2 = registers.r[REG_INDEX_Y];
+    const unsigned result = operand1 + negate(operand2);
+    if (instruction.evaluateFlags)
+        setSubtractionFlags(operand1, operand2, result);
+    registers.r[REG_INDEX_Z] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeCompareImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const unsigned operand1 = registers.r[REG_INDEX];
+    const unsigned operand2 = instruction.immediate;
+    const unsigned result = operand1 + negate(operand2);
+    if (instruction.evaluateFlags)
+        setSubtractionFlags(operand1, operand2, result);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeCompareRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const unsigned operand1 = registers.r[REG_INDEX_X];
+    const unsigned operand2 = registers.r[REG_INDEX_Y];
+    const unsigned result = operand1 + negate(operand2);
+    if (instruction.evaluateFlags)
+        setSubtractionFlags(operand1, operand2, result);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseAndImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto word = instruction.immediate;
+    registers.r[REG_INDEX] &= word;
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseAndRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    registers.r[REG_INDEX_X] &= registers.r[REG_INDEX_Y];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_X]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseAndRegisters(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    registers.r[REG_INDEX_Z] = registers.r[REG_INDEX_X] & registers.r[REG_INDEX_Y];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_Z]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseTestImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto word = instruction.immediate;
+    const u16 result = registers.r[REG_INDEX] & word;
+    if (instruction.evaluateFlags)
+        setLogicalFlags(result);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseTestRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const u16 result = registers.r[REG_INDEX_X] & registers.r[REG_INDEX_Y];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(result);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseOrImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto word = instruction.immediate;
+    registers.r[REG_INDEX] |= word;
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseOrRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    registers.r[REG_INDEX_X] |= registers.r[REG_INDEX_Y];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_X]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseOrRegisters(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    registers.r[REG_INDEX_Z] = registers.r[REG_INDEX_X] | registers.r[REG_INDEX_Y];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_Z]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseXorImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto word = instruction.immediate;
+    registers.r[REG_INDEX] ^= word;
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseXorRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    registers.r[REG_INDEX_X] ^= registers.r[REG_INDEX_Y];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_X]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeBitwiseXorRegisters(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    registers.r[REG_INDEX_Z] = registers.r[REG_INDEX_X] ^ registers.r[REG_INDEX_Y];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_Z]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeMultiplyImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto operand1 = registers.r[REG_INDEX];
+    const auto operand2 = instruction.immediate;
+    const unsigned result = operand1 * operand2;
+    if (instruction.evaluateFlags)
     {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto addr = registers.r[REG_INDEX_Y];
-        memory->writeWord(addr, registers.r[REG_INDEX_X]);
+        materializeFlags();
+        registers.flags.c = isMultiplicationCarry(result);
+        registers.flags.n = isNegative(result);
+        registers.flags.z = isZero(result);
     }
-    registers.pc += 2;
+    registers.r[REG_INDEX] = result & 0xFFFF;
     return true;
 }
 
-bool CpuImpl::executeAdditionInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeMultiplyRegister(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto operand1 = registers.r[REG_INDEX_X];
+    const auto operand2 = registers.r[REG_INDEX_Y];
+    const unsigned result = operand1 * operand2;
+    if (instruction.evaluateFlags)
+    {
+        materializeFlags();
+        registers.flags.c = isMultiplicationCarry(result);
+        registers.flags.n = isNegative(result);
+        registers.flags.z = isZero(result);
+    }
+    registers.r[REG_INDEX_X] = result & 0xFFFF;
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const unsigned operand1 = memory->readWord(registers.pc);
-        const unsigned operand2 = registers.r[REG_INDEX];
-        const unsigned result = operand1 + operand2;
-        registers.flags.c = isAdditionCarry(result);
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeMultiplyRegisters(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    const auto operand1 = registers.r[REG_INDEX_X];
+    const auto operand2 = registers.r[REG_INDEX_Y];
+    const unsigned result = operand1 * operand2;
+    if (instruction.evaluateFlags)
+    {
+        materializeFlags();
+        registers.flags.c = isMultiplicationCarry(result);
         registers.flags.n = isNegative(result);
         registers.flags.z = isZero(result);
-        registers.flags.o = isAdditionOverflow(operand1, operand2, result);
-        registers.r[REG_INDEX] = result & 0xFFFF;
     }
-    else if (innerInstructionIndex == 1)
+    registers.r[REG_INDEX_Z] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeDivideImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX]);
+    const auto operand2 = static_cast<s16>(instruction.immediate);
+    const unsigned result = static_cast<u32>(operand1 / operand2);
+    if (instruction.evaluateFlags)
     {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const unsigned operand1 = registers.r[REG_INDEX_X];
-        const unsigned operand2 = registers.r[REG_INDEX_Y];
-        const unsigned result = operand1 + operand2;
-        registers.flags.c = isAdditionCarry(result);
+        materializeFlags();
+        registers.flags.c = isDivisionCarry(operand1, operand2);
+        registers.flags.z = isZero(result);
         registers.flags.n = isNegative(result);
+    }
+    registers.r[REG_INDEX] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeDivideRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
+    const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
+    const unsigned result = static_cast<u32>(operand1 / operand2);
+    if (instruction.evaluateFlags)
+    {
+        materializeFlags();
+        registers.flags.c = isDivisionCarry(operand1, operand2);
         registers.flags.z = isZero(result);
-        registers.flags.o = isAdditionOverflow(operand1, operand2, result);
-        registers.r[REG_INDEX_X] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        const unsigned operand1 = registers.r[REG_INDEX_X];
-        const unsigned operand2 = registers.r[REG_INDEX_Y];
-        const unsigned result = operand1 + operand2;
-        registers.flags.c = isAdditionCarry(result);
         registers.flags.n = isNegative(result);
+    }
+    registers.r[REG_INDEX_X] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeDivideRegisters(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
+    const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
+    const unsigned result = static_cast<u32>(operand1 / operand2);
+    if (instruction.evaluateFlags)
+    {
+        materializeFlags();
+        registers.flags.c = isDivisionCarry(operand1, operand2);
         registers.flags.z = isZero(result);
-        registers.flags.o = isAdditionOverflow(operand1, operand2, result);
-        registers.r[REG_INDEX_Z] = result & 0xFFFF;
+        registers.flags.n = isNegative(result);
     }
-    registers.pc += 2;
+    registers.r[REG_INDEX_Z] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeModuloImmediate(const DecodedInstruction& instruction)
+{
+    auto mod = [](const auto operand1, const auto operand2) {
+        return ((operand1 % operand2) + operand2) % operand2;
+    };
+    const auto REG_INDEX = instruction.x;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX]);
+    const auto operand2 = static_cast<s16>(instruction.immediate);
+    const unsigned result = static_cast<u32>(mod(operand1, operand2));
+    if (instruction.evaluateFlags)
+        setLogicalFlags(result);
+    registers.r[REG_INDEX] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeModuloRegister(const DecodedInstruction& instruction)
+{
+    auto mod = [](const auto operand1, const auto operand2) {
+        return ((operand1 % operand2) + operand2) % operand2;
+    };
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
+    const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
+    const unsigned result = static_cast<u32>(mod(operand1, operand2));
+    if (instruction.evaluateFlags)
+        setLogicalFlags(result);
+    registers.r[REG_INDEX_X] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeModuloRegisters(const DecodedInstruction& instruction)
+{
+    auto mod = [](const auto operand1, const auto operand2) {
+        return ((operand1 % operand2) + operand2) % operand2;
+    };
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
+    const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
+    const unsigned result = static_cast<u32>(mod(operand1, operand2));
+    if (instruction.evaluateFlags)
+        setLogicalFlags(result);
+    registers.r[REG_INDEX_Z] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeRemainderImmediate(const DecodedInstruction& instruction)
+{
+    auto rem = [](const auto operand1, const auto operand2) {
+        return operand1 % operand2;
+    };
+    const auto REG_INDEX = instruction.x;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX]);
+    const auto operand2 = static_cast<s16>(instruction.immediate);
+    const unsigned result = static_cast<u32>(rem(operand1, operand2));
+    if (instruction.evaluateFlags)
+        setLogicalFlags(result);
+    registers.r[REG_INDEX] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeRemainderRegister(const DecodedInstruction& instruction)
+{
+    auto rem = [](const auto operand1, const auto operand2) {
+        return operand1 % operand2;
+    };
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
+    const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
+    const unsigned result = static_cast<u32>(rem(operand1, operand2));
+    if (instruction.evaluateFlags)
+        setLogicalFlags(result);
+    registers.r[REG_INDEX_X] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeRemainderRegisters(const DecodedInstruction& instruction)
+{
+    auto rem = [](const auto operand1, const auto operand2) {
+        return operand1 % operand2;
+    };
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto REG_INDEX_Z = instruction.z;
+    const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
+    const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
+    const unsigned result = static_cast<u32>(rem(operand1, operand2));
+    if (instruction.evaluateFlags)
+        setLogicalFlags(result);
+    registers.r[REG_INDEX_Z] = result & 0xFFFF;
     return true;
 }
 
-bool CpuImpl::executeSubtractionInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLogicalShiftLeftImmediate(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
-
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const unsigned operand1 = registers.r[REG_INDEX];
-        const unsigned operand2 = memory->readWord(registers.pc);
-        const unsigned result = operand1 + negate(operand2);
-        registers.flags.c = isSubtractionBorrow(result);
-        registers.flags.n = isNegative(result);
-        registers.flags.z = isZero(result);
-        registers.flags.o = isSubtractionOverflow(operand1, operand2, result);
-        registers.r[REG_INDEX] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const unsigned operand1 = registers.r[REG_INDEX_X];
-        const unsigned operand2 = registers.r[REG_INDEX_Y];
-        const unsigned result = operand1 + negate(operand2);
-        registers.flags.c = isSubtractionBorrow(result);
-        registers.flags.n = isNegative(result);
-        registers.flags.z = isZero(result);
-        registers.flags.o = isSubtractionOverflow(operand1, operand2, result);
-        registers.r[REG_INDEX_X] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        const unsigned operand1 = registers.r[REG_INDEX_X];
-        const unsigned operand2 = registers.r[REG_INDEX_Y];
-        const unsigned result = operand1 + negate(operand2);
-        registers.flags.c = isSubtractionBorrow(result);
-        registers.flags.n = isNegative(result);
-        registers.flags.z = isZero(result);
-        registers.flags.o = isSubtractionOverflow(operand1, operand2, result);
-        registers.r[REG_INDEX_Z] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const unsigned operand1 = registers.r[REG_INDEX];
-        const unsigned operand2 = memory->readWord(registers.pc);
-        const unsigned result = operand1 + negate(operand2);
-        registers.flags.c = isSubtractionBorrow(result);
-        registers.flags.n = isNegative(result);
-        registers.flags.z = isZero(result);
-        registers.flags.o = isSubtractionOverflow(operand1, operand2, result);
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const unsigned operand1 = registers.r[REG_INDEX_X];
-        const unsigned operand2 = registers.r[REG_INDEX_Y];
-        const unsigned result = operand1 + negate(operand2);
-        registers.flags.c = isSubtractionBorrow(result);
-        registers.flags.n = isNegative(result);
-        registers.flags.z = isZero(result);
-        registers.flags.o = isSubtractionOverflow(operand1, operand2, result);
-    }
-    registers.pc += 2;
+    const auto REG_INDEX = instruction.x;
+    const auto operand = instruction.z;
+    registers.r[REG_INDEX] <<= operand;
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
     return true;
 }
 
-bool CpuImpl::executeBitwiseAndInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLogicalShiftRightImmediate(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto REG_INDEX = instruction.x;
+    const auto operand = instruction.z;
+    registers.r[REG_INDEX] >>= operand;
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto word = memory->readWord(registers.pc);
-        registers.r[REG_INDEX] &= word;
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        registers.r[REG_INDEX_X] &= registers.r[REG_INDEX_Y];
-        registers.flags.z = isZero(registers.r[REG_INDEX_X]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX_X]);
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        registers.r[REG_INDEX_Z] = registers.r[REG_INDEX_X] & registers.r[REG_INDEX_Y];
-        registers.flags.z = isZero(registers.r[REG_INDEX_Z]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX_Z]);
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto word = memory->readWord(registers.pc);
-        const u16 result = registers.r[REG_INDEX] & word;
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const u16 result = registers.r[REG_INDEX_X] & registers.r[REG_INDEX_Y];
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-    }
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeArithmeticShiftRightImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    const auto operand = instruction.z;
+    bool msb = registers.r[REG_INDEX] & 0x8000;
+    registers.r[REG_INDEX] = (registers.r[REG_INDEX] >> operand) | (msb << 15);
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
     return true;
 }
 
-bool CpuImpl::executeBitwiseOrInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLogicalShiftLeftIndirect(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto operand = registers.r[REG_INDEX_Y];
+    registers.r[REG_INDEX_X] <<= operand;
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_X]);
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto word = memory->readWord(registers.pc);
-        registers.r[REG_INDEX] |= word;
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        registers.r[REG_INDEX_X] |= registers.r[REG_INDEX_Y];
-        registers.flags.n = isNegative(registers.r[REG_INDEX_X]);
-        registers.flags.z = isZero(registers.r[REG_INDEX_X]);
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        registers.r[REG_INDEX_Z] = registers.r[REG_INDEX_X] | registers.r[REG_INDEX_Y];
-        registers.flags.n = isNegative(registers.r[REG_INDEX_Z]);
-        registers.flags.z = isZero(registers.r[REG_INDEX_Z]);
-    }
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLogicalShiftRightIndirect(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    const auto operand = registers.r[REG_INDEX_Y];
+    registers.r[REG_INDEX_X] >>= operand;
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_X]);
     return true;
 }
 
-bool CpuImpl::executeBitwiseXorInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeArithmeticShiftRightIndirect(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    bool msb = registers.r[REG_INDEX_X] & 0x8000;
+    const auto operand = registers.r[REG_INDEX_Y];
+    registers.r[REG_INDEX_X] = (registers.r[REG_INDEX_X] >> operand) | (msb << 15);
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_X]);
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto word = memory->readWord(registers.pc);
-        registers.r[REG_INDEX] ^= word;
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        registers.r[REG_INDEX_X] ^= registers.r[REG_INDEX_Y];
-        registers.flags.n = isNegative(registers.r[REG_INDEX_X]);
-        registers.flags.z = isZero(registers.r[REG_INDEX_X]);
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        registers.r[REG_INDEX_Z] = registers.r[REG_INDEX_X] ^ registers.r[REG_INDEX_Y];
-        registers.flags.n = isNegative(registers.r[REG_INDEX_Z]);
-        registers.flags.z = isZero(registers.r[REG_INDEX_Z]);
-    }
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executePush(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    pushIntoStack(registers.r[REG_INDEX]);
     return true;
 }
 
-bool CpuImpl::executeMultiplicationInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executePop(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto REG_INDEX = instruction.x;
+    registers.r[REG_INDEX] = popFromStack();
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto operand1 = registers.r[REG_INDEX];
-        const auto operand2 = memory->readWord(registers.pc);
-        const unsigned result = operand1 * operand2;
-        registers.flags.c = isMultiplicationCarry(result);
-        registers.flags.n = isNegative(result);
-        registers.flags.z = isZero(result);
-        registers.r[REG_INDEX] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto operand1 = registers.r[REG_INDEX_X];
-        const auto operand2 = registers.r[REG_INDEX_Y];
-        const unsigned result = operand1 * operand2;
-        registers.flags.c = isMultiplicationCarry(result);
-        registers.flags.n = isNegative(result);
-        registers.flags.z = isZero(result);
-        registers.r[REG_INDEX_X] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 2)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executePushAll(const DecodedInstruction&)
+{
+    std::array<u8, 32> data;
+    for (auto i = 0; i < 16; i++)
     {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        const auto operand1 = registers.r[REG_INDEX_X];
-        const auto operand2 = registers.r[REG_INDEX_Y];
-        const unsigned result = operand1 * operand2;
-        registers.flags.c = isMultiplicationCarry(result);
-        registers.flags.n = isNegative(result);
-        registers.flags.z = isZero(result);
-        registers.r[REG_INDEX_Z] = result & 0xFFFF;
+        data[i * 2] = registers.r[i] & 0xFF;
+        data[i * 2 + 1] = (registers.r[i] >> 8) & 0xFF;
     }
-    registers.pc += 2;
+    memory->writeBytes(registers.sp, data.data(), data.size());
+    registers.sp += data.size();
     return true;
 }
 
-bool CpuImpl::executeDivisionInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executePopAll(const DecodedInstruction&)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    std::array<u8, 32> data;
+    registers.sp -= data.size();
+    memory->readBytes(registers.sp, data.data(), data.size());
+    // Registers are popped one by one starting from the top of the stack
+    for (auto i = 0; i < 16; i++)
+        registers.r[i] = data[30 - i * 2] + data[31 - i * 2] * 0x100;
+    return true;
+}
 
-    auto rem = [](const auto operand1, const auto operand2) {
-        return operand1 % operand2;
-    };
-    auto mod = [](const auto operand1, const auto operand2) {
-        return ((operand1 % operand2) + operand2) % operand2;
-    };
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executePushFlags(const DecodedInstruction&)
+{
+    materializeFlags();
+    pushIntoStack(registers.flags.raw);
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX]);
-        const auto operand2 = static_cast<s16>(memory->readWord(registers.pc));
-        const unsigned result = static_cast<u32>(operand1 / operand2);
-        registers.flags.c = isDivisionCarry(operand1, operand2);
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
-        const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
-        const unsigned result = static_cast<u32>(operand1 / operand2);
-        registers.flags.c = isDivisionCarry(operand1, operand2);
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX_X] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
-        const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
-        const unsigned result = static_cast<u32>(operand1 / operand2);
-        registers.flags.c = isDivisionCarry(operand1, operand2);
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX_Z] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX]);
-        const auto operand2 = static_cast<s16>(memory->readWord(registers.pc));
-        const unsigned result = static_cast<u32>(mod(operand1, operand2));
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
-        const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
-        const unsigned result = static_cast<u32>(mod(operand1, operand2));
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX_X] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 5)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
-        const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
-        const unsigned result = static_cast<u32>(mod(operand1, operand2));
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX_Z] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 6)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX]);
-        const auto operand2 = static_cast<s16>(memory->readWord(registers.pc));
-        const unsigned result = static_cast<u32>(rem(operand1, operand2));
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 7)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
-        const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
-        const unsigned result = static_cast<u32>(rem(operand1, operand2));
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX_X] = result & 0xFFFF;
-    }
-    else if (innerInstructionIndex == 8)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto REG_INDEX_Z = decodeNibble(memory->readWord(registers.pc), 2);
-        const auto operand1 = static_cast<s16>(registers.r[REG_INDEX_X]);
-        const auto operand2 = static_cast<s16>(registers.r[REG_INDEX_Y]);
-        const unsigned result = static_cast<u32>(rem(operand1, operand2));
-        registers.flags.z = isZero(result);
-        registers.flags.n = isNegative(result);
-        registers.r[REG_INDEX_Z] = result & 0xFFFF;
-    }
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executePopFlags(const DecodedInstruction&)
+{
+    registers.flags.raw = popFromStack() & 0xFF;
+    registers.pendingFlags.operation = FlagsOperation::NONE;
     return true;
 }
 
-bool CpuImpl::executeShiftInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLoadPaletteAbsolute(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    loadPalette(instruction.immediate);
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto operand = decodeNibble(memory->readWord(registers.pc), 2);
-        registers.r[REG_INDEX] <<= operand;
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto operand = decodeNibble(memory->readWord(registers.pc), 2);
-        registers.r[REG_INDEX] >>= operand;
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        const auto operand = decodeNibble(memory->readWord(registers.pc), 2);
-        bool msb = registers.r[REG_INDEX] & 0x8000;
-        registers.r[REG_INDEX] = (registers.r[REG_INDEX] >> operand) | (msb << 15);
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto operand = registers.r[REG_INDEX_Y];
-        registers.r[REG_INDEX_X] <<= operand;
-        registers.flags.n = isNegative(registers.r[REG_INDEX_X]);
-        registers.flags.z = isZero(registers.r[REG_INDEX_X]);
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        const auto operand = registers.r[REG_INDEX_Y];
-        registers.r[REG_INDEX_X] >>= operand;
-        registers.flags.n = isNegative(registers.r[REG_INDEX_X]);
-        registers.flags.z = isZero(registers.r[REG_INDEX_X]);
-    }
-    else if (innerInstructionIndex == 5)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        bool msb = registers.r[REG_INDEX_X] & 0x8000;
-        const auto operand = registers.r[REG_INDEX_Y];
-        registers.r[REG_INDEX_X] = (registers.r[REG_INDEX_X] >> operand) | (msb << 15);
-        registers.flags.n = isNegative(registers.r[REG_INDEX_X]);
-        registers.flags.z = isZero(registers.r[REG_INDEX_X]);
-    }
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLoadPaletteIndirect(const DecodedInstruction& instruction)
+{
+    loadPalette(registers.r[instruction.x]);
     return true;
 }
 
-bool CpuImpl::executeStackInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeNotImmediate(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto REG_INDEX = instruction.x;
+    auto word = instruction.immediate;
+    registers.r[REG_INDEX] = ~(word & 0xFFFF);
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        pushIntoStack(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        registers.r[REG_INDEX] = popFromStack();
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        for (auto i = 0; i < 16; i++)
-            pushIntoStack(registers.r[i]);
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        for (auto i = 0; i < 16; i++)
-            registers.r[i] = popFromStack();
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        pushIntoStack(registers.flags.raw);
-    }
-    else if (innerInstructionIndex == 5)
-    {
-        registers.flags.raw = popFromStack() & 0xFF;
-    }
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeNotRegister(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    registers.r[REG_INDEX] = ~registers.r[REG_INDEX];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
     return true;
 }
 
-bool CpuImpl::executePaletteInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeNotRegisterIndirect(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    registers.r[REG_INDEX_X] = ~registers.r[REG_INDEX_Y];
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_X]);
+    return true;
+}
 
-    u16 addr = innerInstructionIndex == 0 ? 
-        memory->readWord(registers.pc) : registers.r[decodeNibble(opcode, 0)];
-    Palette palette;
-    for (auto i = 0; i < 16; i++)
-    {
-        std::uint32_t color = 0xFF;
-        for (auto j = 0; j < 3; j++)
-            color |= memory->readByte(addr + (i * 3) + j) << ((3 - j) * 8);
-        palette[i] = color;
-    }
-    bus->loadPalette(palette);
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeNegImmediate(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX = instruction.x;
+    auto word = instruction.immediate;
+    registers.r[REG_INDEX] = negate(word);
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
     return true;
 }
 
-bool CpuImpl::executeNegationInstruction(u16 opcode)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeNegRegister(const DecodedInstruction& instruction)
 {
-    const auto innerInstructionIndex = decodeNibble(opcode, 2);
+    const auto REG_INDEX = instruction.x;
+    auto word = registers.r[REG_INDEX];
+    registers.r[REG_INDEX] = negate(word);
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX]);
+    return true;
+}
 
-    if (innerInstructionIndex == 0)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        auto word = memory->readWord(registers.pc);
-        registers.r[REG_INDEX] = ~(word & 0xFFFF);
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 1)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        registers.r[REG_INDEX] = ~registers.r[REG_INDEX];
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 2)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        registers.r[REG_INDEX_X] = ~registers.r[REG_INDEX_Y];
-        registers.flags.z = isZero(registers.r[REG_INDEX_X]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX_X]);
-    }
-    else if (innerInstructionIndex == 3)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        auto word = memory->readWord(registers.pc);
-        registers.r[REG_INDEX] = negate(word);
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 4)
-    {
-        const auto REG_INDEX = decodeNibble(opcode, 0);
-        auto word = registers.r[REG_INDEX];
-        registers.r[REG_INDEX] = negate(word);
-        registers.flags.z = isZero(registers.r[REG_INDEX]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX]);
-    }
-    else if (innerInstructionIndex == 5)
-    {
-        const auto REG_INDEX_X = decodeNibble(opcode, 0);
-        const auto REG_INDEX_Y = decodeNibble(opcode, 1);
-        auto word = registers.r[REG_INDEX_Y];
-        registers.r[REG_INDEX_X] = negate(word);
-        registers.flags.z = isZero(registers.r[REG_INDEX_X]);
-        registers.flags.n = isNegative(registers.r[REG_INDEX_X]);
-    }
-    registers.pc += 2;
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeNegRegisterIndirect(const DecodedInstruction& instruction)
+{
+    const auto REG_INDEX_X = instruction.x;
+    const auto REG_INDEX_Y = instruction.y;
+    auto word = registers.r[REG_INDEX_Y];
+    registers.r[REG_INDEX_X] = negate(word);
+    if (instruction.evaluateFlags)
+        setLogicalFlags(registers.r[REG_INDEX_X]);
     return true;
 }
 
-bool CpuImpl::evaluateBranchCondition(unsigned index)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::evaluateBranchCondition(unsigned index)
 {
     ConditionalBranch conditionalBranch = static_cast<ConditionalBranch>(index);
+    materializeFlags();
     const auto flags = registers.flags;
 
     switch (conditionalBranch)
@@ -936,7 +1639,188 @@ bool CpuImpl::evaluateBranchCondition(unsigned index)
     return false;
 }
 
-unsigned CpuImpl::decodeNibble(u16 word, unsigned nibblePos)
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::evaluateSubtractionCondition(unsigned index, unsigned operand1, unsigned operand2,
+    unsigned result) const
+{
+    // Condition is derived from the operands, flags of the subtraction may stay pending
+    const bool equal = operand1 == operand2;
+    const bool borrow = isSubtractionBorrow(result);
+    const bool less = static_cast<s16>(operand1) < static_cast<s16>(operand2);
+
+    switch (static_cast<ConditionalBranch>(index))
+    {
+    case ConditionalBranch::ZERO:
+        return equal;
+    case ConditionalBranch::NOT_ZERO:
+        return !equal;
+    case ConditionalBranch::NEGATIVE:
+        return isNegative(result);
+    case ConditionalBranch::NOT_NEGATIVE:
+        return !isNegative(result);
+    case ConditionalBranch::POSITIVE:
+        return !isNegative(result) && !equal;
+    case ConditionalBranch::OVERFLOWED:
+        return isSubtractionOverflow(operand1, operand2, result);
+    case ConditionalBranch::NOT_OVERFLOW:
+        return !isSubtractionOverflow(operand1, operand2, result);
+    case ConditionalBranch::ABOVE:
+        return !borrow && !equal;
+    case ConditionalBranch::ABOVE_EQUAL:
+        return !borrow;
+    case ConditionalBranch::BELOW:
+        return borrow;
+    case ConditionalBranch::BELOW_EQUAL:
+        return borrow || equal;
+    case ConditionalBranch::GREATER:
+        return !less && !equal;
+    case ConditionalBranch::GREATER_EQUAL:
+        return !less;
+    case ConditionalBranch::LESS:
+        return less;
+    case ConditionalBranch::LESS_EQUAL:
+        return less || equal;
+    }
+
+    return false;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeCompareImmediateJump(const DecodedInstruction& instruction)
+{
+    const auto& jump = *instruction.next;
+    fusionCounts[instruction.fusionRule]++;
+    const unsigned operand1 = registers.r[instruction.x];
+    const unsigned operand2 = instruction.immediate;
+    const unsigned result = operand1 + negate(operand2);
+    if (instruction.evaluateFlags)
+        setSubtractionFlags(operand1, operand2, result);
+    if (evaluateSubtractionCondition(jump.x, operand1, operand2, result))
+        registers.pc = jump.immediate;
+    if (jump.idleLoopLength != 0)
+        noteIdleLoopJump(jump.immediate, jump.idleLoopLength);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeSubtractImmediateJump(const DecodedInstruction& instruction)
+{
+    const auto& jump = *instruction.next;
+    fusionCounts[instruction.fusionRule]++;
+    const unsigned operand1 = registers.r[instruction.x];
+    const unsigned operand2 = instruction.immediate;
+    const unsigned result = operand1 + negate(operand2);
+    if (instruction.evaluateFlags)
+        setSubtractionFlags(operand1, operand2, result);
+    registers.r[instruction.x] = result & 0xFFFF;
+    if (evaluateSubtractionCondition(jump.x, operand1, operand2, result))
+        registers.pc = jump.immediate;
+    if (jump.idleLoopLength != 0)
+        noteIdleLoopJump(jump.immediate, jump.idleLoopLength);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLoadImmediateAdd(const DecodedInstruction& instruction)
+{
+    const auto& add = *instruction.next;
+    fusionCounts[instruction.fusionRule]++;
+    registers.r[instruction.x] = instruction.immediate;
+    const unsigned operand1 = registers.r[add.x];
+    const unsigned operand2 = registers.r[add.y];
+    const unsigned result = operand1 + operand2;
+    if (add.evaluateFlags)
+        setAdditionFlags(operand1, operand2, result);
+    registers.r[add.x] = result & 0xFFFF;
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::executeLoadAddImmediateStore(const DecodedInstruction& instruction)
+{
+    const auto& add = *instruction.next;
+    const auto& store = *add.next;
+    fusionCounts[instruction.fusionRule]++;
+    registers.r[instruction.x] = memory->readWord(instruction.immediate);
+    const unsigned operand1 = add.immediate;
+    const unsigned operand2 = registers.r[add.x];
+    const unsigned result = operand1 + operand2;
+    if (add.evaluateFlags)
+        setAdditionFlags(operand1, operand2, result);
+    registers.r[add.x] = result & 0xFFFF;
+    memory->writeWord(store.immediate, registers.r[store.x]);
+    return true;
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setAdditionFlags(unsigned operand1, unsigned operand2, unsigned result)
+{
+    if (lazyFlags)
+    {
+        registers.pendingFlags = PendingFlags{ FlagsOperation::ADDITION, u16(operand1), u16(operand2), result };
+        return;
+    }
+    registers.flags.c = isAdditionCarry(result);
+    registers.flags.n = isNegative(result);
+    registers.flags.z = isZero(result);
+    registers.flags.o = isAdditionOverflow(operand1, operand2, result);
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setSubtractionFlags(unsigned operand1, unsigned operand2, unsigned result)
+{
+    if (lazyFlags)
+    {
+        registers.pendingFlags = PendingFlags{ FlagsOperation::SUBTRACTION, u16(operand1), u16(operand2), result };
+        return;
+    }
+    registers.flags.c = isSubtractionBorrow(result);
+    registers.flags.n = isNegative(result);
+    registers.flags.z = isZero(result);
+    registers.flags.o = isSubtractionOverflow(operand1, operand2, result);
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::setLogicalFlags(unsigned result)
+{
+    if (lazyFlags)
+    {
+        // Carry and overflow of the pending arithmetic operation stay visible after logical operation
+        if (registers.pendingFlags.operation != FlagsOperation::LOGICAL)
+            materializeFlags();
+        registers.pendingFlags = PendingFlags{ FlagsOperation::LOGICAL, 0, 0, result };
+        return;
+    }
+    registers.flags.z = isZero(result);
+    registers.flags.n = isNegative(result);
+}
+
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::materializeFlags()
+{
+    const auto& pending = registers.pendingFlags;
+    switch (pending.operation)
+    {
+    case FlagsOperation::NONE:
+        return;
+    case FlagsOperation::ADDITION:
+        registers.flags.c = isAdditionCarry(pending.result);
+        registers.flags.o = isAdditionOverflow(pending.operand1, pending.operand2, pending.result);
+        break;
+    case FlagsOperation::SUBTRACTION:
+        registers.flags.c = isSubtractionBorrow(pending.result);
+        registers.flags.o = isSubtractionOverflow(pending.operand1, pending.operand2, pending.result);
+        break;
+    case FlagsOperation::LOGICAL:
+        break;
+    }
+    registers.flags.n = isNegative(pending.result);
+    registers.flags.z = isZero(pending.result);
+    registers.pendingFlags.operation = FlagsOperation::NONE;
+}
+
+template <typename MemoryT, typename BusT>
+unsigned BasicCpu<MemoryT, BusT>::decodeNibble(u16 word, unsigned nibblePos)
 {
     if (nibblePos < 4)
     {
@@ -949,49 +1833,77 @@ unsigned CpuImpl::decodeNibble(u16 word, unsigned nibblePos)
     }
 }
 
-bool CpuImpl::isZero(unsigned data) const
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isZero(unsigned data) const
 {
     return (data & 0xFFFF) == 0;
 }
 
-bool CpuImpl::isNegative(unsigned data) const
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isNegative(unsigned data) const
 {
     return (data >> 15) & 1;
 }
 
-bool CpuImpl::isAdditionCarry(unsigned data) const
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isAdditionCarry(unsigned data) const
 {
     return (data >> 16) & 1;
 }
 
-bool CpuImpl::isAdditionOverflow(unsigned operand1, unsigned operand2, unsigned result) const
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isAdditionOverflow(unsigned operand1, unsigned operand2, unsigned result) const
 {
     return (isNegative(operand1) && isNegative(operand2) && !isNegative(result))
         || (!isNegative(operand1) && !isNegative(operand2) && isNegative(result));
 }
 
-bool CpuImpl::isSubtractionBorrow(unsigned result) const
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isSubtractionBorrow(unsigned result) const
 {
     return !((result >> 16) & 1);
 }
 
-bool CpuImpl::isSubtractionOverflow(unsigned operand1, unsigned operand2, unsigned result) const
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isSubtractionOverflow(unsigned operand1, unsigned operand2, unsigned result) const
 {
     return (!isNegative(result) && isNegative(operand1) && !isNegative(operand2))
         || (isNegative(result) && !isNegative(operand1) && isNegative(operand2));
 }
 
-bool CpuImpl::isMultiplicationCarry(unsigned result) const
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isMultiplicationCarry(unsigned result) const
 {
     return result > UINT16_MAX;
 }
 
-bool CpuImpl::isDivisionCarry(unsigned operand1, unsigned operand2) const
+template <typename MemoryT, typename BusT>
+bool BasicCpu<MemoryT, BusT>::isDivisionCarry(unsigned operand1, unsigned operand2) const
 {
     return !!(operand1 % operand2);
 }
 
-u16 CpuImpl::negate(u16 word)
+template <typename MemoryT, typename BusT>
+void BasicCpu<MemoryT, BusT>::loadPalette(u16 addr)
+{
+    std::array<u8, 48> data;
+    memory->readBytes(addr, data.data(), data.size());
+    Palette palette;
+    for (auto i = 0; i < 16; i++)
+    {
+        std::uint32_t color = 0xFF;
+        for (auto j = 0; j < 3; j++)
+            color |= data[i * 3 + j] << ((3 - j) * 8);
+        palette[i] = color;
+    }
+    bus->loadPalette(palette);
+}
+
+template <typename MemoryT, typename BusT>
+u16 BasicCpu<MemoryT, BusT>::negate(u16 word)
 {
     return static_cast<u16>(-static_cast<s16>(word));
 }
+
+template class BasicCpu<Memory, Bus>;
+template class BasicCpu<MemoryImpl, BasicBus<GraphicsImpl>>;
@@ -1,23 +1,47 @@
 #pragma once
 
+#include <array>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "Cpu.hpp"
 #include "Memory.hpp"
+#include "MemoryWriteObserver.hpp"
 #include "Bus.hpp"
+#include "DecodeCache.hpp"
+#include "InstructionSet.hpp"
+#include "FlagsLiveness.hpp"
+#include "IdleLoopAnalysis.hpp"
 #include "ConditionalBranch.hpp"
 #include "../log/Logger.hpp"
 #include "../log/HexModificator.hpp"
 #include "../utils/Random.hpp"
 
-class CpuImpl : public Cpu
+class MemoryImpl;
+class GraphicsImpl;
+
+template <typename GraphicsT>
+class BasicBus;
+
+/**
+ * Interpreter of chip16 code parametrized with types of memory and bus it accesses.
+ * Instantiated with the interfaces it calls memory and bus virtually, which allows to substitute mocks.
+ * Instantiated with final implementations the accesses are resolved statically and can be inlined.
+ */
+template <typename MemoryT, typename BusT>
+class BasicCpu : public Cpu, public MemoryWriteObserver
 {
 public:
-	CpuImpl() = default;
+    using MemoryType = MemoryT;
+    using BusType = BusT;
 
-    CpuImpl(const std::shared_ptr<Memory>& memory, const std::shared_ptr<Bus>& bus);
+	BasicCpu() = default;
 
-    ~CpuImpl() = default;
+    BasicCpu(const std::shared_ptr<MemoryT>& memory, const std::shared_ptr<BusT>& bus);
+
+    ~BasicCpu();
 
     u16 fetchOpcode() override;
 
@@ -27,29 +51,146 @@ public:
 
 	void executeInstruction(u16 opcode) override;
 
+    void step() override;
+
+    StopReason run(unsigned maxCycles) override;
+
+    void setBreakpoint(u16 addr, bool enabled) override;
+
+    std::uint64_t getCycles() const override;
+
+    void skipCycles(std::uint64_t count) override;
+
+    void setRandomSeed(std::uint64_t seed) override;
+
+    std::uint64_t getRandomSeed() const override;
+
+    std::vector<CachedBlock> exportCode() const override;
+
+    unsigned importCode(const std::vector<CachedBlock>& blocks) override;
+
+    Snapshot takeSnapshot() const override;
+
+    void restoreSnapshot(const Snapshot& snapshot) override;
+
     CpuRegisters& getRegisters() override;
 
-private:
-    bool validateInstructionIndex(u16 opcode);
-
-    bool executeMiscInstruction(u16 opcode);           // 0x
-    bool executeJumpInstruction(u16 opcode);           // 1x
-    bool executeLoadInstruction(u16 opcode);           // 2x
-    bool executeStoreInstruction(u16 opcode);          // 3x
-    bool executeAdditionInstruction(u16 opcode);       // 4x
-    bool executeSubtractionInstruction(u16 opcode);    // 5x
-    bool executeBitwiseAndInstruction(u16 opcode);     // 6x
-    bool executeBitwiseOrInstruction(u16 opcode);      // 7x
-    bool executeBitwiseXorInstruction(u16 opcode);     // 8x
-    bool executeMultiplicationInstruction(u16 opcode); // 9x
-    bool executeDivisionInstruction(u16 opcode);       // Ax
-    bool executeShiftInstruction(u16 opcode);          // Bx
-    bool executeStackInstruction(u16 opcode);          // Cx
-    bool executePaletteInstruction(u16 opcode);        // Dx
-    bool executeNegationInstruction(u16 opcode);       // Ex
+    void onMemoryWrite(u16 addr, unsigned size) override;
+
+#if defined(CHIP16_WATCHPOINTS)
+    WatchpointHit getWatchpointHit() const override;
+
+    void onWatchpointHit(u16 addr, bool write) override;
+#endif
+
+    /**
+     * Switches between eager and lazy evaluation of flags.
+     * In lazy mode arithmetic and logical instructions only record their operands and result,
+     * flags are computed when branch, PUSHF, DRW or getRegisters() needs them.
+     *
+     * @param enabled True to evaluate flags lazily.
+     */
+    void setLazyFlags(bool enabled);
+
+    /**
+     * Enables skipping computation of flags that are overwritten before any instruction reads them.
+     * Skipped flags keep stale values until the end of basic block, which is visible only
+     * when registers are inspected between instructions of the block.
+     * Previously decoded code is discarded.
+     *
+     * @param enabled True to eliminate dead flags.
+     */
+    void setDeadFlagsElimination(bool enabled);
+
+    /**
+     * Debug switch computing all flags while tracking the ones considered dead.
+     * Reading a tracked flag before it is overwritten is reported as an error.
+     * Previously decoded code is discarded.
+     *
+     * @param enabled True to cross-check dead flags analysis.
+     */
+    void setDeadFlagsCrossCheck(bool enabled);
+
+    /**
+     * Returns number of reads of flags that were considered dead, detected by the cross-check.
+     *
+     * @return Number of detected failures.
+     */
+    unsigned getDeadFlagsCheckFailures() const;
+
+    /**
+     * Enables execution of common instruction sequences by single fused handlers.
+     * Whole fused sequence is executed within one step.
+     * Previously decoded code is discarded.
+     *
+     * @param enabled True to fuse instructions.
+     */
+    void setInstructionFusion(bool enabled);
+
+    /**
+     * Returns number of executions of each fused instruction sequence.
+     *
+     * @return Pairs of sequence name and number of its executions.
+     */
+    std::vector<std::pair<const char*, std::uint64_t>> getFusionStatistics() const;
+
+    /**
+     * Enables detection of loops polling memory that only the host changes, see IdleLoopAnalysis.
+     * Once a detected loop has executed a whole iteration, run() skips the iterations
+     * fitting into the remaining budget and returns StopReason::IDLE_LOOP.
+     * Previously decoded code is discarded.
+     *
+     * @param enabled True to detect idle loops.
+     */
+    void setIdleLoopDetection(bool enabled);
+
+    /**
+     * Returns number of cycles skipped in each detected idle loop.
+     *
+     * @return Pairs of address of the first instruction of loop and number of skipped cycles.
+     */
+    std::vector<std::pair<u16, std::uint64_t>> getIdleLoopStatistics() const;
+
+protected:
+    struct DecodedInstruction;
+
+    using InstructionHandler = bool (BasicCpu::*)(const DecodedInstruction&);
+
+    struct DecodedInstruction
+    {
+        InstructionHandler handler;
+        u16 opcode;
+        u16 immediate;  // Second word of the instruction
+        u8 x;
+        u8 y;
+        u8 z;
+        u8 deadFlags;       // Written flags never read before being overwritten
+        bool evaluateFlags; // False if computation of all written flags can be skipped
+        u8 fusionRule;      // Index of fusion rule if handler executes fused sequence
+        u8 length;          // Number of instructions executed by handler
+        u8 idleLoopLength;  // Number of instructions of idle loop closed by the jump, 0 if none
+        const DecodedInstruction* next; // Following instruction of fused sequence
+    };
+
+    DecodedInstruction decodeInstruction(u32 word);
+    DecodedInstruction decodeInstruction(u16 opcode, u16 operand);
+    void executeDecodedInstruction(const DecodedInstruction& instruction);
+    void executeFetchedInstruction(u32 word);
+    void eliminateDeadFlags(std::vector<DecodedInstruction>& instructions);
+    void checkDeadFlags(const DecodedInstruction& instruction);
+
+    const DecodedInstruction& executeNextInstruction();
+    void startRun();
+    bool matchesMemory(const CachedBlock& block) const;
+    void requestStop(StopReason reason);
+    bool isBreakpoint(u16 addr) const;
+    bool containsBreakpoint(u16 start, u32 end) const;
+    void detectIdleLoop(u16 addr, DecodedInstruction& instruction);
+    void noteIdleLoopJump(u16 start, u8 length);
+    void skipIdleLoop(std::uint64_t limit);
 
     bool evaluateBranchCondition(unsigned index);
-    unsigned decodeNibble(u16 word, unsigned nibblePos);
+    bool evaluateSubtractionCondition(unsigned index, unsigned operand1, unsigned operand2, unsigned result) const;
 
     bool isZero(unsigned data) const;
     bool isNegative(unsigned data) const;
@@ -65,9 +206,202 @@ private:
 
     u16 negate(u16 word);
 
+    void setAdditionFlags(unsigned operand1, unsigned operand2, unsigned result);
+    void setSubtractionFlags(unsigned operand1, unsigned operand2, unsigned result);
+    void setLogicalFlags(unsigned result);
+    void materializeFlags();
+
     CpuRegisters registers;
-    std::shared_ptr<Memory> memory;
-    std::shared_ptr<Bus> bus;
+    std::shared_ptr<MemoryT> memory;
+    std::shared_ptr<BusT> bus;
+    bool deadFlagsCrossCheck = false;
+    bool idleLoopDetection = false;
+    std::uint64_t cycles = 0;
+    bool stopRequested = false;
+    StopReason stopReason = StopReason::BUDGET_EXHAUSTED;
+#if defined(CHIP16_WATCHPOINTS)
+    WatchpointHit watchpointHit = {};
+#endif
+
+private:
+    static constexpr unsigned MAX_FUSED_INSTRUCTIONS = 3;
+    static constexpr unsigned FUSION_RULES_COUNT = 4;
+
+    struct FusionRule
+    {
+        const char* name;
+        unsigned length;
+        std::array<Operation, MAX_FUSED_INSTRUCTIONS> operations;
+        InstructionHandler handler;
+    };
+
+    static constexpr InstructionHandler getOperationHandler(Operation operation);
+
+    template <std::size_t... Opcodes>
+    static constexpr std::array<InstructionHandler, sizeof...(Opcodes)> generateHandlerTable(std::index_sequence<Opcodes...>);
+
+    bool executeInvalidInstruction(const DecodedInstruction& instruction);
+
+    // 0x
+    bool executeNop(const DecodedInstruction& instruction);
+    bool executeClearScreen(const DecodedInstruction& instruction);
+    bool executeVBlnk(const DecodedInstruction& instruction);
+    bool executeBackgroundColor(const DecodedInstruction& instruction);
+    bool executeSpriteDimensions(const DecodedInstruction& instruction);
+    bool executeDrawSpriteImmediate(const DecodedInstruction& instruction);
+    bool executeDrawSpriteIndirect(const DecodedInstruction& instruction);
+    bool executeRandom(const DecodedInstruction& instruction);
+    bool executeFlip(const DecodedInstruction& instruction);
+    bool executeSound(const DecodedInstruction& instruction);
+
+    // 1x
+    bool executeJump(const DecodedInstruction& instruction);
+    bool executeJumpCarry(const DecodedInstruction& instruction);
+    bool executeJumpConditionally(const DecodedInstruction& instruction);
+    bool executeJumpRegsEqual(const DecodedInstruction& instruction);
+    bool executeCall(const DecodedInstruction& instruction);
+    bool executeReturn(const DecodedInstruction& instruction);
+    bool executeJumpIndirect(const DecodedInstruction& instruction);
+    bool executeCallConditionally(const DecodedInstruction& instruction);
+    bool executeCallIndirect(const DecodedInstruction& instruction);
+
+    // 2x
+    bool executeLoadRegisterImmediate(const DecodedInstruction& instruction);
+    bool executeLoadSpImmediate(const DecodedInstruction& instruction);
+    bool executeLoadRegisterIndirect(const DecodedInstruction& instruction);
+    bool executeLoadRegisterIndexed(const DecodedInstruction& instruction);
+    bool executeMoveRegister(const DecodedInstruction& instruction);
+
+    // 3x
+    bool executeStoreIndirect(const DecodedInstruction& instruction);
+    bool executeStoreIndexed(const DecodedInstruction& instruction);
+
+    // 4x
+    bool executeAddImmediate(const DecodedInstruction& instruction);
+    bool executeAddRegister(const DecodedInstruction& instruction);
+    bool executeAddRegisters(const DecodedInstruction& instruction);
+
+    // 5x
+    bool executeSubtractImmediate(const DecodedInstruction& instruction);
+    bool executeSubtractRegister(const DecodedInstruction& instruction);
+    bool executeSubtractRegisters(const DecodedInstruction& instruction);
+    bool executeCompareImmediate(const DecodedInstruction& instruction);
+    bool executeCompareRegister(const DecodedInstruction& instruction);
+
+    // 6x
+    bool executeBitwiseAndImmediate(const DecodedInstruction& instruction);
+    bool executeBitwiseAndRegister(const DecodedInstruction& instruction);
+    bool executeBitwiseAndRegisters(const DecodedInstruction& instruction);
+    bool executeBitwiseTestImmediate(const DecodedInstruction& instruction);
+    bool executeBitwiseTestRegister(const DecodedInstruction& instruction);
+
+    // 7x
+    bool executeBitwiseOrImmediate(const DecodedInstruction& instruction);
+    bool executeBitwiseOrRegister(const DecodedInstruction& instruction);
+    bool executeBitwiseOrRegisters(const DecodedInstruction& instruction);
+
+    // 8x
+    bool executeBitwiseXorImmediate(const DecodedInstruction& instruction);
+    bool executeBitwiseXorRegister(const DecodedInstruction& instruction);
+    bool executeBitwiseXorRegisters(const DecodedInstruction& instruction);
+
+    // 9x
+    bool executeMultiplyImmediate(const DecodedInstruction& instruction);
+    bool executeMultiplyRegister(const DecodedInstruction& instruction);
+    bool executeMultiplyRegisters(const DecodedInstruction& instruction);
+
+    // Ax
+    bool executeDivideImmediate(const DecodedInstruction& instruction);
+    bool executeDivideRegister(const DecodedInstruction& instruction);
+    bool executeDivideRegisters(const DecodedInstruction& instruction);
+    bool executeModuloImmediate(const DecodedInstruction& instruction);
+    bool executeModuloRegister(const DecodedInstruction& instruction);
+    bool executeModuloRegisters(const DecodedInstruction& instruction);
+    bool executeRemainderImmediate(const DecodedInstruction& instruction);
+    bool executeRemainderRegister(const DecodedInstruction& instruction);
+    bool executeRemainderRegisters(const DecodedInstruction& instruction);
+
+    // Bx
+    bool executeLogicalShiftLeftImmediate(const DecodedInstruction& instruction);
+    bool executeLogicalShiftRightImmediate(const DecodedInstruction& instruction);
+    bool executeArithmeticShiftRightImmediate(const DecodedInstruction& instruction);
+    bool executeLogicalShiftLeftIndirect(const DecodedInstruction& instruction);
+    bool executeLogicalShiftRightIndirect(const DecodedInstruction& instruction);
+    bool executeArithmeticShiftRightIndirect(const DecodedInstruction& instruction);
+
+    // Cx
+    bool executePush(const DecodedInstruction& instruction);
+    bool executePop(const DecodedInstruction& instruction);
+    bool executePushAll(const DecodedInstruction& instruction);
+    bool executePopAll(const DecodedInstruction& instruction);
+    bool executePushFlags(const DecodedInstruction& instruction);
+    bool executePopFlags(const DecodedInstruction& instruction);
+
+    // Dx
+    bool executeLoadPaletteAbsolute(const DecodedInstruction& instruction);
+    bool executeLoadPaletteIndirect(const DecodedInstruction& instruction);
+
+    // Ex
+    bool executeNotImmediate(const DecodedInstruction& instruction);
+    bool executeNotRegister(const DecodedInstruction& instruction);
+    bool executeNotRegisterIndirect(const DecodedInstruction& instruction);
+    bool executeNegImmediate(const DecodedInstruction& instruction);
+    bool executeNegRegister(const DecodedInstruction& instruction);
+    bool executeNegRegisterIndirect(const DecodedInstruction& instruction);
+
+    // Fused sequences
+    bool executeCompareImmediateJump(const DecodedInstruction& instruction);
+    bool executeSubtractImmediateJump(const DecodedInstruction& instruction);
+    bool executeLoadImmediateAdd(const DecodedInstruction& instruction);
+    bool executeLoadAddImmediateStore(const DecodedInstruction& instruction);
+
+    const DecodedInstruction& decodeIntoCache(u16 addr);
+    unsigned getDecodeWindow() const;
+    void fuseInstructions(u16 addr, std::vector<DecodedInstruction>& instructions);
+
+    unsigned decodeNibble(u16 word, unsigned nibblePos);
+
+    void loadPalette(u16 addr);
+
+    DecodeCache<DecodedInstruction> decodeCache;
+    bool lazyFlags = false;
+    bool deadFlagsElimination = false;
+    u8 uncheckedDeadFlags = 0;
+    unsigned deadFlagsCheckFailures = 0;
+    bool instructionFusion = false;
+    std::array<std::uint64_t, FUSION_RULES_COUNT> fusionCounts = {};
+    std::vector<bool> breakpoints = std::vector<bool>(0x10000);
+    unsigned breakpointsCount = 0;
+    u16 idleLoopStart = 0;
+    u8 idleLoopLength = 0;      // Loop whose closing jump has been taken last, 0 if none
+    std::map<u16, std::uint64_t> idleLoopCycles;
+    Random random;
+
+    // Instructions decoded together for the analysis of flags
+    static constexpr unsigned FLAGS_ANALYSIS_WINDOW = 8;
+
+    static const std::array<InstructionHandler, InstructionSet::OPCODES_COUNT> HANDLERS;
+    static const std::array<FusionRule, FUSION_RULES_COUNT> FUSION_RULES;
 
     static Logger LOG;
-};
\ No newline at end of file
+};
+
+/**
+ * Cpu accessing memory and bus through virtual interfaces.
+ */
+using CpuImpl = BasicCpu<Memory, Bus>;
+
+/**
+ * Cpu statically bound to implementations of memory, bus and graphics used by the emulator.
+ */
+using StaticCpuImpl = BasicCpu<MemoryImpl, BasicBus<GraphicsImpl>>;
+
+/**
+ * Interpreter extended by JitCpuImpl and AotCpuImpl, statically bound
+ * unless memory accesses are traced through the interface.
+ */
+#if defined(CHIP16_TRACE_MEMORY)
+using RecompilingCpuBase = CpuImpl;
+#else
+using RecompilingCpuBase = StaticCpuImpl;
+#endif
@@ -9,4 +9,5 @@ struct CpuRegisters
     u16 sp;
     u16 r[16];
     CpuFlags flags;
+    PendingFlags pendingFlags;  // Valid only when flags are evaluated lazily
 };
\ No newline at end of file
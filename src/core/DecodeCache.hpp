@@ -0,0 +1,98 @@
+#pragma once
+
+#include <bitset>
+#include <vector>
+
+#include "Types.hpp"
+
+/**
+ * Cache of decoded instructions indexed by address of the instruction.
+ * Entries are filled lazily and dropped when memory they were decoded from is written.
+ */
+template <typename Entry>
+class DecodeCache
+{
+public:
+    DecodeCache();
+
+    ~DecodeCache() = default;
+
+    /**
+     * Returns cached entry of the instruction at given address.
+     *
+     * @param addr Address of the instruction.
+     * @return Pointer to the cached entry or nullptr if instruction was not decoded yet.
+     */
+    const Entry* find(u16 addr) const;
+
+    /**
+     * Stores entry of the instruction at given address.
+     *
+     * @param addr Address of the instruction.
+     * @param entry Decoded instruction.
+     * @return Reference to the stored entry.
+     */
+    const Entry& insert(u16 addr, const Entry& entry);
+
+    /**
+     * Drops entries of every instruction overlapping given memory range.
+     *
+     * @param addr Address of the first written byte.
+     * @param size Number of written bytes.
+     */
+    void invalidate(u16 addr, unsigned size);
+
+    /**
+     * Drops all entries.
+     */
+    void clear();
+
+private:
+    static constexpr unsigned INSTRUCTION_SIZE = 4;
+    static constexpr unsigned ENTRIES_COUNT = 0x10000;
+
+    std::vector<Entry> entries;
+    std::bitset<ENTRIES_COUNT> valid;
+};
+
+template <typename Entry>
+inline DecodeCache<Entry>::DecodeCache()
+    : entries(ENTRIES_COUNT)
+    , valid()
+{
+}
+
+template <typename Entry>
+inline const Entry* DecodeCache<Entry>::find(u16 addr) const
+{
+    return valid[addr] ? &entries[addr] : nullptr;
+}
+
+template <typename Entry>
+inline const Entry& DecodeCache<Entry>::insert(u16 addr, const Entry& entry)
+{
+    entries[addr] = entry;
+    valid[addr] = true;
+    return entries[addr];
+}
+
+template <typename Entry>
+inline void DecodeCache<Entry>::invalidate(u16 addr, unsigned size)
+{
+    if (size >= ENTRIES_COUNT - INSTRUCTION_SIZE)
+    {
+        clear();
+        return;
+    }
+
+    // Instruction starting up to 3 bytes before written range overlaps it
+    u16 first = addr - (INSTRUCTION_SIZE - 1);
+    for (auto i = 0u; i < size + INSTRUCTION_SIZE - 1; i++)
+        valid[u16(first + i)] = false;
+}
+
+template <typename Entry>
+inline void DecodeCache<Entry>::clear()
+{
+    valid.reset();
+}
@@ -0,0 +1,83 @@
+#include "ExecutableMemory.hpp"
+
+#if CHIP16_JIT_SUPPORTED
+
+#include <cstring>
+#include <algorithm>
+#include <sys/mman.h>
+#include <unistd.h>
+
+Logger ExecutableMemory::LOG(STRINGIFY(ExecutableMemory));
+
+ExecutableMemory::ExecutableMemory(std::size_t capacity)
+    : memory(nullptr)
+    , capacity(capacity)
+    , used(0)
+{
+    void* mapping = mmap(nullptr, capacity, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        LOG.error("Unable to map ", capacity, " bytes of executable memory");
+        return;
+    }
+    memory = static_cast<u8*>(mapping);
+}
+
+ExecutableMemory::~ExecutableMemory()
+{
+    if (memory)
+        munmap(memory, capacity);
+}
+
+bool ExecutableMemory::isValid() const
+{
+    return memory != nullptr;
+}
+
+const void* ExecutableMemory::write(const std::vector<u8>& code)
+{
+    const auto start = (used + CODE_ALIGNMENT - 1) & ~(CODE_ALIGNMENT - 1);
+    if (!memory || start + code.size() > capacity)
+        return nullptr;
+
+    if (!setWritable(start, code.size(), true))
+        return nullptr;
+    std::memcpy(memory + start, code.data(), code.size());
+    if (!setWritable(start, code.size(), false))
+        return nullptr;
+
+    used = start + code.size();
+    return memory + start;
+}
+
+bool ExecutableMemory::patch(const void* address, const void* bytes, std::size_t size)
+{
+    const auto start = static_cast<std::size_t>(static_cast<const u8*>(address) - memory);
+    if (!setWritable(start, size, true))
+        return false;
+    std::memcpy(memory + start, bytes, size);
+    return setWritable(start, size, false);
+}
+
+void ExecutableMemory::reset()
+{
+    LOG.debug("Discarding ", used, " bytes of generated code");
+    used = 0;
+}
+
+bool ExecutableMemory::setWritable(std::size_t start, std::size_t size, bool writable)
+{
+    // Protection is changed for whole pages
+    const auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const auto first = start / pageSize * pageSize;
+    const auto end = std::min(capacity, (start + size + pageSize - 1) / pageSize * pageSize);
+    const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ | PROT_EXEC;
+    if (mprotect(memory + first, end - first, protection) != 0)
+    {
+        LOG.error("Unable to change protection of executable memory");
+        return false;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "Types.hpp"
+#include "../log/Logger.hpp"
+
+#if defined(__x86_64__) && defined(__linux__)
+#define CHIP16_JIT_SUPPORTED 1
+#else
+#define CHIP16_JIT_SUPPORTED 0
+#endif
+
+#if CHIP16_JIT_SUPPORTED
+
+/**
+ * Arena of memory pages holding code generated by the dynamic recompiler.
+ * Pages are writable only while code is being copied into them and executable otherwise.
+ * Code is never freed individually, the whole arena is reset once it runs out of space.
+ */
+class ExecutableMemory
+{
+public:
+    explicit ExecutableMemory(std::size_t capacity);
+
+    ~ExecutableMemory();
+
+    ExecutableMemory(const ExecutableMemory&) = delete;
+
+    ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+
+    /**
+     * Checks whether memory for the arena has been successfully mapped.
+     *
+     * @return True if arena can be used, false otherwise.
+     */
+    bool isValid() const;
+
+    /**
+     * Copies code into the arena.
+     *
+     * @param code Machine code to be copied.
+     * @return Pointer to the executable copy of the code or nullptr if arena is full.
+     */
+    const void* write(const std::vector<u8>& code);
+
+    /**
+     * Overwrites part of the code already written into the arena.
+     * Only pages containing the overwritten bytes are made writable.
+     *
+     * @param address Address of the first overwritten byte.
+     * @param bytes Bytes to be copied.
+     * @param size Number of bytes to be copied.
+     * @return True if code has been overwritten, false otherwise.
+     */
+    bool patch(const void* address, const void* bytes, std::size_t size);
+
+    /**
+     * Discards all code written into the arena.
+     */
+    void reset();
+
+private:
+    static constexpr std::size_t CODE_ALIGNMENT = 16;
+
+    bool setWritable(std::size_t start, std::size_t size, bool writable);
+
+    u8* memory;
+    std::size_t capacity;
+    std::size_t used;
+
+    static Logger LOG;
+};
+
+#endif
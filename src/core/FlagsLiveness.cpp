@@ -0,0 +1,20 @@
+#include "FlagsLiveness.hpp"
+
+std::vector<u8> FlagsLiveness::findDeadFlags(const std::vector<Operation>& operations)
+{
+    std::vector<u8> deadFlags(operations.size());
+    u8 liveFlags = InstructionSet::ALL_FLAGS;
+    for (auto i = operations.size(); i-- > 0;)
+    {
+        const auto operation = operations[i];
+        const auto written = InstructionSet::flagsWritten(operation);
+        deadFlags[i] = written & ~liveFlags;
+
+        // Instruction modifying code that follows it may replace the instruction overwriting flags
+        if (InstructionSet::writesMemory(operation))
+            liveFlags = InstructionSet::ALL_FLAGS;
+
+        liveFlags = (liveFlags & ~written) | InstructionSet::flagsRead(operation);
+    }
+    return deadFlags;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include "Types.hpp"
+#include "InstructionSet.hpp"
+
+/**
+ * Backward analysis of flags usage within a sequence of consecutive instructions.
+ * Every flag is assumed to be observed after the last instruction of the sequence,
+ * before instructions that may overwrite code and by instructions that read flags.
+ */
+class FlagsLiveness
+{
+public:
+    /**
+     * Finds flags written by each instruction that are never observed before being overwritten.
+     *
+     * @param operations Operations of consecutive instructions.
+     * @return Mask of dead written flags for each instruction.
+     */
+    static std::vector<u8> findDeadFlags(const std::vector<Operation>& operations);
+};
@@ -74,10 +74,10 @@ public:
      * 
      * @param x Position x.
      * @param y Position y.
-     * @param start iterator of the first element from memory.
+     * @param start pointer to the first element from memory.
      * @return True or false if any current pixel collided with one from sprite.
      */
-    virtual bool drawSprite(u16 x, u16 y, std::vector<u8>::const_iterator start) = 0;
+    virtual bool drawSprite(u16 x, u16 y, const u8* start) = 0;
 
     /**
      * Set horizontal flip value.
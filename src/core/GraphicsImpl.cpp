@@ -7,6 +7,8 @@ GraphicsImpl::GraphicsImpl()
     , palette()
     , registers()
     , vblank(false)
+    , snapshotBuffer()
+    , bufferModified(true)
 {
     initPalette();
 }
@@ -47,6 +49,7 @@ void GraphicsImpl::clearScreen()
     LOG.debug("Clearing screen.");
     for (auto byte : buffer)
         byte = 0;
+    bufferModified = true;
 
     registers.bg = 0;
 }
@@ -74,9 +77,10 @@ void GraphicsImpl::setSpriteDimensions(u8 width, u8 height)
     registers.spriteh = height;
 }
 
-bool GraphicsImpl::drawSprite(u16 x, u16 y, std::vector<u8>::const_iterator start)
+bool GraphicsImpl::drawSprite(u16 x, u16 y, const u8* start)
 {
     LOG.debug("Drawing sprite at position [", logNumber(x), ",", logNumber(y), "]");
+    bufferModified = true;
     
     bool collision = false;
     const auto bytesToPut = registers.spritew * registers.spriteh;
@@ -191,3 +195,26 @@ GraphicsImpl::Registers& GraphicsImpl::getRegisters()
 {
     return registers;
 }
+
+GraphicsImpl::Snapshot GraphicsImpl::takeSnapshot()
+{
+    if (bufferModified || snapshotBuffer == nullptr)
+    {
+        snapshotBuffer = std::make_shared<const std::vector<u8>>(buffer);
+        bufferModified = false;
+    }
+    return Snapshot{ snapshotBuffer, palette, registers, vblank };
+}
+
+void GraphicsImpl::restoreSnapshot(const Snapshot& snapshot)
+{
+    if (snapshot.buffer != nullptr && (bufferModified || snapshot.buffer != snapshotBuffer))
+    {
+        buffer = *snapshot.buffer;
+        snapshotBuffer = snapshot.buffer;
+        bufferModified = false;
+    }
+    palette = snapshot.palette;
+    registers = snapshot.registers;
+    vblank = snapshot.vblank;
+}
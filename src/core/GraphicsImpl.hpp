@@ -1,11 +1,13 @@
 #pragma once
 
+#include <memory>
+
 #include "Graphics.hpp"
 #include "../log/Logger.hpp"
 #include "../log/HexModificator.hpp"
 #include "../log/NumberModificator.hpp"
 
-class GraphicsImpl : public Graphics
+class GraphicsImpl final : public Graphics
 {
 public:
     GraphicsImpl();
@@ -30,7 +32,7 @@ public:
 
     void setSpriteDimensions(u8 width, u8 height) override;
 
-    bool drawSprite(u16 x, u16 y, std::vector<u8>::const_iterator start) override;
+    bool drawSprite(u16 x, u16 y, const u8* start) override;
 
     void setHFlip(bool flip) override;
 
@@ -51,6 +53,32 @@ public:
     bool vblank;
     Registers& getRegisters();
 
+    /**
+     * State of graphics restored by restoreSnapshot().
+     * Screen buffer not drawn into between snapshots is shared by them instead of being copied.
+     */
+    struct Snapshot
+    {
+        std::shared_ptr<const std::vector<u8>> buffer;
+        Palette palette;
+        Registers registers;
+        bool vblank;
+    };
+
+    /**
+     * Captures screen buffer, palette, registers and vertical blank flag.
+     *
+     * @return Snapshot of graphics.
+     */
+    Snapshot takeSnapshot();
+
+    /**
+     * Restores state captured by takeSnapshot().
+     *
+     * @param snapshot Snapshot of graphics.
+     */
+    void restoreSnapshot(const Snapshot& snapshot);
+
 private:
     static constexpr u16 PIXELS_PER_BYTE = 2;
     static constexpr u16 BITS_PER_PIXEL = 4;
@@ -60,6 +88,8 @@ private:
     std::vector<u8> buffer;
     Palette palette;
     Registers registers;
+    std::shared_ptr<const std::vector<u8>> snapshotBuffer;  // Buffer of snapshot taken or restored last
+    bool bufferModified;    // Buffer has been drawn into since the last snapshot
 
     static Logger LOG;
 };
\ No newline at end of file
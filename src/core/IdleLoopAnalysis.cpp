@@ -0,0 +1,134 @@
+#include "IdleLoopAnalysis.hpp"
+
+bool IdleLoopAnalysis::isIdleLoop(const std::vector<std::pair<u16, u16>>& instructions)
+{
+    if (instructions.empty() || instructions.size() > MAX_LOOP_INSTRUCTIONS
+        || !isClosingJump(instructions.back().first))
+        return false;
+
+    u16 writtenRegisters = 0;
+    u16 carriedRegisters = 0;   // Read before being written within the iteration
+    u8 writtenFlags = 0;
+    u8 carriedFlags = 0;
+    for (auto i = 0u; i < instructions.size(); i++)
+    {
+        const auto opcode = instructions[i].first;
+        const auto operation = InstructionSet::describe(opcode >> 8).operation;
+        // Iteration executes the whole body when only the closing jump may change program counter
+        if (i + 1 < instructions.size() && InstructionSet::endsBasicBlock(operation))
+            return false;
+
+        u16 read = 0;
+        u16 written = 0;
+        if (!findAccessedRegisters(opcode, instructions[i].second, read, written))
+            return false;
+
+        carriedRegisters |= read & ~writtenRegisters;
+        writtenRegisters |= written;
+        carriedFlags |= InstructionSet::flagsRead(operation) & ~writtenFlags;
+        writtenFlags |= InstructionSet::flagsWritten(operation);
+    }
+
+    // Value carried from previous iteration has to be invariant
+    return (carriedRegisters & writtenRegisters) == 0 && (carriedFlags & writtenFlags) == 0;
+}
+
+bool IdleLoopAnalysis::findAccessedRegisters(u16 opcode, u16 operand, u16& read, u16& written)
+{
+    const u16 x = 1 << (opcode & 0xF);
+    const u16 y = 1 << ((opcode >> 4) & 0xF);
+    const u16 z = 1 << ((operand >> 8) & 0xF);
+    switch (InstructionSet::describe(opcode >> 8).operation)
+    {
+    case Operation::NOP:
+    case Operation::JUMP:
+    case Operation::JUMP_CARRY:
+    case Operation::JUMP_CONDITIONALLY:
+        break;
+    case Operation::JUMP_REGS_EQUAL:
+    case Operation::COMPARE_REGISTER:
+    case Operation::BITWISE_TEST_REGISTER:
+        read = x | y;
+        break;
+    case Operation::COMPARE_IMMEDIATE:
+    case Operation::BITWISE_TEST_IMMEDIATE:
+        read = x;
+        break;
+    case Operation::LOAD_REGISTER_IMMEDIATE:
+    case Operation::LOAD_REGISTER_INDIRECT:
+    case Operation::NOT_IMMEDIATE:
+    case Operation::NEG_IMMEDIATE:
+        written = x;
+        break;
+    case Operation::LOAD_REGISTER_INDEXED:
+    case Operation::MOVE_REGISTER:
+    case Operation::NOT_REGISTER_INDIRECT:
+    case Operation::NEG_REGISTER_INDIRECT:
+        read = y;
+        written = x;
+        break;
+    case Operation::ADD_IMMEDIATE:
+    case Operation::SUBTRACT_IMMEDIATE:
+    case Operation::BITWISE_AND_IMMEDIATE:
+    case Operation::BITWISE_OR_IMMEDIATE:
+    case Operation::BITWISE_XOR_IMMEDIATE:
+    case Operation::MULTIPLY_IMMEDIATE:
+    case Operation::DIVIDE_IMMEDIATE:
+    case Operation::MODULO_IMMEDIATE:
+    case Operation::REMAINDER_IMMEDIATE:
+    case Operation::LOGICAL_SHIFT_LEFT_IMMEDIATE:
+    case Operation::LOGICAL_SHIFT_RIGHT_IMMEDIATE:
+    case Operation::ARITHMETIC_SHIFT_RIGHT_IMMEDIATE:
+    case Operation::NOT_REGISTER:
+    case Operation::NEG_REGISTER:
+        read = x;
+        written = x;
+        break;
+    case Operation::ADD_REGISTER:
+    case Operation::SUBTRACT_REGISTER:
+    case Operation::BITWISE_AND_REGISTER:
+    case Operation::BITWISE_OR_REGISTER:
+    case Operation::BITWISE_XOR_REGISTER:
+    case Operation::MULTIPLY_REGISTER:
+    case Operation::DIVIDE_REGISTER:
+    case Operation::MODULO_REGISTER:
+    case Operation::REMAINDER_REGISTER:
+    case Operation::LOGICAL_SHIFT_LEFT_INDIRECT:
+    case Operation::LOGICAL_SHIFT_RIGHT_INDIRECT:
+    case Operation::ARITHMETIC_SHIFT_RIGHT_INDIRECT:
+        read = x | y;
+        written = x;
+        break;
+    case Operation::ADD_REGISTERS:
+    case Operation::SUBTRACT_REGISTERS:
+    case Operation::BITWISE_AND_REGISTERS:
+    case Operation::BITWISE_OR_REGISTERS:
+    case Operation::BITWISE_XOR_REGISTERS:
+    case Operation::MULTIPLY_REGISTERS:
+    case Operation::DIVIDE_REGISTERS:
+    case Operation::MODULO_REGISTERS:
+    case Operation::REMAINDER_REGISTERS:
+        read = x | y;
+        written = z;
+        break;
+    default:
+        // Instruction with side effects or reading state changed by the loop itself
+        return false;
+    }
+    return true;
+}
+
+bool IdleLoopAnalysis::isClosingJump(u16 opcode)
+{
+    switch (InstructionSet::describe(opcode >> 8).operation)
+    {
+    case Operation::JUMP:
+    case Operation::JUMP_CARRY:
+    case Operation::JUMP_REGS_EQUAL:
+        return true;
+    case Operation::JUMP_CONDITIONALLY:
+        return (opcode & 0xF) != 0xF;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "Types.hpp"
+#include "InstructionSet.hpp"
+
+/**
+ * Analysis of short loops polling memory, such as the controller state, until the host changes it.
+ * Loop is idle when its body consists of loads, register transfers, arithmetic and comparisons
+ * closed by a jump back to the first instruction, and every register and flag modified by the body
+ * is overwritten before being read. State after each iteration then depends only on memory
+ * that the loop does not write, so while memory is not changed all iterations are identical.
+ */
+class IdleLoopAnalysis
+{
+public:
+    static constexpr unsigned MAX_LOOP_INSTRUCTIONS = 8;
+
+    /**
+     * Checks whether the loop is idle.
+     *
+     * @param instructions Opcode and operand words of instructions from the first one
+     *        to the jump closing the loop.
+     * @return True if the loop is idle.
+     */
+    static bool isIdleLoop(const std::vector<std::pair<u16, u16>>& instructions);
+
+private:
+    static bool findAccessedRegisters(u16 opcode, u16 operand, u16& read, u16& written);
+    static bool isClosingJump(u16 opcode);
+};
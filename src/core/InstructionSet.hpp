@@ -0,0 +1,386 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "Types.hpp"
+
+enum class Operation : u8
+{
+    NOP,
+    CLEAR_SCREEN,
+    VBLNK,
+    BACKGROUND_COLOR,
+    SPRITE_DIMENSIONS,
+    DRAW_SPRITE_IMMEDIATE,
+    DRAW_SPRITE_INDIRECT,
+    RANDOM,
+    FLIP,
+    SOUND_STOP,
+    SOUND_500HZ,
+    SOUND_1000HZ,
+    SOUND_1500HZ,
+    SOUND_TONE,
+    SOUND_GENERATOR,
+    JUMP,
+    JUMP_CARRY,
+    JUMP_CONDITIONALLY,
+    JUMP_REGS_EQUAL,
+    CALL,
+    RETURN,
+    JUMP_INDIRECT,
+    CALL_CONDITIONALLY,
+    CALL_INDIRECT,
+    LOAD_REGISTER_IMMEDIATE,
+    LOAD_SP_IMMEDIATE,
+    LOAD_REGISTER_INDIRECT,
+    LOAD_REGISTER_INDEXED,
+    MOVE_REGISTER,
+    STORE_INDIRECT,
+    STORE_INDEXED,
+    ADD_IMMEDIATE,
+    ADD_REGISTER,
+    ADD_REGISTERS,
+    SUBTRACT_IMMEDIATE,
+    SUBTRACT_REGISTER,
+    SUBTRACT_REGISTERS,
+    COMPARE_IMMEDIATE,
+    COMPARE_REGISTER,
+    BITWISE_AND_IMMEDIATE,
+    BITWISE_AND_REGISTER,
+    BITWISE_AND_REGISTERS,
+    BITWISE_TEST_IMMEDIATE,
+    BITWISE_TEST_REGISTER,
+    BITWISE_OR_IMMEDIATE,
+    BITWISE_OR_REGISTER,
+    BITWISE_OR_REGISTERS,
+    BITWISE_XOR_IMMEDIATE,
+    BITWISE_XOR_REGISTER,
+    BITWISE_XOR_REGISTERS,
+    MULTIPLY_IMMEDIATE,
+    MULTIPLY_REGISTER,
+    MULTIPLY_REGISTERS,
+    DIVIDE_IMMEDIATE,
+    DIVIDE_REGISTER,
+    DIVIDE_REGISTERS,
+    MODULO_IMMEDIATE,
+    MODULO_REGISTER,
+    MODULO_REGISTERS,
+    REMAINDER_IMMEDIATE,
+    REMAINDER_REGISTER,
+    REMAINDER_REGISTERS,
+    LOGICAL_SHIFT_LEFT_IMMEDIATE,
+    LOGICAL_SHIFT_RIGHT_IMMEDIATE,
+    ARITHMETIC_SHIFT_RIGHT_IMMEDIATE,
+    LOGICAL_SHIFT_LEFT_INDIRECT,
+    LOGICAL_SHIFT_RIGHT_INDIRECT,
+    ARITHMETIC_SHIFT_RIGHT_INDIRECT,
+    PUSH,
+    POP,
+    PUSH_ALL,
+    POP_ALL,
+    PUSH_FLAGS,
+    POP_FLAGS,
+    LOAD_PALETTE_ABSOLUTE,
+    LOAD_PALETTE_INDIRECT,
+    NOT_IMMEDIATE,
+    NOT_REGISTER,
+    NOT_REGISTER_INDIRECT,
+    NEG_IMMEDIATE,
+    NEG_REGISTER,
+    NEG_REGISTER_INDIRECT,
+    INVALID
+};
+
+struct InstructionDescriptor
+{
+    Operation operation;
+    const char* mnemonic;
+    bool usesOperandWord; // True if instruction reads second word
+};
+
+/**
+ * Description of the chip16 instruction set indexed by opcode byte.
+ */
+class InstructionSet
+{
+public:
+    static constexpr std::size_t OPCODES_COUNT = 0x100;
+
+    // Masks of the flags within raw value of CpuFlags
+    static constexpr u8 CARRY_FLAG = 0x02;
+    static constexpr u8 ZERO_FLAG = 0x04;
+    static constexpr u8 OVERFLOW_FLAG = 0x40;
+    static constexpr u8 NEGATIVE_FLAG = 0x80;
+    static constexpr u8 ALL_FLAGS = CARRY_FLAG | ZERO_FLAG | OVERFLOW_FLAG | NEGATIVE_FLAG;
+
+    /**
+     * Returns description of the instruction with given opcode byte.
+     *
+     * @param opcode Opcode byte of the instruction.
+     * @return Instruction descriptor. Operation of unknown opcodes is INVALID.
+     */
+    static constexpr const InstructionDescriptor& describe(u8 opcode);
+
+    /**
+     * Checks whether operation ends basic block, that is whether it may set
+     * program counter to other address than the one of the next instruction.
+     *
+     * @param operation Operation to be checked.
+     * @return True if operation ends basic block, false otherwise.
+     */
+    static constexpr bool endsBasicBlock(Operation operation);
+
+    /**
+     * Returns flags whose values may be used by the operation.
+     * Conditional branches are assumed to read every flag regardless of condition.
+     *
+     * @param operation Operation to be checked.
+     * @return Mask of read flags.
+     */
+    static constexpr u8 flagsRead(Operation operation);
+
+    /**
+     * Returns flags always overwritten by the operation.
+     *
+     * @param operation Operation to be checked.
+     * @return Mask of written flags.
+     */
+    static constexpr u8 flagsWritten(Operation operation);
+
+    /**
+     * Checks whether operation may write into memory, which includes code that follows it.
+     *
+     * @param operation Operation to be checked.
+     * @return True if operation writes into memory, false otherwise.
+     */
+    static constexpr bool writesMemory(Operation operation);
+
+private:
+    struct Definition
+    {
+        u8 opcode;
+        InstructionDescriptor descriptor;
+    };
+
+    static constexpr Definition DEFINITIONS[] = {
+        { 0x00, { Operation::NOP,                              "NOP",     false } },
+        { 0x01, { Operation::CLEAR_SCREEN,                     "CLS",     false } },
+        { 0x02, { Operation::VBLNK,                            "VBLNK",   false } },
+        { 0x03, { Operation::BACKGROUND_COLOR,                 "BGC",     true  } },
+        { 0x04, { Operation::SPRITE_DIMENSIONS,                "SPR",     true  } },
+        { 0x05, { Operation::DRAW_SPRITE_IMMEDIATE,            "DRW",     true  } },
+        { 0x06, { Operation::DRAW_SPRITE_INDIRECT,             "DRW",     true  } },
+        { 0x07, { Operation::RANDOM,                           "RND",     true  } },
+        { 0x08, { Operation::FLIP,                             "FLIP",    true  } },
+        { 0x09, { Operation::SOUND_STOP,                       "SND0",    false } },
+        { 0x0A, { Operation::SOUND_500HZ,                      "SND1",    false } },
+        { 0x0B, { Operation::SOUND_1000HZ,                     "SND2",    false } },
+        { 0x0C, { Operation::SOUND_1500HZ,                     "SND3",    false } },
+        { 0x0D, { Operation::SOUND_TONE,                       "SNP",     false } },
+        { 0x0E, { Operation::SOUND_GENERATOR,                  "SNG",     false } },
+        { 0x10, { Operation::JUMP,                             "JMP",     true  } },
+        { 0x11, { Operation::JUMP_CARRY,                       "JMC",     true  } },
+        { 0x12, { Operation::JUMP_CONDITIONALLY,               "Jx",      true  } },
+        { 0x13, { Operation::JUMP_REGS_EQUAL,                  "JME",     true  } },
+        { 0x14, { Operation::CALL,                             "CALL",    true  } },
+        { 0x15, { Operation::RETURN,                           "RET",     false } },
+        { 0x16, { Operation::JUMP_INDIRECT,                    "JMP",     false } },
+        { 0x17, { Operation::CALL_CONDITIONALLY,               "Cx",      true  } },
+        { 0x18, { Operation::CALL_INDIRECT,                    "CALL",    false } },
+        { 0x20, { Operation::LOAD_REGISTER_IMMEDIATE,          "LDI",     true  } },
+        { 0x21, { Operation::LOAD_SP_IMMEDIATE,                "LDI",     true  } },
+        { 0x22, { Operation::LOAD_REGISTER_INDIRECT,           "LDM",     true  } },
+        { 0x23, { Operation::LOAD_REGISTER_INDEXED,            "LDM",     false } },
+        { 0x24, { Operation::MOVE_REGISTER,                    "MOV",     false } },
+        { 0x30, { Operation::STORE_INDIRECT,                   "STM",     true  } },
+        { 0x31, { Operation::STORE_INDEXED,                    "STM",     false } },
+        { 0x40, { Operation::ADD_IMMEDIATE,                    "ADDI",    true  } },
+        { 0x41, { Operation::ADD_REGISTER,                     "ADD",     false } },
+        { 0x42, { Operation::ADD_REGISTERS,                    "ADD",     true  } },
+        { 0x50, { Operation::SUBTRACT_IMMEDIATE,               "SUBI",    true  } },
+        { 0x51, { Operation::SUBTRACT_REGISTER,                "SUB",     false } },
+        { 0x52, { Operation::SUBTRACT_REGISTERS,               "SUB",     true  } },
+        { 0x53, { Operation::COMPARE_IMMEDIATE,                "CMPI",    true  } },
+        { 0x54, { Operation::COMPARE_REGISTER,                 "CMP",     false } },
+        { 0x60, { Operation::BITWISE_AND_IMMEDIATE,            "ANDI",    true  } },
+        { 0x61, { Operation::BITWISE_AND_REGISTER,             "AND",     false } },
+        { 0x62, { Operation::BITWISE_AND_REGISTERS,            "AND",     true  } },
+        { 0x63, { Operation::BITWISE_TEST_IMMEDIATE,           "TSTI",    true  } },
+        { 0x64, { Operation::BITWISE_TEST_REGISTER,            "TST",     false } },
+        { 0x70, { Operation::BITWISE_OR_IMMEDIATE,             "ORI",     true  } },
+        { 0x71, { Operation::BITWISE_OR_REGISTER,              "OR",      false } },
+        { 0x72, { Operation::BITWISE_OR_REGISTERS,             "OR",      true  } },
+        { 0x80, { Operation::BITWISE_XOR_IMMEDIATE,            "XORI",    true  } },
+        { 0x81, { Operation::BITWISE_XOR_REGISTER,             "XOR",     false } },
+        { 0x82, { Operation::BITWISE_XOR_REGISTERS,            "XOR",     true  } },
+        { 0x90, { Operation::MULTIPLY_IMMEDIATE,               "MULI",    true  } },
+        { 0x91, { Operation::MULTIPLY_REGISTER,                "MUL",     false } },
+        { 0x92, { Operation::MULTIPLY_REGISTERS,               "MUL",     true  } },
+        { 0xA0, { Operation::DIVIDE_IMMEDIATE,                 "DIVI",    true  } },
+        { 0xA1, { Operation::DIVIDE_REGISTER,                  "DIV",     false } },
+        { 0xA2, { Operation::DIVIDE_REGISTERS,                 "DIV",     true  } },
+        { 0xA3, { Operation::MODULO_IMMEDIATE,                 "MODI",    true  } },
+        { 0xA4, { Operation::MODULO_REGISTER,                  "MOD",     false } },
+        { 0xA5, { Operation::MODULO_REGISTERS,                 "MOD",     true  } },
+        { 0xA6, { Operation::REMAINDER_IMMEDIATE,              "REMI",    true  } },
+        { 0xA7, { Operation::REMAINDER_REGISTER,               "REM",     false } },
+        { 0xA8, { Operation::REMAINDER_REGISTERS,              "REM",     true  } },
+        { 0xB0, { Operation::LOGICAL_SHIFT_LEFT_IMMEDIATE,     "SHL",     true  } },
+        { 0xB1, { Operation::LOGICAL_SHIFT_RIGHT_IMMEDIATE,    "SHR",     true  } },
+        { 0xB2, { Operation::ARITHMETIC_SHIFT_RIGHT_IMMEDIATE, "SAR",     true  } },
+        { 0xB3, { Operation::LOGICAL_SHIFT_LEFT_INDIRECT,      "SHL",     false } },
+        { 0xB4, { Operation::LOGICAL_SHIFT_RIGHT_INDIRECT,     "SHR",     false } },
+        { 0xB5, { Operation::ARITHMETIC_SHIFT_RIGHT_INDIRECT,  "SAR",     false } },
+        { 0xC0, { Operation::PUSH,                             "PUSH",    false } },
+        { 0xC1, { Operation::POP,                              "POP",     false } },
+        { 0xC2, { Operation::PUSH_ALL,                         "PUSHALL", false } },
+        { 0xC3, { Operation::POP_ALL,                          "POPALL",  false } },
+        { 0xC4, { Operation::PUSH_FLAGS,                       "PUSHF",   false } },
+        { 0xC5, { Operation::POP_FLAGS,                        "POPF",    false } },
+        { 0xD0, { Operation::LOAD_PALETTE_ABSOLUTE,            "PAL",     true  } },
+        { 0xD1, { Operation::LOAD_PALETTE_INDIRECT,            "PAL",     false } },
+        { 0xE0, { Operation::NOT_IMMEDIATE,                    "NOTI",    true  } },
+        { 0xE1, { Operation::NOT_REGISTER,                     "NOT",     false } },
+        { 0xE2, { Operation::NOT_REGISTER_INDIRECT,            "NOT",     false } },
+        { 0xE3, { Operation::NEG_IMMEDIATE,                    "NEGI",    true  } },
+        { 0xE4, { Operation::NEG_REGISTER,                     "NEG",     false } },
+        { 0xE5, { Operation::NEG_REGISTER_INDIRECT,            "NEG",     false } }
+    };
+
+    static constexpr std::array<InstructionDescriptor, OPCODES_COUNT> generateDescriptorTable();
+
+    static const std::array<InstructionDescriptor, OPCODES_COUNT> DESCRIPTORS;
+};
+
+inline constexpr std::array<InstructionDescriptor, InstructionSet::OPCODES_COUNT> InstructionSet::generateDescriptorTable()
+{
+    std::array<InstructionDescriptor, OPCODES_COUNT> table{};
+    for (auto& descriptor : table)
+        descriptor = { Operation::INVALID, "???", false };
+
+    for (const auto& definition : DEFINITIONS)
+        table[definition.opcode] = definition.descriptor;
+
+    return table;
+}
+
+inline constexpr std::array<InstructionDescriptor, InstructionSet::OPCODES_COUNT> InstructionSet::DESCRIPTORS = generateDescriptorTable();
+
+inline constexpr const InstructionDescriptor& InstructionSet::describe(u8 opcode)
+{
+    return DESCRIPTORS[opcode];
+}
+
+inline constexpr bool InstructionSet::endsBasicBlock(Operation operation)
+{
+    switch (operation)
+    {
+    case Operation::VBLNK:
+    case Operation::JUMP:
+    case Operation::JUMP_CARRY:
+    case Operation::JUMP_CONDITIONALLY:
+    case Operation::JUMP_REGS_EQUAL:
+    case Operation::CALL:
+    case Operation::RETURN:
+    case Operation::JUMP_INDIRECT:
+    case Operation::CALL_CONDITIONALLY:
+    case Operation::CALL_INDIRECT:
+    case Operation::INVALID:
+        return true;
+    default:
+        return false;
+    }
+}
+
+inline constexpr u8 InstructionSet::flagsRead(Operation operation)
+{
+    switch (operation)
+    {
+    case Operation::JUMP_CARRY:
+        return CARRY_FLAG;
+    case Operation::JUMP_CONDITIONALLY:
+    case Operation::CALL_CONDITIONALLY:
+    case Operation::PUSH_FLAGS:
+        return ALL_FLAGS;
+    default:
+        return 0;
+    }
+}
+
+inline constexpr u8 InstructionSet::flagsWritten(Operation operation)
+{
+    switch (operation)
+    {
+    case Operation::DRAW_SPRITE_IMMEDIATE:
+    case Operation::DRAW_SPRITE_INDIRECT:
+        return CARRY_FLAG;
+    case Operation::ADD_IMMEDIATE:
+    case Operation::ADD_REGISTER:
+    case Operation::ADD_REGISTERS:
+    case Operation::SUBTRACT_IMMEDIATE:
+    case Operation::SUBTRACT_REGISTER:
+    case Operation::SUBTRACT_REGISTERS:
+    case Operation::COMPARE_IMMEDIATE:
+    case Operation::COMPARE_REGISTER:
+    case Operation::POP_FLAGS:
+        return ALL_FLAGS;
+    case Operation::MULTIPLY_IMMEDIATE:
+    case Operation::MULTIPLY_REGISTER:
+    case Operation::MULTIPLY_REGISTERS:
+    case Operation::DIVIDE_IMMEDIATE:
+    case Operation::DIVIDE_REGISTER:
+    case Operation::DIVIDE_REGISTERS:
+        return CARRY_FLAG | ZERO_FLAG | NEGATIVE_FLAG;
+    case Operation::BITWISE_AND_IMMEDIATE:
+    case Operation::BITWISE_AND_REGISTER:
+    case Operation::BITWISE_AND_REGISTERS:
+    case Operation::BITWISE_TEST_IMMEDIATE:
+    case Operation::BITWISE_TEST_REGISTER:
+    case Operation::BITWISE_OR_IMMEDIATE:
+    case Operation::BITWISE_OR_REGISTER:
+    case Operation::BITWISE_OR_REGISTERS:
+    case Operation::BITWISE_XOR_IMMEDIATE:
+    case Operation::BITWISE_XOR_REGISTER:
+    case Operation::BITWISE_XOR_REGISTERS:
+    case Operation::MODULO_IMMEDIATE:
+    case Operation::MODULO_REGISTER:
+    case Operation::MODULO_REGISTERS:
+    case Operation::REMAINDER_IMMEDIATE:
+    case Operation::REMAINDER_REGISTER:
+    case Operation::REMAINDER_REGISTERS:
+    case Operation::LOGICAL_SHIFT_LEFT_IMMEDIATE:
+    case Operation::LOGICAL_SHIFT_RIGHT_IMMEDIATE:
+    case Operation::ARITHMETIC_SHIFT_RIGHT_IMMEDIATE:
+    case Operation::LOGICAL_SHIFT_LEFT_INDIRECT:
+    case Operation::LOGICAL_SHIFT_RIGHT_INDIRECT:
+    case Operation::ARITHMETIC_SHIFT_RIGHT_INDIRECT:
+    case Operation::NOT_IMMEDIATE:
+    case Operation::NOT_REGISTER:
+    case Operation::NOT_REGISTER_INDIRECT:
+    case Operation::NEG_IMMEDIATE:
+    case Operation::NEG_REGISTER:
+    case Operation::NEG_REGISTER_INDIRECT:
+        return ZERO_FLAG | NEGATIVE_FLAG;
+    default:
+        return 0;
+    }
+}
+
+inline constexpr bool InstructionSet::writesMemory(Operation operation)
+{
+    switch (operation)
+    {
+    case Operation::CALL:
+    case Operation::CALL_CONDITIONALLY:
+    case Operation::CALL_INDIRECT:
+    case Operation::STORE_INDIRECT:
+    case Operation::STORE_INDEXED:
+    case Operation::PUSH:
+    case Operation::PUSH_ALL:
+    case Operation::PUSH_FLAGS:
+        return true;
+    default:
+        return false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,777 @@
+#include "JitCpuImpl.hpp"
+
+#if CHIP16_JIT_SUPPORTED
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#include "MemoryImpl.hpp"
+#include "BusImpl.hpp"
+#include "GraphicsImpl.hpp"
+#include "../utils/Crc32.hpp"
+
+Logger JitCpuImpl::LOG(STRINGIFY(JitCpuImpl));
+
+namespace
+{
+    using Reg = X86Emitter::Reg;
+    using AluOperation = X86Emitter::AluOperation;
+    using ShiftOperation = X86Emitter::ShiftOperation;
+
+    // Registers preserved across calls into interpreter
+    constexpr Reg CPU = Reg::RBX;
+    constexpr Reg REGISTERS = Reg::RBP;
+    constexpr Reg CONTEXT = Reg::R12;
+
+    constexpr int NO_DESTINATION = -1;
+
+    constexpr u8 CARRY_MASK = 0x02;
+    constexpr u8 ZERO_MASK = 0x04;
+    constexpr u8 OVERFLOW_MASK = 0x40;
+    constexpr u8 NEGATIVE_MASK = 0x80;
+
+    s32 pcOffset()
+    {
+        return offsetof(CpuRegisters, pc);
+    }
+
+    s32 spOffset()
+    {
+        return offsetof(CpuRegisters, sp);
+    }
+
+    s32 flagsOffset()
+    {
+        return offsetof(CpuRegisters, flags);
+    }
+
+    s32 registerOffset(unsigned index)
+    {
+        return offsetof(CpuRegisters, r) + index * sizeof(u16);
+    }
+
+    // Loads r[x] into EAX and second operand (immediate or r[y]) into ECX
+    void emitLoadOperands(X86Emitter& emitter, unsigned x, unsigned y, u16 immediate, bool isImmediate)
+    {
+        emitter.movzxRegMem16(Reg::RAX, REGISTERS, registerOffset(x));
+        if (isImmediate)
+            emitter.movRegImm32(Reg::RCX, immediate);
+        else
+            emitter.movzxRegMem16(Reg::RCX, REGISTERS, registerOffset(y));
+    }
+
+    void emitStoreResult(X86Emitter& emitter, int destination)
+    {
+        if (destination != NO_DESTINATION)
+            emitter.movMemReg16(REGISTERS, registerOffset(destination), Reg::RDX);
+    }
+
+    // Computes zero and negative flags of result in EDX into ESI
+    void emitZeroNegativeFlags(X86Emitter& emitter)
+    {
+        emitter.movRegReg32(Reg::RSI, Reg::RDX);
+        emitter.aluRegImm32(AluOperation::AND, Reg::RSI, 0x8000);
+        emitter.shiftRegImm32(ShiftOperation::SHR, Reg::RSI, 8);
+        emitter.testRegImm32(Reg::RDX, 0xFFFF);
+        emitter.setcc(X86Emitter::Condition::EQUAL, Reg::RDI);
+        emitter.movzxRegReg8(Reg::RDI, Reg::RDI);
+        emitter.shiftRegImm32(ShiftOperation::SHL, Reg::RDI, 2);
+        emitter.aluRegReg32(AluOperation::OR, Reg::RSI, Reg::RDI);
+    }
+
+    // Replaces flags selected by mask with bits computed in ESI
+    void emitStoreFlags(X86Emitter& emitter, u8 mask)
+    {
+        emitter.movzxRegMem8(Reg::RAX, REGISTERS, flagsOffset());
+        emitter.aluRegImm32(AluOperation::AND, Reg::RAX, static_cast<u8>(~mask));
+        emitter.aluRegReg32(AluOperation::OR, Reg::RAX, Reg::RSI);
+        emitter.movMemReg8(REGISTERS, flagsOffset(), Reg::RAX);
+    }
+
+    void emitAddition(X86Emitter& emitter, int destination, bool evaluateFlags)
+    {
+        emitter.movRegReg32(Reg::RDX, Reg::RAX);
+        emitter.aluRegReg32(AluOperation::ADD, Reg::RDX, Reg::RCX);
+        emitStoreResult(emitter, destination);
+        if (!evaluateFlags)
+            return;
+        emitZeroNegativeFlags(emitter);
+
+        // Carry out of bit 15
+        emitter.movRegReg32(Reg::RDI, Reg::RDX);
+        emitter.aluRegImm32(AluOperation::AND, Reg::RDI, 0x10000);
+        emitter.shiftRegImm32(ShiftOperation::SHR, Reg::RDI, 15);
+        emitter.aluRegReg32(AluOperation::OR, Reg::RSI, Reg::RDI);
+
+        // Overflow when operands have equal signs different from sign of the result
+        emitter.movRegReg32(Reg::RDI, Reg::RAX);
+        emitter.aluRegReg32(AluOperation::XOR, Reg::RDI, Reg::RCX);
+        emitter.notReg32(Reg::RDI);
+        emitter.aluRegReg32(AluOperation::XOR, Reg::RAX, Reg::RDX);
+        emitter.aluRegReg32(AluOperation::AND, Reg::RDI, Reg::RAX);
+        emitter.aluRegImm32(AluOperation::AND, Reg::RDI, 0x8000);
+        emitter.shiftRegImm32(ShiftOperation::SHR, Reg::RDI, 9);
+        emitter.aluRegReg32(AluOperation::OR, Reg::RSI, Reg::RDI);
+
+        emitStoreFlags(emitter, CARRY_MASK | ZERO_MASK | OVERFLOW_MASK | NEGATIVE_MASK);
+    }
+
+    void emitSubtraction(X86Emitter& emitter, int destination, bool evaluateFlags)
+    {
+        // Same as interpreter: operand1 + negate(operand2), borrow when bit 16 is clear
+        emitter.movRegReg32(Reg::RDX, Reg::RCX);
+        emitter.negReg32(Reg::RDX);
+        emitter.movzxRegReg16(Reg::RDX, Reg::RDX);
+        emitter.aluRegReg32(AluOperation::ADD, Reg::RDX, Reg::RAX);
+        emitStoreResult(emitter, destination);
+        if (!evaluateFlags)
+            return;
+        emitZeroNegativeFlags(emitter);
+
+        emitter.movRegReg32(Reg::RDI, Reg::RDX);
+        emitter.aluRegImm32(AluOperation::AND, Reg::RDI, 0x10000);
+        emitter.aluRegImm32(AluOperation::XOR, Reg::RDI, 0x10000);
+        emitter.shiftRegImm32(ShiftOperation::SHR, Reg::RDI, 15);
+        emitter.aluRegReg32(AluOperation::OR, Reg::RSI, Reg::RDI);
+
+        // Overflow when operands have different signs and sign of the result differs from first operand
+        emitter.movRegReg32(Reg::RDI, Reg::RAX);
+        emitter.aluRegReg32(AluOperation::XOR, Reg::RDI, Reg::RCX);
+        emitter.aluRegReg32(AluOperation::XOR, Reg::RAX, Reg::RDX);
+        emitter.aluRegReg32(AluOperation::AND, Reg::RDI, Reg::RAX);
+        emitter.aluRegImm32(AluOperation::AND, Reg::RDI, 0x8000);
+        emitter.shiftRegImm32(ShiftOperation::SHR, Reg::RDI, 9);
+        emitter.aluRegReg32(AluOperation::OR, Reg::RSI, Reg::RDI);
+
+        emitStoreFlags(emitter, CARRY_MASK | ZERO_MASK | OVERFLOW_MASK | NEGATIVE_MASK);
+    }
+
+    void emitBitwise(X86Emitter& emitter, AluOperation operation, int destination, bool evaluateFlags)
+    {
+        emitter.movRegReg32(Reg::RDX, Reg::RAX);
+        emitter.aluRegReg32(operation, Reg::RDX, Reg::RCX);
+        emitStoreResult(emitter, destination);
+        if (!evaluateFlags)
+            return;
+        emitZeroNegativeFlags(emitter);
+        emitStoreFlags(emitter, ZERO_MASK | NEGATIVE_MASK);
+    }
+
+    void emitShift(X86Emitter& emitter, ShiftOperation operation, unsigned x, unsigned count, bool evaluateFlags)
+    {
+        emitter.movzxRegMem16(Reg::RDX, REGISTERS, registerOffset(x));
+        emitter.shiftRegImm32(operation, Reg::RDX, count);
+        emitStoreResult(emitter, x);
+        if (!evaluateFlags)
+            return;
+        emitZeroNegativeFlags(emitter);
+        emitStoreFlags(emitter, ZERO_MASK | NEGATIVE_MASK);
+    }
+}
+
+JitCpuImpl::JitCpuImpl(const std::shared_ptr<MemoryType>& memory, const std::shared_ptr<BusType>& bus)
+    : RecompilingCpuBase(memory, bus)
+    , executableMemory(CODE_CAPACITY)
+    , blocks(0x10000)
+    , context()
+    , executingCode(false)
+    , executingBlockInvalidated(false)
+    , previousBlock(nullptr)
+    , chainedBlocksCount(0)
+    , blockEntries(0x10000)
+    , warmThreshold(DEFAULT_WARM_THRESHOLD)
+    , hotThreshold(DEFAULT_HOT_THRESHOLD)
+    , atBlockStart(true)
+    , blockTier(Tier::INTERPRETED)
+    , tierBlocks()
+    , tierCycles()
+{
+    if (std::getenv(PERF_MAP_VARIABLE) != nullptr)
+        setPerfMap(true);
+}
+
+void JitCpuImpl::step()
+{
+    executeNextBlock(1);
+}
+
+StopReason JitCpuImpl::run(unsigned maxCycles)
+{
+    startRun();
+    const auto start = cycles;
+    while (cycles - start < maxCycles)
+    {
+        if (cycles != start && isBreakpoint(registers.pc))
+            return StopReason::BREAKPOINT;
+
+        executeNextBlock(maxCycles - static_cast<unsigned>(cycles - start));
+        if (stopRequested)
+        {
+            if (stopReason == StopReason::IDLE_LOOP)
+                skipIdleLoop(start + maxCycles);
+            return stopReason;
+        }
+    }
+    return StopReason::BUDGET_EXHAUSTED;
+}
+
+void JitCpuImpl::executeNextBlock(unsigned maxCycles)
+{
+    // Blocks invalidated during previous step are no longer referenced by running code
+    retiredBlocks.clear();
+
+    if (!atBlockStart)
+    {
+        executeInstructionInTier(blockTier);
+        return;
+    }
+
+    auto* block = findBlock(registers.pc);
+    if (block == nullptr)
+    {
+        // Hot block which could not be compiled stays predecoded
+        previousBlock = nullptr;
+        blockTier = blockEntries[registers.pc] > warmThreshold ? Tier::PREDECODED : Tier::INTERPRETED;
+        executeInstructionInTier(blockTier);
+        return;
+    }
+
+    // Translated code reads and writes flags directly
+    materializeFlags();
+    const s32 budget = static_cast<s32>(std::min<unsigned>(maxCycles, std::numeric_limits<s32>::max()));
+    executingCode = true;
+    executingBlockInvalidated = false;
+    context.remainingCycles = budget;
+    context.chainedBlocks = 0;
+    block->function(this, &registers, &context);
+    executingCode = false;
+    // Block left before reaching its links is not linked to the following one
+    previousBlock = executingBlockInvalidated || stopRequested ? nullptr : context.block;
+    const auto retired = static_cast<unsigned>(static_cast<std::int64_t>(budget) - context.remainingCycles);
+    cycles += retired;
+    tierCycles[static_cast<unsigned>(Tier::COMPILED)] += retired;
+    chainedBlocksCount += context.chainedBlocks;
+}
+
+void JitCpuImpl::executeInstructionInTier(Tier tier)
+{
+    Operation operation;
+    if (tier == Tier::INTERPRETED)
+    {
+        // Instruction is fetched as code, so it does not hit read watchpoints
+        const auto word = memory->readInstruction(registers.pc);
+        registers.pc += 4;
+        cycles++;
+        executeFetchedInstruction(word);
+        operation = InstructionSet::describe((word >> 8) & 0xFF).operation;
+        tierCycles[static_cast<unsigned>(tier)]++;
+    }
+    else
+    {
+        const auto* instruction = &executeNextInstruction();
+        tierCycles[static_cast<unsigned>(tier)] += instruction->length;
+        while (instruction->next != nullptr)
+            instruction = instruction->next;
+        operation = InstructionSet::describe(instruction->opcode >> 8).operation;
+    }
+    atBlockStart = InstructionSet::endsBasicBlock(operation);
+}
+
+JitCpuImpl::CompiledBlock* JitCpuImpl::findBlock(u16 addr)
+{
+    auto* block = blocks[addr].get();
+    if (block == nullptr)
+    {
+        auto& entries = blockEntries[addr];
+        if (entries <= hotThreshold)
+            entries++;
+        if (entries == 1 && warmThreshold > 0)
+            tierBlocks[static_cast<unsigned>(Tier::INTERPRETED)]++;
+        if (entries == warmThreshold + 1 && hotThreshold > warmThreshold)
+            tierBlocks[static_cast<unsigned>(Tier::PREDECODED)]++;
+        if (entries <= hotThreshold)
+            return nullptr;
+        block = compileBlock(addr);
+    }
+
+    // Compilation may retire the previous block, chained jump must not pass over a breakpoint
+    if (previousBlock != nullptr && block != nullptr && !isBreakpoint(addr))
+    {
+        const bool fallthrough = addr == (previousBlock->endAddress & 0xFFFF);
+        const auto index = fallthrough ? FALLTHROUGH_LINK : BRANCH_LINK;
+        // Link of indirect exit keeps its first target, patching it on every miss would cost more than lookup
+        if (previousBlock->links[index].target == nullptr)
+            linkBlocks(*previousBlock, index, *block);
+    }
+    return block;
+}
+
+std::uint64_t JitCpuImpl::getChainedBlocksCount() const
+{
+    return chainedBlocksCount;
+}
+
+void JitCpuImpl::setTierThresholds(unsigned warmThreshold, unsigned hotThreshold)
+{
+    this->warmThreshold = warmThreshold;
+    this->hotThreshold = std::max(warmThreshold, hotThreshold);
+}
+
+std::vector<JitCpuImpl::TierStatistics> JitCpuImpl::getTierStatistics() const
+{
+    static constexpr const char* NAMES[TIERS_COUNT] = { "interpreted", "predecoded", "compiled" };
+    std::vector<TierStatistics> statistics;
+    for (auto i = 0u; i < TIERS_COUNT; i++)
+        statistics.push_back(TierStatistics{ NAMES[i], tierBlocks[i], tierCycles[i] });
+    return statistics;
+}
+
+bool JitCpuImpl::setPerfMap(bool enabled, const std::string& path)
+{
+    if (!enabled)
+    {
+        perfMap.close();
+        return true;
+    }
+    return perfMap.open(path);
+}
+
+void JitCpuImpl::onMemoryWrite(u16 addr, unsigned size)
+{
+    RecompilingCpuBase::onMemoryWrite(addr, size);
+
+    if (size >= 0x10000)
+    {
+        retireAllBlocks();
+        return;
+    }
+
+    const u32 end = addr + size;
+    for (u32 page = addr >> PAGE_SHIFT; page <= ((end - 1) >> PAGE_SHIFT); page++)
+    {
+        const auto& starts = pageBlocks[page % PAGES_COUNT];
+        for (auto it = starts.begin(); it != starts.end();)
+        {
+            const auto& block = *blocks[*it];
+            const bool overlaps = block.startAddress < end && addr < block.endAddress;
+            if (overlaps)
+            {
+                // Retiring removes the block from the list being iterated
+                retireBlock(block.startAddress);
+                it = starts.begin();
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+std::vector<CachedBlock> JitCpuImpl::exportCode() const
+{
+    std::vector<CachedBlock> exported;
+    for (const auto& block : blocks)
+    {
+        if (block == nullptr)
+            continue;
+
+        // Code is read by reference, so it does not hit read watchpoints
+        const auto size = block->endAddress - block->startAddress;
+        const auto* code = memory->readByteReference(block->startAddress);
+        exported.push_back(CachedBlock{ block->startAddress, static_cast<u16>(size),
+            static_cast<u32>(Crc32::checksum(code, code + size)) });
+    }
+    return exported;
+}
+
+unsigned JitCpuImpl::importCode(const std::vector<CachedBlock>& blocks)
+{
+    unsigned imported = 0;
+    for (const auto& block : blocks)
+    {
+        if (!matchesMemory(block))
+            continue;
+
+        // Block stays hot if it is retired and entered again
+        blockEntries[block.startAddress] = hotThreshold + 1;
+        if (this->blocks[block.startAddress] != nullptr || compileBlock(block.startAddress) != nullptr)
+            imported++;
+    }
+    return imported;
+}
+
+void JitCpuImpl::restoreSnapshot(const Snapshot& snapshot)
+{
+    RecompilingCpuBase::restoreSnapshot(snapshot);
+    // Restored program counter does not follow the previously executed block
+    atBlockStart = true;
+    previousBlock = nullptr;
+}
+
+JitCpuImpl::CompiledBlock* JitCpuImpl::compileBlock(u16 addr)
+{
+    if (!executableMemory.isValid())
+        return nullptr;
+
+    LOG.debug("Compiling block at address ", logHex(addr));
+    auto block = std::make_unique<CompiledBlock>();
+    block->startAddress = addr;
+
+    u32 current = addr;
+    while (block->instructions.size() < MAX_BLOCK_INSTRUCTIONS && current + 4 <= 0x10000)
+    {
+        // Instruction with breakpoint starts its own block
+        if (current != addr && isBreakpoint(current))
+            break;
+
+        block->instructions.push_back(decodeInstruction(memory->readInstruction(current)));
+        current += 4;
+        if (InstructionSet::endsBasicBlock(InstructionSet::describe(block->instructions.back().opcode >> 8).operation))
+            break;
+    }
+    block->endAddress = current;
+    memory->markCode(addr, current - addr);
+    // Block containing the whole idle loop is retired whenever the loop is modified
+    if (!block->instructions.empty() && block->instructions.back().immediate >= addr)
+        detectIdleLoop(current - 4, block->instructions.back());
+    eliminateDeadFlags(block->instructions);
+
+    if (block->instructions.empty() || !translateBlock(*block))
+        return nullptr;
+
+    for (u32 page = addr >> PAGE_SHIFT; page <= ((block->endAddress - 1) >> PAGE_SHIFT); page++)
+        pageBlocks[page].push_back(addr);
+
+    tierBlocks[static_cast<unsigned>(Tier::COMPILED)]++;
+    blocks[addr] = std::move(block);
+    return blocks[addr].get();
+}
+
+bool JitCpuImpl::translateBlock(CompiledBlock& block)
+{
+    X86Emitter emitter;
+    const auto exitLabel = emitter.createLabel();
+
+    // Three pushes keep stack aligned to 16 bytes for calls into interpreter
+    emitter.push(CPU);
+    emitter.push(REGISTERS);
+    emitter.push(CONTEXT);
+    emitter.movRegReg64(CPU, Reg::RDI);
+    emitter.movRegReg64(REGISTERS, Reg::RSI);
+    emitter.movRegReg64(CONTEXT, Reg::RDX);
+
+    // Chained jumps from other blocks enter here with registers already set up
+    const auto bodyOffset = emitter.getSize();
+    emitter.movRegImm64(Reg::RAX, reinterpret_cast<std::uint64_t>(&block));
+    emitter.movMemReg64(CONTEXT, offsetof(ExecutionContext, block), Reg::RAX);
+
+    u16 addr = block.startAddress;
+    bool pcUpdated = false;
+    unsigned unchargedInstructions = 0;
+    for (const auto& instruction : block.instructions)
+    {
+        unchargedInstructions++;
+        pcUpdated = !translateInstruction(emitter, instruction);
+        if (pcUpdated)
+        {
+            // Interpreted instruction may leave the block, so it is charged together with the preceding ones
+            emitRetiredInstructions(emitter, unchargedInstructions);
+            unchargedInstructions = 0;
+            emitInterpreterCall(emitter, instruction, addr, exitLabel);
+        }
+        else if (deadFlagsCrossCheck)
+        {
+            emitDeadFlagsCheck(emitter, instruction);
+        }
+        addr += 4;
+    }
+
+    if (unchargedInstructions != 0)
+        emitRetiredInstructions(emitter, unchargedInstructions);
+    if (!pcUpdated)
+        emitter.movMemImm16(REGISTERS, pcOffset(), static_cast<u16>(block.endAddress));
+    emitLinks(emitter, block, exitLabel);
+
+    emitter.bind(exitLabel);
+    emitter.pop(CONTEXT);
+    emitter.pop(REGISTERS);
+    emitter.pop(CPU);
+    emitter.ret();
+
+    auto code = executableMemory.write(emitter.getCode());
+    if (code == nullptr)
+    {
+        LOG.debug("Executable memory is full, discarding all compiled blocks");
+        retireAllBlocks();
+        executableMemory.reset();
+        code = executableMemory.write(emitter.getCode());
+        if (code == nullptr)
+            return false;
+    }
+
+    block.function = reinterpret_cast<BlockFunction>(const_cast<void*>(code));
+    block.body = static_cast<const u8*>(code) + bodyOffset;
+    if (perfMap.isOpen())
+    {
+        // Symbols of blocks discarded by reset of the arena stay in the map, their addresses are reused
+        char name[32];
+        std::snprintf(name, sizeof(name), "chip16_block_%04x_%04x", block.startAddress, unsigned(block.endAddress));
+        perfMap.addSymbol(code, emitter.getCode().size(), name);
+    }
+    return true;
+}
+
+bool JitCpuImpl::translateInstruction(X86Emitter& emitter, const DecodedInstruction& instruction)
+{
+    const auto x = instruction.x;
+    const auto y = instruction.y;
+    const auto z = instruction.z;
+    const auto immediate = instruction.immediate;
+    const auto evaluateFlags = instruction.evaluateFlags;
+
+    switch (InstructionSet::describe(instruction.opcode >> 8).operation)
+    {
+    case Operation::NOP:
+        return true;
+    case Operation::LOAD_REGISTER_IMMEDIATE:
+        emitter.movMemImm16(REGISTERS, registerOffset(x), immediate);
+        return true;
+    case Operation::LOAD_SP_IMMEDIATE:
+        emitter.movMemImm16(REGISTERS, spOffset(), immediate);
+        return true;
+    case Operation::MOVE_REGISTER:
+        emitter.movzxRegMem16(Reg::RAX, REGISTERS, registerOffset(y));
+        emitter.movMemReg16(REGISTERS, registerOffset(x), Reg::RAX);
+        return true;
+
+    case Operation::ADD_IMMEDIATE:
+        emitLoadOperands(emitter, x, y, immediate, true);
+        emitAddition(emitter, x, evaluateFlags);
+        return true;
+    case Operation::ADD_REGISTER:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitAddition(emitter, x, evaluateFlags);
+        return true;
+    case Operation::ADD_REGISTERS:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitAddition(emitter, z, evaluateFlags);
+        return true;
+
+    case Operation::SUBTRACT_IMMEDIATE:
+        emitLoadOperands(emitter, x, y, immediate, true);
+        emitSubtraction(emitter, x, evaluateFlags);
+        return true;
+    case Operation::SUBTRACT_REGISTER:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitSubtraction(emitter, x, evaluateFlags);
+        return true;
+    case Operation::SUBTRACT_REGISTERS:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitSubtraction(emitter, z, evaluateFlags);
+        return true;
+    case Operation::COMPARE_IMMEDIATE:
+        emitLoadOperands(emitter, x, y, immediate, true);
+        emitSubtraction(emitter, NO_DESTINATION, evaluateFlags);
+        return true;
+    case Operation::COMPARE_REGISTER:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitSubtraction(emitter, NO_DESTINATION, evaluateFlags);
+        return true;
+
+    case Operation::BITWISE_AND_IMMEDIATE:
+        emitLoadOperands(emitter, x, y, immediate, true);
+        emitBitwise(emitter, AluOperation::AND, x, evaluateFlags);
+        return true;
+    case Operation::BITWISE_AND_REGISTER:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitBitwise(emitter, AluOperation::AND, x, evaluateFlags);
+        return true;
+    case Operation::BITWISE_AND_REGISTERS:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitBitwise(emitter, AluOperation::AND, z, evaluateFlags);
+        return true;
+    case Operation::BITWISE_TEST_IMMEDIATE:
+        emitLoadOperands(emitter, x, y, immediate, true);
+        emitBitwise(emitter, AluOperation::AND, NO_DESTINATION, evaluateFlags);
+        return true;
+    case Operation::BITWISE_TEST_REGISTER:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitBitwise(emitter, AluOperation::AND, NO_DESTINATION, evaluateFlags);
+        return true;
+    case Operation::BITWISE_OR_IMMEDIATE:
+        emitLoadOperands(emitter, x, y, immediate, true);
+        emitBitwise(emitter, AluOperation::OR, x, evaluateFlags);
+        return true;
+    case Operation::BITWISE_OR_REGISTER:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitBitwise(emitter, AluOperation::OR, x, evaluateFlags);
+        return true;
+    case Operation::BITWISE_OR_REGISTERS:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitBitwise(emitter, AluOperation::OR, z, evaluateFlags);
+        return true;
+    case Operation::BITWISE_XOR_IMMEDIATE:
+        emitLoadOperands(emitter, x, y, immediate, true);
+        emitBitwise(emitter, AluOperation::XOR, x, evaluateFlags);
+        return true;
+    case Operation::BITWISE_XOR_REGISTER:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitBitwise(emitter, AluOperation::XOR, x, evaluateFlags);
+        return true;
+    case Operation::BITWISE_XOR_REGISTERS:
+        emitLoadOperands(emitter, x, y, immediate, false);
+        emitBitwise(emitter, AluOperation::XOR, z, evaluateFlags);
+        return true;
+
+    case Operation::LOGICAL_SHIFT_LEFT_IMMEDIATE:
+        emitShift(emitter, ShiftOperation::SHL, x, z, evaluateFlags);
+        return true;
+    case Operation::LOGICAL_SHIFT_RIGHT_IMMEDIATE:
+        emitShift(emitter, ShiftOperation::SHR, x, z, evaluateFlags);
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void JitCpuImpl::emitInterpreterCall(X86Emitter& emitter, const DecodedInstruction& instruction, u16 addr,
+    X86Emitter::Label exitLabel)
+{
+    // Handlers expect program counter to point past the instruction
+    emitter.movMemImm16(REGISTERS, pcOffset(), addr + 4);
+    emitter.movRegReg64(Reg::RDI, CPU);
+    emitter.movRegImm64(Reg::RSI, reinterpret_cast<std::uint64_t>(&instruction));
+    emitter.movRegImm64(Reg::RAX, reinterpret_cast<std::uint64_t>(&JitCpuImpl::executeInterpretedInstruction));
+    emitter.callReg(Reg::RAX);
+
+    // Leave the block if executed instruction has overwritten it or stopped the cpu
+    emitter.testRegReg8(Reg::RAX, Reg::RAX);
+    emitter.jcc(X86Emitter::Condition::NOT_EQUAL, exitLabel);
+}
+
+void JitCpuImpl::emitRetiredInstructions(X86Emitter& emitter, unsigned count)
+{
+    emitter.aluMemImm32(AluOperation::SUB, CONTEXT, offsetof(ExecutionContext, remainingCycles), count);
+}
+
+void JitCpuImpl::emitLinks(X86Emitter& emitter, CompiledBlock& block, X86Emitter::Label exitLabel)
+{
+    // Interpreted instructions requesting stop leave the block before its links,
+    // so only the remaining cycles are checked before entering the successor
+    emitter.aluMemImm32(AluOperation::CMP, CONTEXT, offsetof(ExecutionContext, remainingCycles), 0);
+    emitter.jcc(X86Emitter::Condition::LESS_EQUAL, exitLabel);
+    emitter.movzxRegMem16(Reg::RAX, REGISTERS, pcOffset());
+
+    // Address compared with program counter and target of the jump are patched by linkBlocks()
+    for (auto& link : block.links)
+    {
+        const auto nextLabel = emitter.createLabel();
+        emitter.aluRegImm32(AluOperation::CMP, Reg::RAX, UNLINKED_ADDRESS);
+        link.addressOffset = emitter.getSize() - 4;
+        emitter.jcc(X86Emitter::Condition::NOT_EQUAL, nextLabel);
+        emitter.aluMemImm32(AluOperation::ADD, CONTEXT, offsetof(ExecutionContext, chainedBlocks), 1);
+        emitter.jmp(exitLabel);
+        link.jumpOffset = emitter.getSize() - 4;
+        link.target = nullptr;
+        emitter.bind(nextLabel);
+    }
+}
+
+void JitCpuImpl::linkBlocks(CompiledBlock& source, unsigned index, CompiledBlock& target)
+{
+    auto& link = source.links[index];
+    const auto* code = reinterpret_cast<const u8*>(source.function);
+    const u32 address = target.startAddress;
+    const auto displacement = static_cast<u32>(target.body - (code + link.jumpOffset + 4));
+
+    // Both fields are written at once, so protection of the code is changed only twice
+    std::vector<u8> bytes(code + link.addressOffset, code + link.jumpOffset + 4);
+    std::memcpy(bytes.data(), &address, sizeof(address));
+    std::memcpy(bytes.data() + bytes.size() - 4, &displacement, sizeof(displacement));
+    if (!executableMemory.patch(code + link.addressOffset, bytes.data(), bytes.size()))
+        return;
+
+    link.target = &target;
+    target.incomingLinks.push_back(IncomingLink{ &source, index });
+}
+
+void JitCpuImpl::unlinkBlock(CompiledBlock& source, unsigned index)
+{
+    auto& link = source.links[index];
+    const auto* code = reinterpret_cast<const u8*>(source.function);
+    executableMemory.patch(code + link.addressOffset, &UNLINKED_ADDRESS, sizeof(UNLINKED_ADDRESS));
+    link.target = nullptr;
+}
+
+void JitCpuImpl::emitDeadFlagsCheck(X86Emitter& emitter, const DecodedInstruction& instruction)
+{
+    emitter.movRegReg64(Reg::RDI, CPU);
+    emitter.movRegImm64(Reg::RSI, reinterpret_cast<std::uint64_t>(&instruction));
+    emitter.movRegImm64(Reg::RAX, reinterpret_cast<std::uint64_t>(&JitCpuImpl::checkTranslatedInstruction));
+    emitter.callReg(Reg::RAX);
+}
+
+void JitCpuImpl::retireBlock(u16 startAddress)
+{
+    auto& block = blocks[startAddress];
+    if (executingCode && block.get() == context.block)
+        executingBlockInvalidated = true;
+    if (block.get() == previousBlock)
+        previousBlock = nullptr;
+
+    // Blocks jumping into the retired one return into the dispatcher instead
+    for (const auto& incoming : block->incomingLinks)
+        unlinkBlock(*incoming.source, incoming.index);
+    for (const auto& link : block->links)
+    {
+        if (link.target == nullptr)
+            continue;
+        auto& incomingLinks = link.target->incomingLinks;
+        incomingLinks.erase(std::remove_if(incomingLinks.begin(), incomingLinks.end(),
+            [&block](const IncomingLink& incoming) { return incoming.source == block.get(); }), incomingLinks.end());
+    }
+
+    for (u32 page = startAddress >> PAGE_SHIFT; page <= ((block->endAddress - 1) >> PAGE_SHIFT); page++)
+    {
+        auto& starts = pageBlocks[page];
+        starts.erase(std::remove(starts.begin(), starts.end(), startAddress), starts.end());
+    }
+    retiredBlocks.push_back(std::move(block));
+}
+
+void JitCpuImpl::retireAllBlocks()
+{
+    // Retired blocks are never entered again, so jumps between them are left patched
+    previousBlock = nullptr;
+    for (auto& starts : pageBlocks)
+        starts.clear();
+
+    for (auto& block : blocks)
+    {
+        if (!block)
+            continue;
+        if (executingCode && block.get() == context.block)
+            executingBlockInvalidated = true;
+        retiredBlocks.push_back(std::move(block));
+    }
+}
+
+void JitCpuImpl::checkTranslatedInstruction(JitCpuImpl* cpu, const DecodedInstruction* instruction)
+{
+    cpu->checkDeadFlags(*instruction);
+}
+
+bool JitCpuImpl::executeInterpretedInstruction(JitCpuImpl* cpu, const DecodedInstruction* instruction)
+{
+    cpu->executeDecodedInstruction(*instruction);
+    cpu->materializeFlags();
+    return cpu->executingBlockInvalidated || cpu->stopRequested;
+}
+
+#endif
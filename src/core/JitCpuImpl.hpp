@@ -0,0 +1,197 @@
+#pragma once
+
+#include "ExecutableMemory.hpp"
+
+#if CHIP16_JIT_SUPPORTED
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CpuImpl.hpp"
+#include "X86Emitter.hpp"
+#include "PerfMap.hpp"
+
+/**
+ * Cpu translating basic blocks of chip16 code into native x86-64 code.
+ * Block ends at the first instruction that may change program counter in other way than advancing it.
+ * Arithmetic, logical and register transfer instructions are translated into native code,
+ * remaining instructions are executed by calls into interpreter handlers inherited from RecompilingCpuBase.
+ * Exits of each block are patched to jump straight into the successor blocks while cycles remain,
+ * so chained blocks run without returning into the dispatcher.
+ * Blocks are compiled only once they are hot, cold code is interpreted, see setTierThresholds().
+ */
+class JitCpuImpl : public RecompilingCpuBase
+{
+public:
+    JitCpuImpl(const std::shared_ptr<MemoryType>& memory, const std::shared_ptr<BusType>& bus);
+
+    ~JitCpuImpl() = default;
+
+    void step() override;
+
+    StopReason run(unsigned maxCycles) override;
+
+    void onMemoryWrite(u16 addr, unsigned size) override;
+
+    /**
+     * Returns compiled blocks, code executed only by lower tiers is not exported.
+     */
+    std::vector<CachedBlock> exportCode() const override;
+
+    /**
+     * Compiles given blocks without waiting for them to become hot.
+     */
+    unsigned importCode(const std::vector<CachedBlock>& blocks) override;
+
+    void restoreSnapshot(const Snapshot& snapshot) override;
+
+    /**
+     * Returns number of blocks entered by jump from the previously executed block
+     * instead of lookup by program counter.
+     *
+     * @return Number of chained block entries.
+     */
+    std::uint64_t getChainedBlocksCount() const;
+
+    enum class Tier : u8
+    {
+        INTERPRETED,    // Instructions are decoded on every execution
+        PREDECODED,     // Instructions are executed from the decode cache
+        COMPILED,       // Block is executed as native code
+        COUNT
+    };
+
+    struct TierStatistics
+    {
+        const char* name;
+        std::uint64_t blocks;   // Number of blocks promoted into the tier
+        std::uint64_t cycles;   // Number of instructions executed in the tier
+    };
+
+    /**
+     * Sets number of entries into block after which it is promoted into faster tier.
+     * Block is interpreted during its first warmThreshold entries, then executed from the decode cache
+     * until it has been entered hotThreshold times, and compiled afterwards.
+     * Instructions following start of the block are executed in the tier selected at its start.
+     *
+     * @param warmThreshold Number of interpreted entries.
+     * @param hotThreshold Number of entries preceding compilation.
+     */
+    void setTierThresholds(unsigned warmThreshold, unsigned hotThreshold);
+
+    /**
+     * Returns promotions and executed instructions of each tier.
+     *
+     * @return Statistics indexed by Tier.
+     */
+    std::vector<TierStatistics> getTierStatistics() const;
+
+    /**
+     * Writes symbol naming chip16 address range of every block compiled afterwards into perf map,
+     * so perf top and perf report attribute samples in compiled code to the guest code.
+     * Enabled on construction if environment variable CHIP16_PERF_MAP is set,
+     * which allows to profile headless runs without changing the code creating the cpu.
+     *
+     * @param enabled True to write symbols.
+     * @param path Path of the map file.
+     * @return False if the map file could not be created.
+     */
+    bool setPerfMap(bool enabled, const std::string& path = PerfMap::getDefaultPath());
+
+private:
+    struct CompiledBlock;
+
+    // State shared with compiled code
+    struct ExecutionContext
+    {
+        // Decreased by instructions executed by compiled code,
+        // blocks are chained only while it stays positive
+        s32 remainingCycles;
+        u32 chainedBlocks;
+        CompiledBlock* block;   // Block being executed, stored on entry into its body
+    };
+
+    using BlockFunction = void (*)(JitCpuImpl* cpu, CpuRegisters* registers, ExecutionContext* context);
+
+    struct BlockLink
+    {
+        CompiledBlock* target;      // Block entered by the jump or nullptr if jump is not patched
+        std::size_t addressOffset;  // Offset of compared program counter in the block code
+        std::size_t jumpOffset;     // Offset of displacement of the jump in the block code
+    };
+
+    struct IncomingLink
+    {
+        CompiledBlock* source;
+        unsigned index;
+    };
+
+    struct CompiledBlock
+    {
+        BlockFunction function;
+        const u8* body;     // Code following the prologue, entered by chained jumps
+        u16 startAddress;
+        u32 endAddress;     // Address following the last instruction of the block
+        std::vector<DecodedInstruction> instructions;
+        // Successor following the block and successor at the branch target, which caches
+        // the first target of RET, JMP Rx and CALL Rx
+        std::array<BlockLink, 2> links;
+        std::vector<IncomingLink> incomingLinks;
+    };
+
+    void executeNextBlock(unsigned maxCycles);
+    void executeInstructionInTier(Tier tier);
+    CompiledBlock* findBlock(u16 addr);
+    CompiledBlock* compileBlock(u16 addr);
+    bool translateBlock(CompiledBlock& block);
+    bool translateInstruction(X86Emitter& emitter, const DecodedInstruction& instruction);
+    void emitInterpreterCall(X86Emitter& emitter, const DecodedInstruction& instruction, u16 addr, X86Emitter::Label exitLabel);
+    void emitDeadFlagsCheck(X86Emitter& emitter, const DecodedInstruction& instruction);
+    void emitRetiredInstructions(X86Emitter& emitter, unsigned count);
+    void emitLinks(X86Emitter& emitter, CompiledBlock& block, X86Emitter::Label exitLabel);
+
+    void linkBlocks(CompiledBlock& source, unsigned index, CompiledBlock& target);
+    void unlinkBlock(CompiledBlock& source, unsigned index);
+
+    void retireBlock(u16 startAddress);
+    void retireAllBlocks();
+
+    static bool executeInterpretedInstruction(JitCpuImpl* cpu, const DecodedInstruction* instruction);
+    static void checkTranslatedInstruction(JitCpuImpl* cpu, const DecodedInstruction* instruction);
+
+    static constexpr std::size_t CODE_CAPACITY = 16 * 1024 * 1024;
+    static constexpr unsigned MAX_BLOCK_INSTRUCTIONS = 64;
+    static constexpr unsigned PAGE_SHIFT = 8;
+    static constexpr unsigned PAGES_COUNT = 0x10000 >> PAGE_SHIFT;
+    static constexpr unsigned FALLTHROUGH_LINK = 0;
+    static constexpr unsigned BRANCH_LINK = 1;
+    static constexpr u32 UNLINKED_ADDRESS = 0xFFFFFFFF;     // Never equal to 16-bit program counter
+    static constexpr unsigned TIERS_COUNT = static_cast<unsigned>(Tier::COUNT);
+    static constexpr unsigned DEFAULT_WARM_THRESHOLD = 2;
+    static constexpr unsigned DEFAULT_HOT_THRESHOLD = 32;
+    static constexpr const char* PERF_MAP_VARIABLE = "CHIP16_PERF_MAP";
+
+    ExecutableMemory executableMemory;
+    std::vector<std::unique_ptr<CompiledBlock>> blocks;
+    std::array<std::vector<u16>, PAGES_COUNT> pageBlocks;
+    std::vector<std::unique_ptr<CompiledBlock>> retiredBlocks;
+    ExecutionContext context;
+    bool executingCode;
+    bool executingBlockInvalidated;
+    CompiledBlock* previousBlock;
+    std::uint64_t chainedBlocksCount;
+    std::vector<unsigned> blockEntries;
+    unsigned warmThreshold;
+    unsigned hotThreshold;
+    bool atBlockStart;
+    Tier blockTier;     // Tier of interpreted block being executed
+    std::array<std::uint64_t, TIERS_COUNT> tierBlocks;
+    std::array<std::uint64_t, TIERS_COUNT> tierCycles;
+    PerfMap perfMap;
+
+    static Logger LOG;
+};
+
+#endif
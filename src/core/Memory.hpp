@@ -1,9 +1,11 @@
 #pragma once
 
+#include <cstddef>
 #include <vector>
 #include <istream>
 #include "Types.hpp"
 #include "ControllerState.hpp"
+#include "MemoryWriteObserver.hpp"
 
 class Memory
 {
@@ -42,6 +44,35 @@ public:
      */
     virtual void writeWord(u16 addr, u16 word) = 0;
 
+    /**
+     * Reads whole instruction from memory at given address.
+     * Instruction at the end of memory wraps around to its beginning.
+     *
+     * @param addr Address of the instruction.
+     * @return Opcode word in lower half and operand word in upper half.
+     */
+    virtual u32 readInstruction(u16 addr) const = 0;
+
+    /**
+     * Reads contiguous block of bytes from memory starting at given address.
+     * Block crossing the end of memory wraps around to its beginning.
+     *
+     * @param addr Address of the first byte to read.
+     * @param data Buffer receiving read bytes.
+     * @param size Number of bytes to read.
+     */
+    virtual void readBytes(u16 addr, u8* data, unsigned size) const = 0;
+
+    /**
+     * Writes contiguous block of bytes into memory starting at given address.
+     * Block crossing the end of memory wraps around to its beginning.
+     *
+     * @param addr Address of the first byte to write.
+     * @param data Bytes to be written.
+     * @param size Number of bytes to write.
+     */
+    virtual void writeBytes(u16 addr, const u8* data, unsigned size) = 0;
+
     /**
      * Reads controlles state from memory.
      *
@@ -56,7 +87,7 @@ public:
      * @oaram addr Address of the memory to read reference from.
      * @return Reference to byte from memory.
      */
-    virtual std::vector<u8>::const_iterator readByteReference(u16 addr) const = 0;
+    virtual const u8* readByteReference(u16 addr) const = 0;
 
     /**
      * Loads rom in given stream into memory.
@@ -64,4 +95,30 @@ public:
      * @param is Input stream containing data to be loaded.
      */
     virtual void loadRomFromStream(std::istream& is) = 0;
+
+    /**
+     * Copies rom held in contiguous bytes into memory starting at address 0.
+     * Bytes exceeding the size of memory are ignored.
+     *
+     * @param data First byte of the rom.
+     * @param size Number of bytes of the rom.
+     */
+    virtual void loadRom(const u8* data, std::size_t size) = 0;
+
+    /**
+     * Sets observer notified about writes into memory containing code.
+     * Marked code is forgotten, since it was decoded by the previous observer.
+     *
+     * @param observer Observer to be notified or nullptr to disable notifications.
+     */
+    virtual void setWriteObserver(MemoryWriteObserver* observer) = 0;
+
+    /**
+     * Marks memory range as read by decoder of the write observer.
+     * Only writes into pages overlapping marked ranges and loading of rom are reported to the observer.
+     *
+     * @param addr Address of the first decoded byte.
+     * @param size Number of decoded bytes.
+     */
+    virtual void markCode(u16 addr, unsigned size) = 0;
 };
\ No newline at end of file
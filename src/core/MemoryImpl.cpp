@@ -1,55 +1,206 @@
 #include "MemoryImpl.hpp"
+#include "../log/HexModificator.hpp"
 
 Logger MemoryImpl::LOG(STRINGIFY(MemoryImpl));
 
 MemoryImpl::MemoryImpl()
-    : memory(0x10000)
+    : memory()
+    , writeObserver(nullptr)
+    , codePages()
+    , codeWrites()
+    , pageWriteEpochs()
+    , epoch(1)
+    , lastSnapshot()
+    , snapshotEpoch(0)
+#if defined(CHIP16_WATCHPOINTS)
+    , watchpoints()
+    , readWatchedPages()
+    , writeWatchedPages()
+#endif
 {
 }
 
-u8 MemoryImpl::readByte(u16 addr) const
+ControllerState MemoryImpl::readControllerState(unsigned index) const
 {
-    LOG.debug("Reading byte from memory at address ", logHex(addr));
-    return memory[addr];
+    if (index > 2) 
+        index = 2;
+    
+    u16 rawStateValue = readWord(0xFFF0 + index * 2);
+    ControllerState state;
+    state.raw = rawStateValue;
+    return state;
 }
 
-void MemoryImpl::writeByte(u16 addr, u8 byte)
+void MemoryImpl::loadRomFromStream(std::istream& is)
 {
-    LOG.debug("Writing byte ", logHex(byte), " into memory at address ", logHex(addr));
-    memory[addr] = byte;
+    LOG.debug("Loading ROM from stream");
+    is.read(reinterpret_cast<char*>(memory.data()), memory.size());
+    markDirty(0, MEMORY_SIZE);
+    forgetCode();
 }
 
-u16 MemoryImpl::readWord(u16 addr) const
+void MemoryImpl::loadRom(const u8* data, std::size_t size)
 {
-    return readByte(addr) + readByte(addr + 1) * 0x100;
+    LOG.debug("Loading ROM of ", size, " bytes");
+    std::memcpy(memory.data(), data, std::min<std::size_t>(size, memory.size()));
+    markDirty(0, MEMORY_SIZE);
+    forgetCode();
 }
 
-void MemoryImpl::writeWord(u16 addr, u16 word)
+void MemoryImpl::forgetCode()
 {
-    writeByte(addr, word & 0xFF);
-    writeByte(addr + 1, (word >> 8) & 0xFF);
+    // Whole memory is replaced, so nothing decoded before remains valid
+    codePages.reset();
+    if (writeObserver)
+        writeObserver->onMemoryWrite(0, memory.size());
 }
 
-ControllerState MemoryImpl::readControllerState(unsigned index) const
+void MemoryImpl::setWriteObserver(MemoryWriteObserver* observer)
 {
-    if (index > 2) 
-        index = 2;
-    
-    u16 rawStateValue = readWord(0xFFF0 + index * 2);
-    ControllerState state;
-    state.raw = rawStateValue;
-    return state;
+    writeObserver = observer;
+    codePages.reset();
 }
 
-std::vector<u8>::const_iterator MemoryImpl::readByteReference(u16 addr) const
+void MemoryImpl::markCode(u16 addr, unsigned size)
 {
-    LOG.debug("Reading reference from memory at address ", logHex(addr));
-    return memory.begin() + addr;
+    if (writeObserver == nullptr || size == 0)
+        return;
+
+    const u32 end = addr + size - 1;
+    for (u32 page = addr >> PAGE_SHIFT; page <= (end >> PAGE_SHIFT); page++)
+        codePages[page % PAGES_COUNT] = true;
 }
 
-void MemoryImpl::loadRomFromStream(std::istream& is)
+std::vector<std::pair<u16, std::uint64_t>> MemoryImpl::getCodeWriteStatistics() const
 {
-    LOG.debug("Loading ROM from stream");
-    for (auto pos = 0u; is.good(); pos++)
-        memory[pos % 0x10000] = is.get();
+    std::vector<std::pair<u16, std::uint64_t>> statistics;
+    for (auto page = 0u; page < PAGES_COUNT; page++)
+    {
+        if (codeWrites[page] != 0)
+            statistics.emplace_back(page << PAGE_SHIFT, codeWrites[page]);
+    }
+    return statistics;
+}
+
+std::uint32_t MemoryImpl::finishEpoch()
+{
+    return epoch++;
+}
+
+bool MemoryImpl::isPageDirty(u16 addr, std::uint32_t epoch) const
+{
+    return pageWriteEpochs[addr >> PAGE_SHIFT] > epoch;
+}
+
+std::vector<u16> MemoryImpl::getDirtyPages(std::uint32_t epoch) const
+{
+    std::vector<u16> pages;
+    for (auto page = 0u; page < PAGES_COUNT; page++)
+    {
+        if (pageWriteEpochs[page] > epoch)
+            pages.push_back(page << PAGE_SHIFT);
+    }
+    return pages;
+}
+
+MemoryImpl::Snapshot MemoryImpl::takeSnapshot()
+{
+    for (auto page = 0u; page < PAGES_COUNT; page++)
+    {
+        auto& saved = lastSnapshot.pages[page];
+        if (saved == nullptr || pageWriteEpochs[page] > snapshotEpoch)
+        {
+            auto copy = std::make_shared<Page>();
+            std::memcpy(copy->data(), &memory[page << PAGE_SHIFT], PAGE_SIZE);
+            saved = std::move(copy);
+        }
+    }
+    snapshotEpoch = finishEpoch();
+    return lastSnapshot;
+}
+
+void MemoryImpl::restoreSnapshot(const Snapshot& snapshot)
+{
+    for (auto page = 0u; page < PAGES_COUNT; page++)
+    {
+        const auto& saved = snapshot.pages[page];
+        // Page shared with the last snapshot and not written since then already has the content
+        const bool unchanged = saved == lastSnapshot.pages[page] && pageWriteEpochs[page] <= snapshotEpoch;
+        if (saved == nullptr || unchanged)
+            continue;
+
+        const u16 addr = page << PAGE_SHIFT;
+        std::memcpy(&memory[addr], saved->data(), PAGE_SIZE);
+        pageWriteEpochs[page] = epoch;
+        if (codePages[page])
+            notifyCodeWrite(addr, PAGE_SIZE);
+    }
+    lastSnapshot = snapshot;
+    snapshotEpoch = finishEpoch();
+}
+
+#if defined(CHIP16_WATCHPOINTS)
+void MemoryImpl::addWatchpoint(u16 addr, unsigned size, WatchAccess access)
+{
+    if (size == 0)
+        return;
+
+    watchpoints.push_back(Watchpoint{ addr, std::min(size, MEMORY_SIZE), access });
+    updateWatchedPages();
+}
+
+void MemoryImpl::removeWatchpoint(u16 addr, unsigned size)
+{
+    size = std::min(size, MEMORY_SIZE);
+    watchpoints.erase(std::remove_if(watchpoints.begin(), watchpoints.end(), [addr, size](const auto& watchpoint) {
+        return watchpoint.addr == addr && watchpoint.size == size;
+    }), watchpoints.end());
+    updateWatchedPages();
+}
+
+void MemoryImpl::updateWatchedPages()
+{
+    readWatchedPages.reset();
+    writeWatchedPages.reset();
+    for (const auto& watchpoint : watchpoints)
+    {
+        const u32 start = static_cast<u16>(watchpoint.addr - 1);
+        for (u32 page = start >> PAGE_SHIFT; page <= ((start + watchpoint.size) >> PAGE_SHIFT); page++)
+        {
+            if (static_cast<u8>(watchpoint.access) & static_cast<u8>(WatchAccess::READ))
+                readWatchedPages[page % PAGES_COUNT] = true;
+            if (static_cast<u8>(watchpoint.access) & static_cast<u8>(WatchAccess::WRITE))
+                writeWatchedPages[page % PAGES_COUNT] = true;
+        }
+    }
+}
+
+void MemoryImpl::checkWatchpoints(u16 addr, unsigned size, WatchAccess access) const
+{
+    if (writeObserver == nullptr)
+        return;
+
+    for (const auto& watchpoint : watchpoints)
+    {
+        if ((static_cast<u8>(watchpoint.access) & static_cast<u8>(access)) == 0)
+            continue;
+
+        // Either range may wrap around the end of memory
+        const bool overlaps = static_cast<u16>(addr - watchpoint.addr) < watchpoint.size
+            || static_cast<u16>(watchpoint.addr - addr) < size;
+        if (overlaps)
+        {
+            LOG.debug("Watchpoint hit at address ", logHex(addr));
+            writeObserver->onWatchpointHit(addr, access == WatchAccess::WRITE);
+            return;
+        }
+    }
+}
+#endif
+
+void MemoryImpl::notifyCodeWrite(u16 addr, unsigned size)
+{
+    LOG.debug("Write into code at address ", logHex(addr));
+    codeWrites[addr >> PAGE_SHIFT]++;
+    writeObserver->onMemoryWrite(addr, size);
 }
\ No newline at end of file
@@ -1,15 +1,49 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <memory>
 #include <vector>
 #include <utility>
 
 #include "Memory.hpp"
 #include "../log/Logger.hpp"
-#include "../log/HexModificator.hpp"
 
-class MemoryImpl : public Memory
+/**
+ * Flat 64 KiB memory stored inline in the object.
+ * Accesses are not logged, TracingMemory wraps the memory to trace them.
+ * Each page records the epoch of its last write, so consumers can visit only pages changed since their last visit.
+ * Built with CHIP16_WATCHPOINTS, accesses of watched ranges are reported to the write observer.
+ */
+class MemoryImpl final : public Memory
 {
 public:
+    static constexpr unsigned PAGE_SIZE = 0x100;
+    static constexpr unsigned PAGES_COUNT = 0x10000 / PAGE_SIZE;
+
+    using Page = std::array<u8, PAGE_SIZE>;
+
+    /**
+     * Content of memory restored by restoreSnapshot().
+     * Pages not written between snapshots are shared by them instead of being copied.
+     */
+    struct Snapshot
+    {
+        std::array<std::shared_ptr<const Page>, PAGES_COUNT> pages;
+    };
+
+#if defined(CHIP16_WATCHPOINTS)
+    enum class WatchAccess : u8
+    {
+        READ = 1,
+        WRITE = 2,
+        READ_WRITE = READ | WRITE
+    };
+#endif
+
     MemoryImpl();
 
     ~MemoryImpl() = default;
@@ -22,23 +56,283 @@ public:
 
     void writeWord(u16 addr, u16 word) override;
 
+    u32 readInstruction(u16 addr) const override;
+
+    void readBytes(u16 addr, u8* data, unsigned size) const override;
+
+    void writeBytes(u16 addr, const u8* data, unsigned size) override;
+
     ControllerState readControllerState(unsigned index) const override;
     
-    std::vector<u8>::const_iterator readByteReference(u16 addr) const override;
+    const u8* readByteReference(u16 addr) const override;
 
     void loadRomFromStream(std::istream& is) override;
 
+    void loadRom(const u8* data, std::size_t size) override;
+
+    void setWriteObserver(MemoryWriteObserver* observer) override;
+
+    void markCode(u16 addr, unsigned size) override;
+
+    /**
+     * Returns number of writes into each page containing code.
+     *
+     * @return Pairs of address of the page and number of writes reported to the observer.
+     */
+    std::vector<std::pair<u16, std::uint64_t>> getCodeWriteStatistics() const;
+
+    /**
+     * Ends current epoch of tracking of written pages.
+     * Pages written after the call are dirty since the returned epoch.
+     * Each consumer keeps its own epoch, so consumers do not clear pages for each other.
+     *
+     * @return Number of the ended epoch.
+     */
+    std::uint32_t finishEpoch();
+
+    /**
+     * Checks whether page containing given address has been written since given epoch ended.
+     *
+     * @param addr Address within the page.
+     * @param epoch Epoch returned by finishEpoch().
+     * @return True if the page is dirty.
+     */
+    bool isPageDirty(u16 addr, std::uint32_t epoch) const;
+
+    /**
+     * Returns pages written since given epoch ended.
+     *
+     * @param epoch Epoch returned by finishEpoch().
+     * @return Addresses of the dirty pages in ascending order.
+     */
+    std::vector<u16> getDirtyPages(std::uint32_t epoch) const;
+
+    /**
+     * Captures content of memory, copying only pages written since the previous snapshot.
+     *
+     * @return Snapshot of memory.
+     */
+    Snapshot takeSnapshot();
+
+    /**
+     * Restores content captured by takeSnapshot(), copying only pages which differ from it.
+     * Restored pages are reported as written, both to the write observer and to dirty page tracking.
+     *
+     * @param snapshot Snapshot of memory.
+     */
+    void restoreSnapshot(const Snapshot& snapshot);
+
+#if defined(CHIP16_WATCHPOINTS)
+    /**
+     * Sets watchpoint reporting accesses of given range to the write observer, which stops the cpu.
+     * Accesses of pages without watchpoints cost a single test of the page flag.
+     * Instruction fetches and sprites drawn from memory are not watched.
+     *
+     * @param addr Address of the first watched byte.
+     * @param size Number of watched bytes, the range may wrap around the end of memory.
+     * @param access Kinds of accesses to report.
+     */
+    void addWatchpoint(u16 addr, unsigned size, WatchAccess access);
+
+    /**
+     * Clears watchpoints set by addWatchpoint() with given range.
+     *
+     * @param addr Address of the first watched byte.
+     * @param size Number of watched bytes.
+     */
+    void removeWatchpoint(u16 addr, unsigned size);
+#endif
+
     template <typename T, typename ...Args>
     void writeData(u16 startPos, T data, Args ...args);
 
     void writeData(u16 startPos);
 
 private:
-    std::vector<u8> memory;
+    static constexpr unsigned MEMORY_SIZE = 0x10000;
+    static constexpr unsigned PAGE_SHIFT = 8;
+    static_assert(PAGE_SIZE == 1u << PAGE_SHIFT, "Page size must match page shift");
+
+    bool containsCode(u16 addr, unsigned size) const;
+    void notifyCodeWrite(u16 addr, unsigned size);
+    void forgetCode();
+    void markDirty(u16 addr, unsigned size);
+#if defined(CHIP16_WATCHPOINTS)
+    bool isWatched(const std::bitset<PAGES_COUNT>& watchedPages, u16 addr, unsigned size) const;
+    void checkWatchpoints(u16 addr, unsigned size, WatchAccess access) const;
+    void updateWatchedPages();
+#endif
+
+    std::array<u8, MEMORY_SIZE> memory;
+    MemoryWriteObserver* writeObserver;
+    std::bitset<PAGES_COUNT> codePages;
+    std::array<std::uint64_t, PAGES_COUNT> codeWrites;
+    std::array<std::uint32_t, PAGES_COUNT> pageWriteEpochs;
+    std::uint32_t epoch;
+    Snapshot lastSnapshot;      // Snapshot taken or restored last
+    std::uint32_t snapshotEpoch;
+#if defined(CHIP16_WATCHPOINTS)
+    struct Watchpoint
+    {
+        u16 addr;
+        unsigned size;
+        WatchAccess access;
+    };
+
+    std::vector<Watchpoint> watchpoints;
+    // Pages are flagged also for the byte preceding the range, so word accesses test only their first page
+    std::bitset<PAGES_COUNT> readWatchedPages;
+    std::bitset<PAGES_COUNT> writeWatchedPages;
+#endif
 
     static Logger LOG;
 };
 
+inline u8 MemoryImpl::readByte(u16 addr) const
+{
+#if defined(CHIP16_WATCHPOINTS)
+    if (readWatchedPages[addr >> PAGE_SHIFT])
+        checkWatchpoints(addr, 1, WatchAccess::READ);
+#endif
+    return memory[addr];
+}
+
+inline void MemoryImpl::writeByte(u16 addr, u8 byte)
+{
+    memory[addr] = byte;
+    pageWriteEpochs[addr >> PAGE_SHIFT] = epoch;
+    if (codePages[addr >> PAGE_SHIFT])
+        notifyCodeWrite(addr, 1);
+#if defined(CHIP16_WATCHPOINTS)
+    if (writeWatchedPages[addr >> PAGE_SHIFT])
+        checkWatchpoints(addr, 1, WatchAccess::WRITE);
+#endif
+}
+
+inline u16 MemoryImpl::readWord(u16 addr) const
+{
+#if defined(CHIP16_WATCHPOINTS)
+    if (readWatchedPages[addr >> PAGE_SHIFT])
+        checkWatchpoints(addr, sizeof(u16), WatchAccess::READ);
+#endif
+    if (addr == MEMORY_SIZE - 1)
+        return memory[addr] | (memory[0] << 8);
+
+    // Little endian host reads the word with a single load
+    u16 word;
+    std::memcpy(&word, &memory[addr], sizeof(word));
+    return word;
+}
+
+inline void MemoryImpl::writeWord(u16 addr, u16 word)
+{
+    // Word crossing a page, including the one wrapping around, is reported by bytes
+    if ((addr & 0xFF) == 0xFF)
+    {
+        writeByte(addr, word & 0xFF);
+        writeByte(addr + 1, (word >> 8) & 0xFF);
+        return;
+    }
+
+    std::memcpy(&memory[addr], &word, sizeof(word));
+    pageWriteEpochs[addr >> PAGE_SHIFT] = epoch;
+    if (codePages[addr >> PAGE_SHIFT])
+        notifyCodeWrite(addr, sizeof(word));
+#if defined(CHIP16_WATCHPOINTS)
+    if (writeWatchedPages[addr >> PAGE_SHIFT])
+        checkWatchpoints(addr, sizeof(word), WatchAccess::WRITE);
+#endif
+}
+
+inline u32 MemoryImpl::readInstruction(u16 addr) const
+{
+    // Instruction wrapping around is read by bytes, bypassing watchpoints of readWord()
+    if (addr > MEMORY_SIZE - 4)
+    {
+        u32 instruction = 0;
+        for (auto i = 0u; i < sizeof(instruction); i++)
+            instruction |= static_cast<u32>(memory[(addr + i) % MEMORY_SIZE]) << (i * 8);
+        return instruction;
+    }
+
+    // Little endian host reads both words with a single load
+    u32 instruction;
+    std::memcpy(&instruction, &memory[addr], sizeof(instruction));
+    return instruction;
+}
+
+inline void MemoryImpl::readBytes(u16 addr, u8* data, unsigned size) const
+{
+#if defined(CHIP16_WATCHPOINTS)
+    if (isWatched(readWatchedPages, addr, size))
+        checkWatchpoints(addr, size, WatchAccess::READ);
+#endif
+    const unsigned head = std::min<unsigned>(size, MEMORY_SIZE - addr);
+    std::memcpy(data, &memory[addr], head);
+    if (head < size)
+        std::memcpy(data + head, &memory[0], size - head);
+}
+
+inline void MemoryImpl::writeBytes(u16 addr, const u8* data, unsigned size)
+{
+    if (size == 0)
+        return;
+
+    const unsigned head = std::min<unsigned>(size, MEMORY_SIZE - addr);
+    std::memcpy(&memory[addr], data, head);
+    if (head < size)
+        std::memcpy(&memory[0], data + head, size - head);
+
+    markDirty(addr, head);
+    if (head < size)
+        markDirty(0, size - head);
+    if (containsCode(addr, head))
+        notifyCodeWrite(addr, head);
+    if (head < size && containsCode(0, size - head))
+        notifyCodeWrite(0, size - head);
+#if defined(CHIP16_WATCHPOINTS)
+    if (isWatched(writeWatchedPages, addr, size))
+        checkWatchpoints(addr, size, WatchAccess::WRITE);
+#endif
+}
+
+inline const u8* MemoryImpl::readByteReference(u16 addr) const
+{
+    return &memory[addr];
+}
+
+inline bool MemoryImpl::containsCode(u16 addr, unsigned size) const
+{
+    for (u32 page = addr >> PAGE_SHIFT; page <= ((addr + size - 1) >> PAGE_SHIFT); page++)
+    {
+        if (codePages[page])
+            return true;
+    }
+    return false;
+}
+
+inline void MemoryImpl::markDirty(u16 addr, unsigned size)
+{
+    for (u32 page = addr >> PAGE_SHIFT; page <= ((addr + size - 1) >> PAGE_SHIFT); page++)
+        pageWriteEpochs[page] = epoch;
+}
+
+#if defined(CHIP16_WATCHPOINTS)
+inline bool MemoryImpl::isWatched(const std::bitset<PAGES_COUNT>& watchedPages, u16 addr, unsigned size) const
+{
+    if (size == 0)
+        return false;
+
+    const u32 end = addr + size - 1;
+    for (u32 page = addr >> PAGE_SHIFT; page <= (end >> PAGE_SHIFT); page++)
+    {
+        if (watchedPages[page % PAGES_COUNT])
+            return true;
+    }
+    return false;
+}
+#endif
+
 template<typename T, typename ...Args>
 inline void MemoryImpl::writeData(u16 startPos, T data, Args ...args)
 {
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Types.hpp"
+
+class MemoryWriteObserver
+{
+public:
+    virtual ~MemoryWriteObserver() = default;
+
+    /**
+     * Called after memory range has been written.
+     *
+     * @param addr Address of the first written byte.
+     * @param size Number of written bytes.
+     */
+    virtual void onMemoryWrite(u16 addr, unsigned size) = 0;
+
+#if defined(CHIP16_WATCHPOINTS)
+    /**
+     * Called when memory access has touched watched range. The access itself is completed.
+     *
+     * @param addr Address of the first accessed byte.
+     * @param write True if the access is a write.
+     */
+    virtual void onWatchpointHit(u16 addr, bool write) = 0;
+#endif
+};
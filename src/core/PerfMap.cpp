@@ -0,0 +1,48 @@
+#include "PerfMap.hpp"
+
+#if CHIP16_JIT_SUPPORTED
+
+#include <cstdint>
+#include <unistd.h>
+
+Logger PerfMap::LOG(STRINGIFY(PerfMap));
+
+bool PerfMap::open(const std::string& path)
+{
+    close();
+    file.open(path, std::ios::out | std::ios::trunc);
+    if (!file)
+    {
+        LOG.error("Unable to create perf map ", path);
+        return false;
+    }
+    LOG.info("Writing symbols of compiled blocks into ", path);
+    return true;
+}
+
+void PerfMap::close()
+{
+    if (file.is_open())
+        file.close();
+    file.clear();
+}
+
+bool PerfMap::isOpen() const
+{
+    return file.is_open();
+}
+
+void PerfMap::addSymbol(const void* code, std::size_t size, const std::string& name)
+{
+    if (!file.is_open())
+        return;
+
+    file << std::hex << reinterpret_cast<std::uintptr_t>(code) << ' ' << size << ' ' << name << std::endl;
+}
+
+std::string PerfMap::getDefaultPath()
+{
+    return "/tmp/perf-" + std::to_string(getpid()) + ".map";
+}
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include "ExecutableMemory.hpp"
+
+#if CHIP16_JIT_SUPPORTED
+
+/**
+ * Symbols of code generated by the dynamic recompiler, written in the format read by Linux perf.
+ * perf resolves samples in anonymous executable memory of a process using /tmp/perf-<pid>.map,
+ * whose lines consist of hexadecimal start address, hexadecimal size and name of a symbol.
+ * Each line is flushed immediately, so the map is complete even if the process is killed.
+ */
+class PerfMap
+{
+public:
+    PerfMap() = default;
+
+    ~PerfMap() = default;
+
+    /**
+     * Creates map file, replacing the previous one.
+     *
+     * @param path Path of the file.
+     * @return True if the file has been created.
+     */
+    bool open(const std::string& path);
+
+    /**
+     * Closes map file, further symbols are ignored.
+     */
+    void close();
+
+    /**
+     * Checks whether symbols are written.
+     *
+     * @return True if map file is open.
+     */
+    bool isOpen() const;
+
+    /**
+     * Appends symbol of generated code.
+     *
+     * @param code Start of the code.
+     * @param size Size of the code in bytes.
+     * @param name Name of the symbol.
+     */
+    void addSymbol(const void* code, std::size_t size, const std::string& name);
+
+    /**
+     * Returns path of the map file perf reads for the current process.
+     *
+     * @return Path /tmp/perf-<pid>.map.
+     */
+    static std::string getDefaultPath();
+
+private:
+    std::ofstream file;
+
+    static Logger LOG;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+
+#include "StopReason.hpp"
+
+/**
+ * Drives cpu by emulated time.
+ * Chip16 cpu runs at 1 MHz executing one instruction per cycle and vertical blank happens at 60 Hz.
+ */
+class Scheduler
+{
+public:
+    static constexpr unsigned CYCLES_PER_VBLANK = 16666;
+
+    virtual ~Scheduler() = default;
+
+    /**
+     * Executes cpu until cycle of the next vertical blank and raises it.
+     *
+     * @return VBLANK if the frame has been completed, otherwise the reason of stopping cpu earlier,
+     *         that is BREAKPOINT, INVALID_OPCODE or WATCHPOINT.
+     */
+    virtual StopReason runFrame() = 0;
+
+    /**
+     * Returns number of cycles executed by cpu.
+     *
+     * @return Cycle counter.
+     */
+    virtual std::uint64_t getCycles() const = 0;
+
+    /**
+     * Returns number of raised vertical blanks.
+     *
+     * @return Frame counter.
+     */
+    virtual std::uint64_t getFrames() const = 0;
+};
@@ -0,0 +1,79 @@
+#include "SchedulerImpl.hpp"
+
+Logger SchedulerImpl::LOG(STRINGIFY(SchedulerImpl));
+
+SchedulerImpl::SchedulerImpl(const std::shared_ptr<Cpu>& cpu, const std::shared_ptr<Bus>& bus)
+    : cpu(cpu)
+    , bus(bus)
+    , nextVBlankCycle(cpu->getCycles() + CYCLES_PER_VBLANK)
+    , frames(0)
+    , idleCycles(0)
+    , idleFastForward(true)
+{
+}
+
+StopReason SchedulerImpl::runFrame()
+{
+    // Without fast-forward cpu waiting in VBLNK keeps executing it until the vertical blank
+    while (cpu->getCycles() < nextVBlankCycle)
+    {
+        const auto reason = cpu->run(nextVBlankCycle - cpu->getCycles());
+        // Only waiting for vertical blank and fast-forwarded idle loop continue the frame
+        if (reason != StopReason::BUDGET_EXHAUSTED && reason != StopReason::VBLANK && reason != StopReason::IDLE_LOOP)
+        {
+            LOG.debug("Frame interrupted at cycle ", cpu->getCycles());
+            return reason;
+        }
+        if (reason == StopReason::VBLANK && idleFastForward)
+            skipToVBlank();
+    }
+
+    // Blocks of recompiling cpus may overrun the deadline, which does not shift following frames
+    bus->setVBlank(true);
+    nextVBlankCycle += CYCLES_PER_VBLANK;
+    frames++;
+    return StopReason::VBLANK;
+}
+
+std::uint64_t SchedulerImpl::getCycles() const
+{
+    return cpu->getCycles();
+}
+
+std::uint64_t SchedulerImpl::getFrames() const
+{
+    return frames;
+}
+
+void SchedulerImpl::setIdleFastForward(bool enabled)
+{
+    idleFastForward = enabled;
+}
+
+std::uint64_t SchedulerImpl::getIdleCycles() const
+{
+    return idleCycles;
+}
+
+SchedulerImpl::Snapshot SchedulerImpl::takeSnapshot() const
+{
+    return Snapshot{ nextVBlankCycle, frames, idleCycles };
+}
+
+void SchedulerImpl::restoreSnapshot(const Snapshot& snapshot)
+{
+    nextVBlankCycle = snapshot.nextVBlankCycle;
+    frames = snapshot.frames;
+    idleCycles = snapshot.idleCycles;
+}
+
+void SchedulerImpl::skipToVBlank()
+{
+    // Only the scheduler raises vertical blank, so nothing can release VBLNK before it
+    const auto cycles = cpu->getCycles();
+    if (cycles >= nextVBlankCycle)
+        return;
+
+    cpu->skipCycles(nextVBlankCycle - cycles);
+    idleCycles += nextVBlankCycle - cycles;
+}
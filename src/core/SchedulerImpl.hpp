@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+
+#include "Scheduler.hpp"
+#include "Cpu.hpp"
+#include "Bus.hpp"
+#include "../log/Logger.hpp"
+
+class SchedulerImpl : public Scheduler
+{
+public:
+    SchedulerImpl(const std::shared_ptr<Cpu>& cpu, const std::shared_ptr<Bus>& bus);
+
+    ~SchedulerImpl() = default;
+
+    StopReason runFrame() override;
+
+    std::uint64_t getCycles() const override;
+
+    std::uint64_t getFrames() const override;
+
+    /**
+     * Enables skipping cycles spent by cpu waiting in VBLNK.
+     * Skipped cycles are charged to the cycle counter, so emulated time is not affected.
+     * Enabled by default.
+     *
+     * @param enabled True to fast-forward idle cpu to vertical blank.
+     */
+    void setIdleFastForward(bool enabled);
+
+    /**
+     * Returns number of cycles skipped while cpu was idle.
+     *
+     * @return Number of skipped cycles.
+     */
+    std::uint64_t getIdleCycles() const;
+
+    /**
+     * Timing state restored by restoreSnapshot().
+     */
+    struct Snapshot
+    {
+        std::uint64_t nextVBlankCycle;
+        std::uint64_t frames;
+        std::uint64_t idleCycles;
+    };
+
+    /**
+     * Captures cycle of the next vertical blank and frame and idle cycle counters.
+     *
+     * @return Snapshot of the scheduler.
+     */
+    Snapshot takeSnapshot() const;
+
+    /**
+     * Restores state captured by takeSnapshot().
+     *
+     * @param snapshot Snapshot of the scheduler.
+     */
+    void restoreSnapshot(const Snapshot& snapshot);
+
+private:
+    void skipToVBlank();
+
+    std::shared_ptr<Cpu> cpu;
+    std::shared_ptr<Bus> bus;
+    std::uint64_t nextVBlankCycle;
+    std::uint64_t frames;
+    std::uint64_t idleCycles;
+    bool idleFastForward;
+
+    static Logger LOG;
+};
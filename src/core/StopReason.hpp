@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Types.hpp"
+
+/**
+ * Reason of returning from batch execution of instructions.
+ */
+enum class StopReason : u8
+{
+    BUDGET_EXHAUSTED,   // Given number of cycles has been executed
+    VBLANK,             // VBLNK waits for vertical blank that has not happened yet
+    BREAKPOINT,         // Program counter reached address with breakpoint
+    INVALID_OPCODE,     // Executed instruction is not valid
+    IDLE_LOOP,          // Loop polling memory has been fast-forwarded within the budget
+    WATCHPOINT          // Instruction has accessed watched memory range
+};
@@ -0,0 +1,83 @@
+#include "TracingMemory.hpp"
+#include "../log/HexModificator.hpp"
+
+Logger TracingMemory::LOG(STRINGIFY(TracingMemory));
+
+TracingMemory::TracingMemory(const std::shared_ptr<MemoryImpl>& memory)
+    : memory(memory)
+{
+}
+
+u8 TracingMemory::readByte(u16 addr) const
+{
+    LOG.debug("Reading byte from memory at address ", logHex(addr));
+    return memory->readByte(addr);
+}
+
+void TracingMemory::writeByte(u16 addr, u8 byte)
+{
+    LOG.debug("Writing byte ", logHex(byte), " into memory at address ", logHex(addr));
+    memory->writeByte(addr, byte);
+}
+
+u16 TracingMemory::readWord(u16 addr) const
+{
+    LOG.debug("Reading word from memory at address ", logHex(addr));
+    return memory->readWord(addr);
+}
+
+void TracingMemory::writeWord(u16 addr, u16 word)
+{
+    LOG.debug("Writing word ", logHex(word), " into memory at address ", logHex(addr));
+    memory->writeWord(addr, word);
+}
+
+u32 TracingMemory::readInstruction(u16 addr) const
+{
+    LOG.debug("Reading instruction from memory at address ", logHex(addr));
+    return memory->readInstruction(addr);
+}
+
+void TracingMemory::readBytes(u16 addr, u8* data, unsigned size) const
+{
+    LOG.debug("Reading ", size, " bytes from memory at address ", logHex(addr));
+    memory->readBytes(addr, data, size);
+}
+
+void TracingMemory::writeBytes(u16 addr, const u8* data, unsigned size)
+{
+    LOG.debug("Writing ", size, " bytes into memory at address ", logHex(addr));
+    memory->writeBytes(addr, data, size);
+}
+
+ControllerState TracingMemory::readControllerState(unsigned index) const
+{
+    LOG.debug("Reading state of controller ", index);
+    return memory->readControllerState(index);
+}
+
+const u8* TracingMemory::readByteReference(u16 addr) const
+{
+    LOG.debug("Reading reference from memory at address ", logHex(addr));
+    return memory->readByteReference(addr);
+}
+
+void TracingMemory::loadRomFromStream(std::istream& is)
+{
+    memory->loadRomFromStream(is);
+}
+
+void TracingMemory::loadRom(const u8* data, std::size_t size)
+{
+    memory->loadRom(data, size);
+}
+
+void TracingMemory::setWriteObserver(MemoryWriteObserver* observer)
+{
+    memory->setWriteObserver(observer);
+}
+
+void TracingMemory::markCode(u16 addr, unsigned size)
+{
+    memory->markCode(addr, size);
+}
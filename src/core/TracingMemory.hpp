@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+
+#include "Memory.hpp"
+#include "MemoryImpl.hpp"
+#include "../log/Logger.hpp"
+
+/**
+ * Instrumented memory logging every access before forwarding it to the wrapped memory.
+ * Accesses reach it only from cpu calling memory through the interface, see CpuImpl.
+ */
+class TracingMemory final : public Memory
+{
+public:
+    TracingMemory(const std::shared_ptr<MemoryImpl>& memory);
+
+    ~TracingMemory() = default;
+
+    u8 readByte(u16 addr) const override;
+
+    void writeByte(u16 addr, u8 byte) override;
+
+    u16 readWord(u16 addr) const override;
+
+    void writeWord(u16 addr, u16 word) override;
+
+    u32 readInstruction(u16 addr) const override;
+
+    void readBytes(u16 addr, u8* data, unsigned size) const override;
+
+    void writeBytes(u16 addr, const u8* data, unsigned size) override;
+
+    ControllerState readControllerState(unsigned index) const override;
+
+    const u8* readByteReference(u16 addr) const override;
+
+    void loadRomFromStream(std::istream& is) override;
+
+    void loadRom(const u8* data, std::size_t size) override;
+
+    void setWriteObserver(MemoryWriteObserver* observer) override;
+
+    void markCode(u16 addr, unsigned size) override;
+
+private:
+    std::shared_ptr<MemoryImpl> memory;
+
+    static Logger LOG;
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Types.hpp"
+
+class AotCpuImpl;
+
+/**
+ * Basic block of chip16 code translated ahead of time into C++ function.
+ */
+struct TranslatedBlock
+{
+    u16 startAddress;
+    u32 endAddress;                     // Address following the last instruction of the block
+    u32 checksum;                       // CRC32 of the block code the function was translated from
+    void (*function)(AotCpuImpl& cpu);  // Executes the block and sets program counter to its successor
+};
+
+/**
+ * Set of blocks translated from a single ROM.
+ */
+struct TranslatedProgram
+{
+    const TranslatedBlock* blocks;
+    std::size_t blocksCount;
+};
+
+/**
+ * Returns program linked into the emulator.
+ * Defined by the translation unit generated with chip16-aot tool.
+ *
+ * @return Translated program.
+ */
+const TranslatedProgram& getTranslatedProgram();
@@ -9,5 +9,6 @@ using u32 = std::uint_least32_t;
 
 using s8 = std::int_least8_t;
 using s16 = std::int_least16_t;
+using s32 = std::int_least32_t;
 
 using Palette = std::array<u32, 16>;
\ No newline at end of file
@@ -0,0 +1,305 @@
+#include "X86Emitter.hpp"
+
+const std::vector<u8>& X86Emitter::getCode() const
+{
+    return code;
+}
+
+std::size_t X86Emitter::getSize() const
+{
+    return code.size();
+}
+
+void X86Emitter::push(Reg reg)
+{
+    emitRex(false, 0, id(reg));
+    emit8(0x50 + (id(reg) & 7));
+}
+
+void X86Emitter::pop(Reg reg)
+{
+    emitRex(false, 0, id(reg));
+    emit8(0x58 + (id(reg) & 7));
+}
+
+void X86Emitter::ret()
+{
+    emit8(0xC3);
+}
+
+void X86Emitter::movRegReg32(Reg dst, Reg src)
+{
+    emitRex(false, id(src), id(dst));
+    emit8(0x89);
+    emitModRmReg(id(src), id(dst));
+}
+
+void X86Emitter::movRegReg64(Reg dst, Reg src)
+{
+    emitRex(true, id(src), id(dst));
+    emit8(0x89);
+    emitModRmReg(id(src), id(dst));
+}
+
+void X86Emitter::movRegImm32(Reg dst, u32 imm)
+{
+    emitRex(false, 0, id(dst));
+    emit8(0xB8 + (id(dst) & 7));
+    emit32(imm);
+}
+
+void X86Emitter::movRegImm64(Reg dst, std::uint64_t imm)
+{
+    emitRex(true, 0, id(dst));
+    emit8(0xB8 + (id(dst) & 7));
+    emit64(imm);
+}
+
+void X86Emitter::movzxRegMem16(Reg dst, Reg base, s32 disp)
+{
+    emitRex(false, id(dst), id(base));
+    emit8(0x0F);
+    emit8(0xB7);
+    emitModRmMem(id(dst), base, disp);
+}
+
+void X86Emitter::movzxRegMem8(Reg dst, Reg base, s32 disp)
+{
+    emitRex(false, id(dst), id(base));
+    emit8(0x0F);
+    emit8(0xB6);
+    emitModRmMem(id(dst), base, disp);
+}
+
+void X86Emitter::movzxRegReg16(Reg dst, Reg src)
+{
+    emitRex(false, id(dst), id(src));
+    emit8(0x0F);
+    emit8(0xB7);
+    emitModRmReg(id(dst), id(src));
+}
+
+void X86Emitter::movzxRegReg8(Reg dst, Reg src)
+{
+    emitRex(false, id(dst), id(src), true);
+    emit8(0x0F);
+    emit8(0xB6);
+    emitModRmReg(id(dst), id(src));
+}
+
+void X86Emitter::movMemReg64(Reg base, s32 disp, Reg src)
+{
+    emitRex(true, id(src), id(base));
+    emit8(0x89);
+    emitModRmMem(id(src), base, disp);
+}
+
+void X86Emitter::movMemReg16(Reg base, s32 disp, Reg src)
+{
+    emit8(0x66);
+    emitRex(false, id(src), id(base));
+    emit8(0x89);
+    emitModRmMem(id(src), base, disp);
+}
+
+void X86Emitter::movMemImm16(Reg base, s32 disp, u16 imm)
+{
+    emit8(0x66);
+    emitRex(false, 0, id(base));
+    emit8(0xC7);
+    emitModRmMem(0, base, disp);
+    emit16(imm);
+}
+
+void X86Emitter::movMemReg8(Reg base, s32 disp, Reg src)
+{
+    // Only the register operand is a byte register, base stays 64-bit
+    const bool byteRegister = id(src) >= 4 && id(src) < 8;
+    const u8 rex = 0x40 | ((id(src) >> 3) << 2) | (id(base) >> 3);
+    if (rex != 0x40 || byteRegister)
+        emit8(rex);
+    emit8(0x88);
+    emitModRmMem(id(src), base, disp);
+}
+
+void X86Emitter::aluRegReg32(AluOperation operation, Reg dst, Reg src)
+{
+    emitRex(false, id(src), id(dst));
+    emit8((static_cast<u8>(operation) << 3) | 0x01);
+    emitModRmReg(id(src), id(dst));
+}
+
+void X86Emitter::aluRegImm32(AluOperation operation, Reg dst, u32 imm)
+{
+    emitRex(false, 0, id(dst));
+    emit8(0x81);
+    emitModRmReg(static_cast<u8>(operation), id(dst));
+    emit32(imm);
+}
+
+void X86Emitter::aluMemImm32(AluOperation operation, Reg base, s32 disp, u32 imm)
+{
+    emitRex(false, 0, id(base));
+    emit8(0x81);
+    emitModRmMem(static_cast<u8>(operation), base, disp);
+    emit32(imm);
+}
+
+void X86Emitter::shiftRegImm32(ShiftOperation operation, Reg dst, u8 count)
+{
+    emitRex(false, 0, id(dst));
+    emit8(0xC1);
+    emitModRmReg(static_cast<u8>(operation), id(dst));
+    emit8(count);
+}
+
+void X86Emitter::notReg32(Reg reg)
+{
+    emitRex(false, 0, id(reg));
+    emit8(0xF7);
+    emitModRmReg(2, id(reg));
+}
+
+void X86Emitter::negReg32(Reg reg)
+{
+    emitRex(false, 0, id(reg));
+    emit8(0xF7);
+    emitModRmReg(3, id(reg));
+}
+
+void X86Emitter::testRegImm32(Reg reg, u32 imm)
+{
+    emitRex(false, 0, id(reg));
+    emit8(0xF7);
+    emitModRmReg(0, id(reg));
+    emit32(imm);
+}
+
+void X86Emitter::testRegReg8(Reg reg1, Reg reg2)
+{
+    emitRex(false, id(reg2), id(reg1), true);
+    emit8(0x84);
+    emitModRmReg(id(reg2), id(reg1));
+}
+
+void X86Emitter::setcc(Condition condition, Reg dst)
+{
+    emitRex(false, 0, id(dst), true);
+    emit8(0x0F);
+    emit8(0x90 + static_cast<u8>(condition));
+    emitModRmReg(0, id(dst));
+}
+
+void X86Emitter::callReg(Reg reg)
+{
+    emitRex(false, 0, id(reg));
+    emit8(0xFF);
+    emitModRmReg(2, id(reg));
+}
+
+X86Emitter::Label X86Emitter::createLabel()
+{
+    labels.push_back(LabelState{ -1, {} });
+    return labels.size() - 1;
+}
+
+void X86Emitter::bind(Label label)
+{
+    auto& state = labels[label];
+    state.position = static_cast<std::ptrdiff_t>(code.size());
+    for (auto fixup : state.fixups)
+        patch32(fixup, static_cast<u32>(state.position - static_cast<std::ptrdiff_t>(fixup + 4)));
+    state.fixups.clear();
+}
+
+void X86Emitter::jmp(Label label)
+{
+    emit8(0xE9);
+    emitRel32(label);
+}
+
+void X86Emitter::jcc(Condition condition, Label label)
+{
+    emit8(0x0F);
+    emit8(0x80 + static_cast<u8>(condition));
+    emitRel32(label);
+}
+
+void X86Emitter::emit8(u8 byte)
+{
+    code.push_back(byte);
+}
+
+void X86Emitter::emit16(u16 word)
+{
+    emit8(word & 0xFF);
+    emit8((word >> 8) & 0xFF);
+}
+
+void X86Emitter::emit32(u32 dword)
+{
+    emit16(dword & 0xFFFF);
+    emit16((dword >> 16) & 0xFFFF);
+}
+
+void X86Emitter::emit64(std::uint64_t qword)
+{
+    emit32(qword & 0xFFFFFFFF);
+    emit32((qword >> 32) & 0xFFFFFFFF);
+}
+
+void X86Emitter::patch32(std::size_t position, u32 dword)
+{
+    for (auto i = 0; i < 4; i++)
+        code[position + i] = (dword >> (i * 8)) & 0xFF;
+}
+
+void X86Emitter::emitRex(bool wide, unsigned reg, unsigned rm, bool byteRegisters)
+{
+    const u8 rex = 0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm >> 3);
+    // Without REX prefix encodings 4-7 of byte registers select AH, CH, DH and BH
+    const bool needsRex = byteRegisters && ((reg >= 4 && reg < 8) || (rm >= 4 && rm < 8));
+    if (rex != 0x40 || needsRex)
+        emit8(rex);
+}
+
+void X86Emitter::emitModRmReg(unsigned reg, unsigned rm)
+{
+    emit8(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+void X86Emitter::emitModRmMem(unsigned reg, Reg base, s32 disp)
+{
+    const unsigned rm = id(base) & 7;
+    const bool needsSib = rm == 4;  // RSP and R12 can be addressed only through SIB byte
+    const bool isByteDisplacement = disp >= -128 && disp <= 127;
+
+    // Mod 00 with RBP or R13 selects RIP-relative addressing, so displacement is always emitted
+    emit8((isByteDisplacement ? 0x40 : 0x80) | ((reg & 7) << 3) | rm);
+    if (needsSib)
+        emit8(0x24);
+    if (isByteDisplacement)
+        emit8(static_cast<u8>(disp));
+    else
+        emit32(static_cast<u32>(disp));
+}
+
+void X86Emitter::emitRel32(Label label)
+{
+    const auto& state = labels[label];
+    if (state.position >= 0)
+    {
+        const auto next = static_cast<std::ptrdiff_t>(code.size() + 4);
+        emit32(static_cast<u32>(state.position - next));
+    }
+    else
+    {
+        labels[label].fixups.push_back(code.size());
+        emit32(0);
+    }
+}
+
+unsigned X86Emitter::id(Reg reg)
+{
+    return static_cast<unsigned>(reg);
+}
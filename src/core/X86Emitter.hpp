@@ -0,0 +1,136 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "Types.hpp"
+
+/**
+ * Minimal x86-64 machine code encoder used by the dynamic recompiler.
+ * Only the instruction forms needed to translate chip16 blocks are supported.
+ * Memory operands are always addressed as [base + displacement].
+ */
+class X86Emitter
+{
+public:
+    enum class Reg : u8
+    {
+        RAX = 0, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+        R8, R9, R10, R11, R12, R13, R14, R15
+    };
+
+    enum class Condition : u8
+    {
+        OVERFLOW = 0x0, NOT_OVERFLOW = 0x1,
+        BELOW = 0x2, ABOVE_EQUAL = 0x3,
+        EQUAL = 0x4, NOT_EQUAL = 0x5,
+        BELOW_EQUAL = 0x6, ABOVE = 0x7,
+        SIGN = 0x8, NOT_SIGN = 0x9,
+        LESS = 0xC, GREATER_EQUAL = 0xD,
+        LESS_EQUAL = 0xE, GREATER = 0xF
+    };
+
+    enum class AluOperation : u8
+    {
+        ADD = 0, OR = 1, AND = 4, SUB = 5, XOR = 6, CMP = 7
+    };
+
+    enum class ShiftOperation : u8
+    {
+        SHL = 4, SHR = 5, SAR = 7
+    };
+
+    /**
+     * Label identifying position in the emitted code.
+     * Jumps to unbound labels are patched when the label gets bound.
+     */
+    using Label = std::size_t;
+
+    X86Emitter() = default;
+
+    ~X86Emitter() = default;
+
+    /**
+     * Returns emitted machine code.
+     *
+     * @return Emitted code.
+     */
+    const std::vector<u8>& getCode() const;
+
+    /**
+     * Returns current size of the emitted code.
+     *
+     * @return Size of the code in bytes.
+     */
+    std::size_t getSize() const;
+
+    void push(Reg reg);
+    void pop(Reg reg);
+    void ret();
+
+    void movRegReg32(Reg dst, Reg src);
+    void movRegReg64(Reg dst, Reg src);
+    void movRegImm32(Reg dst, u32 imm);
+    void movRegImm64(Reg dst, std::uint64_t imm);
+
+    void movzxRegMem16(Reg dst, Reg base, s32 disp);
+    void movzxRegMem8(Reg dst, Reg base, s32 disp);
+    void movzxRegReg16(Reg dst, Reg src);
+    void movzxRegReg8(Reg dst, Reg src);
+    void movMemReg64(Reg base, s32 disp, Reg src);
+    void movMemReg16(Reg base, s32 disp, Reg src);
+    void movMemImm16(Reg base, s32 disp, u16 imm);
+    void movMemReg8(Reg base, s32 disp, Reg src);
+
+    void aluRegReg32(AluOperation operation, Reg dst, Reg src);
+    void aluRegImm32(AluOperation operation, Reg dst, u32 imm);
+    void aluMemImm32(AluOperation operation, Reg base, s32 disp, u32 imm);
+    void shiftRegImm32(ShiftOperation operation, Reg dst, u8 count);
+    void notReg32(Reg reg);
+    void negReg32(Reg reg);
+    void testRegImm32(Reg reg, u32 imm);
+    void testRegReg8(Reg reg1, Reg reg2);
+    void setcc(Condition condition, Reg dst);
+
+    void callReg(Reg reg);
+
+    /**
+     * Creates new unbound label.
+     *
+     * @return Created label.
+     */
+    Label createLabel();
+
+    /**
+     * Binds label to the current position in the code.
+     *
+     * @param label Label to be bound.
+     */
+    void bind(Label label);
+
+    void jmp(Label label);
+    void jcc(Condition condition, Label label);
+
+private:
+    struct LabelState
+    {
+        std::ptrdiff_t position;              // Bound position or -1
+        std::vector<std::size_t> fixups;      // Positions of rel32 fields to patch
+    };
+
+    void emit8(u8 byte);
+    void emit16(u16 word);
+    void emit32(u32 dword);
+    void emit64(std::uint64_t qword);
+    void patch32(std::size_t position, u32 dword);
+
+    void emitRex(bool wide, unsigned reg, unsigned rm, bool byteRegisters = false);
+    void emitModRmReg(unsigned reg, unsigned rm);
+    void emitModRmMem(unsigned reg, Reg base, s32 disp);
+    void emitRel32(Label label);
+
+    static unsigned id(Reg reg);
+
+    std::vector<u8> code;
+    std::vector<LabelState> labels;
+};
@@ -1,9 +1,34 @@
 #pragma once
 
+#include <cstdint>
+
+#include "../core/StopReason.hpp"
+
 class InstructionExecutionFacade
 {
 public:
     ~InstructionExecutionFacade() = default;
 
     virtual void executeInstruction() = 0;
+
+    /**
+     * Executes instructions until cpu waits for vertical blank, limited to cycles of a single frame.
+     *
+     * @return Reason of stopping the execution.
+     */
+    virtual StopReason runUntilVBlank() = 0;
+
+    /**
+     * Executes instructions of a single frame and raises vertical blank at its end.
+     *
+     * @return Reason of stopping the execution.
+     */
+    virtual StopReason runFrame() = 0;
+
+    /**
+     * Returns number of cycles executed by cpu.
+     *
+     * @return Cycle counter.
+     */
+    virtual std::uint64_t getCycles() const = 0;
 };
\ No newline at end of file
@@ -1,12 +1,42 @@
 #include "InstructionExecutionFacadeImpl.hpp"
+#include "../core/CpuFactory.hpp"
+#include "../core/MemoryImpl.hpp"
+#include "../core/BusImpl.hpp"
+#include "../core/GraphicsImpl.hpp"
+#include "../core/SchedulerImpl.hpp"
 
-InstructionExecutionFacadeImpl::InstructionExecutionFacadeImpl(const std::shared_ptr<Cpu> &cpu)
+InstructionExecutionFacadeImpl::InstructionExecutionFacadeImpl(const std::shared_ptr<Cpu> &cpu,
+    const std::shared_ptr<Scheduler> &scheduler)
     : cpu(cpu)
+    , scheduler(scheduler)
 {
 }
 
+std::shared_ptr<InstructionExecutionFacadeImpl> InstructionExecutionFacadeImpl::create(CpuBackend backend,
+    const std::shared_ptr<RecompilingCpuBase::MemoryType>& memory,
+    const std::shared_ptr<RecompilingCpuBase::BusType>& bus)
+{
+    std::shared_ptr<Cpu> cpu = CpuFactory::create(backend, memory, bus);
+    auto scheduler = std::make_shared<SchedulerImpl>(cpu, bus);
+    return std::make_shared<InstructionExecutionFacadeImpl>(cpu, scheduler);
+}
+
 void InstructionExecutionFacadeImpl::executeInstruction()
 {
-    const auto opcode = cpu->fetchOpcode();
-    cpu->executeInstruction(opcode);
+    cpu->step();
+}
+
+StopReason InstructionExecutionFacadeImpl::runUntilVBlank()
+{
+    return cpu->run(Scheduler::CYCLES_PER_VBLANK);
+}
+
+StopReason InstructionExecutionFacadeImpl::runFrame()
+{
+    return scheduler->runFrame();
+}
+
+std::uint64_t InstructionExecutionFacadeImpl::getCycles() const
+{
+    return scheduler->getCycles();
 }
\ No newline at end of file
@@ -4,17 +4,40 @@
 
 #include "InstructionExecutionFacade.hpp"
 #include "../core/Cpu.hpp"
+#include "../core/CpuBackend.hpp"
+#include "../core/CpuImpl.hpp"
+#include "../core/Scheduler.hpp"
 
 class InstructionExecutionFacadeImpl
     : public InstructionExecutionFacade
 {
 public:
-    InstructionExecutionFacadeImpl(const std::shared_ptr<Cpu> &cpu);
+    InstructionExecutionFacadeImpl(const std::shared_ptr<Cpu> &cpu, const std::shared_ptr<Scheduler> &scheduler);
 
     ~InstructionExecutionFacadeImpl() = default;
 
+    /**
+     * Creates facade executing code with cpu of given backend, driven by its own scheduler.
+     * Lets headless runners choose the backend without rebuilding, see CpuFactory.
+     *
+     * @param backend Backend of the cpu.
+     * @param memory Memory accessed by cpu.
+     * @param bus Bus accessed by cpu and scheduler.
+     * @return Created facade.
+     */
+    static std::shared_ptr<InstructionExecutionFacadeImpl> create(CpuBackend backend,
+        const std::shared_ptr<RecompilingCpuBase::MemoryType>& memory,
+        const std::shared_ptr<RecompilingCpuBase::BusType>& bus);
+
     void executeInstruction() override;
 
+    StopReason runUntilVBlank() override;
+
+    StopReason runFrame() override;
+
+    std::uint64_t getCycles() const override;
+
 private:
     std::shared_ptr<Cpu> cpu;
+    std::shared_ptr<Scheduler> scheduler;
 };
\ No newline at end of file
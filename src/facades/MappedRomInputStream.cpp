@@ -0,0 +1,102 @@
+#include "MappedRomInputStream.hpp"
+
+#if CHIP16_MMAP_SUPPORTED
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+Logger MappedRomInputStream::LOG(STRINGIFY(MappedRomInputStream));
+
+MappedRomInputStream::MappedRomInputStream(const std::string& filename)
+    : mapping(nullptr)
+    , size(0)
+    , buffer()
+    , stream(&buffer)
+{
+    const int file = open(filename.c_str(), O_RDONLY);
+    struct stat status;
+    if (file < 0 || fstat(file, &status) != 0)
+    {
+        LOG.error("Unable to open ", filename);
+        if (file >= 0)
+            close(file);
+        stream.setstate(std::ios::failbit);
+        return;
+    }
+
+    // Empty file can not be mapped, it is read as an empty stream
+    if (status.st_size > 0)
+    {
+        void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if (data == MAP_FAILED)
+        {
+            LOG.error("Unable to map ", filename);
+            stream.setstate(std::ios::failbit);
+        }
+        else
+        {
+            mapping = data;
+            size = status.st_size;
+        }
+    }
+    // Mapping stays valid after the descriptor is closed
+    close(file);
+    buffer.setData(getData(), size);
+}
+
+MappedRomInputStream::~MappedRomInputStream()
+{
+    if (mapping)
+        munmap(mapping, size);
+}
+
+std::istream& MappedRomInputStream::getStream()
+{
+    return stream;
+}
+
+const u8* MappedRomInputStream::getData() const
+{
+    return static_cast<const u8*>(mapping);
+}
+
+std::size_t MappedRomInputStream::getSize() const
+{
+    return size;
+}
+
+void MappedRomInputStream::MappedBuffer::setData(const u8* data, std::size_t size)
+{
+    // Get area is never written, so mapping the bytes read-only is safe
+    char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+    setg(begin, begin, begin + size);
+}
+
+MappedRomInputStream::MappedBuffer::pos_type MappedRomInputStream::MappedBuffer::seekoff(
+    off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which)
+{
+    if (which & std::ios_base::out)
+        return pos_type(off_type(-1));
+
+    off_type position = offset;
+    if (direction == std::ios_base::cur)
+        position += gptr() - eback();
+    else if (direction == std::ios_base::end)
+        position += egptr() - eback();
+
+    if (position < 0 || position > egptr() - eback())
+        return pos_type(off_type(-1));
+
+    setg(eback(), eback() + position, egptr());
+    return pos_type(position);
+}
+
+MappedRomInputStream::MappedBuffer::pos_type MappedRomInputStream::MappedBuffer::seekpos(
+    pos_type position, std::ios_base::openmode which)
+{
+    return seekoff(off_type(position), std::ios_base::beg, which);
+}
+
+#endif
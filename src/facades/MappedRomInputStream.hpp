@@ -0,0 +1,62 @@
+#pragma once
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CHIP16_MMAP_SUPPORTED 1
+#else
+#define CHIP16_MMAP_SUPPORTED 0
+#endif
+
+#if CHIP16_MMAP_SUPPORTED
+
+#include <istream>
+#include <streambuf>
+#include <string>
+
+#include "RomInputStream.hpp"
+#include "../log/Logger.hpp"
+
+/**
+ * ROM file mapped into memory, which allows the facade to validate and load it without copying.
+ * The stream reads the same mapped bytes.
+ */
+class MappedRomInputStream : public RomInputStream
+{
+public:
+    MappedRomInputStream(const std::string& filename);
+
+    ~MappedRomInputStream();
+
+    MappedRomInputStream(const MappedRomInputStream&) = delete;
+
+    MappedRomInputStream& operator=(const MappedRomInputStream&) = delete;
+
+    std::istream& getStream() override;
+
+    const u8* getData() const override;
+
+    std::size_t getSize() const override;
+
+private:
+    /**
+     * Read-only stream buffer over bytes owned by someone else.
+     */
+    class MappedBuffer : public std::streambuf
+    {
+    public:
+        void setData(const u8* data, std::size_t size);
+
+    protected:
+        pos_type seekoff(off_type offset, std::ios_base::seekdir direction, std::ios_base::openmode which) override;
+
+        pos_type seekpos(pos_type position, std::ios_base::openmode which) override;
+    };
+
+    void* mapping;
+    std::size_t size;
+    MappedBuffer buffer;
+    std::istream stream;
+
+    static Logger LOG;
+};
+
+#endif
@@ -10,4 +10,6 @@ public:
     virtual ~RomFacade() = default;
 
     virtual bool loadRomIntoMemory(const std::shared_ptr<RomInputStream>& romInputStream) = 0;
+
+    virtual void saveTranslationCache() = 0;
 };
\ No newline at end of file
@@ -18,6 +18,28 @@ bool RomFacadeImpl::loadRomIntoMemory(const std::shared_ptr<RomInputStream>& rom
         return false;
     }
 
+    const u8* romData = romInputStream->getData();
+    const bool loaded = romData != nullptr
+        ? loadRomFromData(romData, romInputStream->getSize())
+        : loadRomFromStream(inputRom);
+    if (!loaded)
+        return false;
+    romLoaded = true;
+
+    if (translationCache)
+    {
+        const auto blocks = translationCache->load(romChecksum);
+        if (!blocks.empty())
+        {
+            const auto imported = cpu->importCode(blocks);
+            LOG.info("Imported ", logNumber(imported), " of ", logNumber(blocks.size()), " cached blocks");
+        }
+    }
+    return true;
+}
+
+bool RomFacadeImpl::loadRomFromStream(std::istream& inputRom)
+{
     bool hasHeader = hasChip16Header(inputRom);
     if (hasHeader)
     {
@@ -31,22 +53,68 @@ bool RomFacadeImpl::loadRomIntoMemory(const std::shared_ptr<RomInputStream>& rom
         }
         LOG.info("CRC32 checksum passed succesfully.");
         cpu->getRegisters().pc = header.startAddr;
+        romChecksum = header.crc32Checksum;
     }
     else 
     {
         LOG.info("ROM does not contain header. CRC32 checksum validation skipped.");
         cpu->getRegisters().pc = 0;
+        if (translationCache)
+            romChecksum = calculateChecksum(inputRom);
     }
 
-    inputRom.seekg(hasHeader ? 16 : 0, inputRom.beg);
+    inputRom.clear();
+    inputRom.seekg(hasHeader ? HEADER_SIZE : 0, inputRom.beg);
     memory->loadRomFromStream(inputRom);
     return true;
 }
 
+bool RomFacadeImpl::loadRomFromData(const u8* data, std::size_t size)
+{
+    const bool hasHeader = size >= HEADER_SIZE && std::memcmp(data, MAGIC_NUMBER, MAGIC_NUMBER_SIZE) == 0;
+    if (hasHeader)
+    {
+        LOG.info("ROM contains header. CRC32 checksum will be validated.");
+        RomHeader header = extractHeaderFromData(data);
+        logRomHeader(header);
+
+        const u8* rom = data + HEADER_SIZE;
+        const auto romSize = std::min<std::size_t>(header.romSize, size - HEADER_SIZE);
+        const auto CALCULATED_CHECKSUM = Crc32::checksum(rom, rom + romSize);
+        if (CALCULATED_CHECKSUM != header.crc32Checksum)
+        {
+            LOG.error("CRC32 checksum validation failed. Expected: ", logHex(header.crc32Checksum), " Actual: ", logHex(CALCULATED_CHECKSUM));
+            return false;
+        }
+        LOG.info("CRC32 checksum passed succesfully.");
+        cpu->getRegisters().pc = header.startAddr;
+        romChecksum = header.crc32Checksum;
+        memory->loadRom(rom, size - HEADER_SIZE);
+    }
+    else
+    {
+        LOG.info("ROM does not contain header. CRC32 checksum validation skipped.");
+        cpu->getRegisters().pc = 0;
+        if (translationCache)
+            romChecksum = Crc32::checksum(data, data + size);
+        memory->loadRom(data, size);
+    }
+    return true;
+}
+
+void RomFacadeImpl::saveTranslationCache()
+{
+    if (translationCache && romLoaded)
+        translationCache->save(romChecksum, cpu->exportCode());
+}
+
+void RomFacadeImpl::setTranslationCache(const std::shared_ptr<TranslationCache>& translationCache)
+{
+    this->translationCache = translationCache;
+}
+
 bool RomFacadeImpl::hasChip16Header(std::istream& istream)
 {
-    const auto MAGIC_NUMBER_SIZE = 4;
-    const std::string MAGIC_NUMBER("CH16");
     istream.seekg(0, istream.beg);
     std::string data(MAGIC_NUMBER_SIZE, '\0');
     
@@ -59,7 +127,7 @@ bool RomFacadeImpl::hasChip16Header(std::istream& istream)
 bool RomFacadeImpl::validateRom(std::istream& istream, const RomHeader& header)
 {
     const auto CRC_CHECKSUM = header.crc32Checksum;
-    istream.seekg(16, istream.beg);
+    istream.seekg(HEADER_SIZE, istream.beg);
 
     std::vector<u8> romData;
     for (auto i = header.romSize; i > 0 && istream.good(); i--) {
@@ -80,7 +148,6 @@ bool RomFacadeImpl::validateRom(std::istream& istream, const RomHeader& header)
 
 RomHeader RomFacadeImpl::extractHeaderFromFile(std::istream& istream)
 {
-    const auto HEADER_SIZE = 16;
     RomHeader header;
     
     auto readIntFromStream = [](auto& is, auto& var) {
@@ -98,6 +165,34 @@ RomHeader RomFacadeImpl::extractHeaderFromFile(std::istream& istream)
     return header;
 }
 
+RomHeader RomFacadeImpl::extractHeaderFromData(const u8* data)
+{
+    RomHeader header;
+
+    // Fields are packed in the file, unlike in the header struct
+    auto readIntFromData = [&data](auto& var) {
+        std::memcpy(&var, data, sizeof(var));
+        data += sizeof(var);
+    };
+
+    readIntFromData(header.magicNumber);
+    readIntFromData(header.reserved);
+    readIntFromData(header.specVersion);
+    readIntFromData(header.romSize);
+    readIntFromData(header.startAddr);
+    readIntFromData(header.crc32Checksum);
+
+    return header;
+}
+
+u32 RomFacadeImpl::calculateChecksum(std::istream& istream)
+{
+    istream.clear();
+    istream.seekg(0, istream.beg);
+    const std::vector<u8> romData{ std::istreambuf_iterator<char>(istream), std::istreambuf_iterator<char>() };
+    return Crc32::checksum(romData.begin(), romData.end());
+}
+
 void RomFacadeImpl::logRomHeader(const RomHeader& header)
 {
     const std::string SPECIFICATION_VERSION = std::to_string(header.specVersion >> 4) + '.' + std::to_string(header.specVersion & 0xF);
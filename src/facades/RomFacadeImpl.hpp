@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 #include <utility>
 
@@ -8,6 +11,7 @@
 #include "../core/Memory.hpp"
 #include "RomHeader.hpp"
 #include "RomFacade.hpp"
+#include "TranslationCache.hpp"
 #include "../utils/Crc32.hpp"
 #include "../log/Logger.hpp"
 #include "../log/HexModificator.hpp"
@@ -24,16 +28,43 @@ public:
 
     bool loadRomIntoMemory(const std::shared_ptr<RomInputStream>& romInputStream) override;
 
+    /**
+     * Stores code translated by the cpu, so the next load of the same ROM imports it.
+     */
+    void saveTranslationCache() override;
+
+    /**
+     * Sets cache of translated code, which is disabled by default.
+     *
+     * @param translationCache Cache used by subsequent loads.
+     */
+    void setTranslationCache(const std::shared_ptr<TranslationCache>& translationCache);
+
 private:
+    static constexpr std::size_t HEADER_SIZE = 16;
+    static constexpr std::size_t MAGIC_NUMBER_SIZE = 4;
+    static constexpr const char* MAGIC_NUMBER = "CH16";
+
+    bool loadRomFromStream(std::istream& inputRom);
+
+    bool loadRomFromData(const u8* data, std::size_t size);
+
     bool hasChip16Header(std::istream& ifstream);
 
     bool validateRom(std::istream& ifstream, const RomHeader& header);
 
     RomHeader extractHeaderFromFile(std::istream& ifstream);
 
+    RomHeader extractHeaderFromData(const u8* data);
+
+    u32 calculateChecksum(std::istream& istream);
+
     void logRomHeader(const RomHeader& header);
 
     std::shared_ptr<Cpu> cpu;
     std::shared_ptr<Memory> memory;
+    std::shared_ptr<TranslationCache> translationCache;
+    u32 romChecksum = 0;
+    bool romLoaded = false;
     static Logger LOG;
 };
\ No newline at end of file
@@ -9,3 +9,13 @@ std::istream& RomFileInputStream::getStream()
 {
     return inputRomStream;
 }
+
+const u8* RomFileInputStream::getData() const
+{
+    return nullptr;
+}
+
+std::size_t RomFileInputStream::getSize() const
+{
+    return 0;
+}
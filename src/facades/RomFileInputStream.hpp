@@ -12,6 +12,10 @@ public:
 
     std::istream& getStream() override;
 
+    const u8* getData() const override;
+
+    std::size_t getSize() const override;
+
 private:
     std::ifstream inputRomStream;
 };
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <istream>
 
+#include "../core/Types.hpp"
+
 /**
  * Additional layer of abstraction holding input stream.
  */
@@ -11,4 +14,19 @@ public:
     virtual ~RomInputStream() = default;
 
     virtual std::istream& getStream() = 0;
-};
\ No newline at end of file
+
+    /**
+     * Returns contents of the ROM as contiguous bytes, if the stream holds them in memory.
+     * Facade then validates and loads the ROM directly from these bytes instead of the stream.
+     *
+     * @return Pointer to the first byte of the ROM or nullptr if only the stream is available.
+     */
+    virtual const u8* getData() const = 0;
+
+    /**
+     * Returns number of bytes returned by getData().
+     *
+     * @return Size of the ROM in bytes.
+     */
+    virtual std::size_t getSize() const = 0;
+};
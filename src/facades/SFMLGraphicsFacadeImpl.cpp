@@ -5,7 +5,6 @@ SFMLGraphicsFacadeImpl::SFMLGraphicsFacadeImpl(const std::shared_ptr<GraphicsSer
     : chip16Graphics(chip16Graphics)
     , AbstractGraphicsFacade(graphicsService)
 {
-    this->chip16Graphics->setVBlank(true);
 }
 
 void SFMLGraphicsFacadeImpl::renderCurrentChip16State(sf::RenderTexture &graphicsBuffer)
@@ -15,5 +14,4 @@ void SFMLGraphicsFacadeImpl::renderCurrentChip16State(sf::RenderTexture &graphic
     const unsigned bgColorIndex = chip16Graphics->getBackgroundColorIndex();
 
     graphicsService->convertFromChip16Buffer(chip16Buffer, graphicsBuffer, chip16Palette, bgColorIndex);
-    chip16Graphics->setVBlank(true);
 }
\ No newline at end of file
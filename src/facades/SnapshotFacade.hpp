@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../core/Cpu.hpp"
+#include "../core/MemoryImpl.hpp"
+#include "../core/GraphicsImpl.hpp"
+#include "../core/SchedulerImpl.hpp"
+
+/**
+ * State of the whole emulated machine.
+ * Memory pages and screen buffer unchanged between snapshots are shared, so keeping many snapshots is cheap.
+ */
+struct MachineSnapshot
+{
+    Cpu::Snapshot cpu;
+    MemoryImpl::Snapshot memory;
+    GraphicsImpl::Snapshot graphics;
+    SchedulerImpl::Snapshot scheduler;
+};
+
+class SnapshotFacade
+{
+public:
+    virtual ~SnapshotFacade() = default;
+
+    /**
+     * Captures state of the machine.
+     * Cost depends on the amount of memory written since the previous snapshot.
+     *
+     * @return Snapshot of the machine.
+     */
+    virtual MachineSnapshot takeSnapshot() = 0;
+
+    /**
+     * Restores state captured by takeSnapshot().
+     * Snapshots can be restored in any order and any number of times.
+     *
+     * @param snapshot Snapshot of the machine.
+     */
+    virtual void restoreSnapshot(const MachineSnapshot& snapshot) = 0;
+};
@@ -0,0 +1,24 @@
+#include "SnapshotFacadeImpl.hpp"
+
+SnapshotFacadeImpl::SnapshotFacadeImpl(const std::shared_ptr<Cpu>& cpu, const std::shared_ptr<MemoryImpl>& memory,
+    const std::shared_ptr<GraphicsImpl>& graphics, const std::shared_ptr<SchedulerImpl>& scheduler)
+    : cpu(cpu)
+    , memory(memory)
+    , graphics(graphics)
+    , scheduler(scheduler)
+{
+}
+
+MachineSnapshot SnapshotFacadeImpl::takeSnapshot()
+{
+    return MachineSnapshot{ cpu->takeSnapshot(), memory->takeSnapshot(), graphics->takeSnapshot(), scheduler->takeSnapshot() };
+}
+
+void SnapshotFacadeImpl::restoreSnapshot(const MachineSnapshot& snapshot)
+{
+    // Memory goes first, since restored pages of code invalidate code decoded by the cpu
+    memory->restoreSnapshot(snapshot.memory);
+    graphics->restoreSnapshot(snapshot.graphics);
+    scheduler->restoreSnapshot(snapshot.scheduler);
+    cpu->restoreSnapshot(snapshot.cpu);
+}
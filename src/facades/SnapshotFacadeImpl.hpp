@@ -0,0 +1,25 @@
+#pragma once
+
+#include <memory>
+
+#include "SnapshotFacade.hpp"
+
+class SnapshotFacadeImpl
+    : public SnapshotFacade
+{
+public:
+    SnapshotFacadeImpl(const std::shared_ptr<Cpu>& cpu, const std::shared_ptr<MemoryImpl>& memory,
+        const std::shared_ptr<GraphicsImpl>& graphics, const std::shared_ptr<SchedulerImpl>& scheduler);
+
+    ~SnapshotFacadeImpl() = default;
+
+    MachineSnapshot takeSnapshot() override;
+
+    void restoreSnapshot(const MachineSnapshot& snapshot) override;
+
+private:
+    std::shared_ptr<Cpu> cpu;
+    std::shared_ptr<MemoryImpl> memory;
+    std::shared_ptr<GraphicsImpl> graphics;
+    std::shared_ptr<SchedulerImpl> scheduler;
+};
@@ -0,0 +1,130 @@
+#include "TranslationCache.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "../utils/Crc32.hpp"
+#include "../log/NumberModificator.hpp"
+
+Logger TranslationCache::LOG(STRINGIFY(TranslationCache));
+
+namespace
+{
+    // Fields are stored in little endian order regardless of the host
+    void putWord(std::vector<u8>& data, u16 value)
+    {
+        data.push_back(value & 0xFF);
+        data.push_back(value >> 8);
+    }
+
+    void putLong(std::vector<u8>& data, u32 value)
+    {
+        putWord(data, value & 0xFFFF);
+        putWord(data, value >> 16);
+    }
+
+    u16 getWord(const std::vector<u8>& data, std::size_t offset)
+    {
+        return data[offset] | (data[offset + 1] << 8);
+    }
+
+    u32 getLong(const std::vector<u8>& data, std::size_t offset)
+    {
+        return getWord(data, offset) | (u32(getWord(data, offset + 2)) << 16);
+    }
+}
+
+TranslationCache::TranslationCache(const std::string& directory)
+    : directory(directory)
+{
+}
+
+std::vector<CachedBlock> TranslationCache::load(u32 romChecksum) const
+{
+    const auto path = getPath(romChecksum);
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return {};
+
+    const std::vector<u8> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+    if (data.size() < HEADER_SIZE
+        || getLong(data, 0) != MAGIC_NUMBER
+        || getLong(data, 4) != FORMAT_VERSION
+        || getLong(data, 8) != romChecksum)
+    {
+        LOG.warn("Ignoring translation cache ", path, " created for other ROM or version");
+        return {};
+    }
+
+    const auto count = getLong(data, 12);
+    if (data.size() != HEADER_SIZE + std::size_t(count) * BLOCK_SIZE
+        || Crc32::checksum(data.begin() + HEADER_SIZE, data.end()) != getLong(data, 16))
+    {
+        LOG.warn("Ignoring corrupted translation cache ", path);
+        return {};
+    }
+
+    std::vector<CachedBlock> blocks;
+    for (std::size_t offset = HEADER_SIZE; offset < data.size(); offset += BLOCK_SIZE)
+        blocks.push_back(CachedBlock{ getWord(data, offset), getWord(data, offset + 2), getLong(data, offset + 4) });
+
+    LOG.info("Loaded ", logNumber(blocks.size()), " blocks from translation cache ", path);
+    return blocks;
+}
+
+bool TranslationCache::save(u32 romChecksum, const std::vector<CachedBlock>& blocks) const
+{
+    std::vector<u8> payload;
+    for (const auto& block : blocks)
+    {
+        putWord(payload, block.startAddress);
+        putWord(payload, block.size);
+        putLong(payload, block.checksum);
+    }
+
+    std::vector<u8> data;
+    putLong(data, MAGIC_NUMBER);
+    putLong(data, FORMAT_VERSION);
+    putLong(data, romChecksum);
+    putLong(data, blocks.size());
+    putLong(data, Crc32::checksum(payload.begin(), payload.end()));
+    data.insert(data.end(), payload.begin(), payload.end());
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // File is replaced at once, so interrupted write does not leave it truncated
+    const auto path = getPath(romChecksum);
+    const auto temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!file)
+        {
+            LOG.error("Could not write translation cache ", temporaryPath);
+            file.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        LOG.error("Could not write translation cache ", path);
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    LOG.info("Saved ", logNumber(blocks.size()), " blocks into translation cache ", path);
+    return true;
+}
+
+std::string TranslationCache::getPath(u32 romChecksum) const
+{
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string name(8, '0');
+    for (auto i = 0u; i < name.size(); i++)
+        name[i] = DIGITS[(romChecksum >> (28 - i * 4)) & 0xF];
+    return (std::filesystem::path(directory) / (name + ".c16cache")).string();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "../core/CachedBlock.hpp"
+#include "../log/Logger.hpp"
+
+/**
+ * Stores code decoded or translated during a run of a ROM in a file, see Cpu::exportCode().
+ * The file is named after CRC32 checksum of the ROM and stamped with the version of its format.
+ * Files of other ROMs, of other versions, truncated or otherwise corrupted are ignored.
+ */
+class TranslationCache
+{
+public:
+    /**
+     * Version of data stored in the file.
+     * Has to be changed whenever the layout of the file or meaning of stored blocks changes.
+     */
+    static constexpr u32 FORMAT_VERSION = 1;
+
+    TranslationCache(const std::string& directory);
+
+    ~TranslationCache() = default;
+
+    /**
+     * Reads blocks stored for the ROM.
+     *
+     * @param romChecksum CRC32 checksum of the ROM.
+     * @return Stored blocks, empty if the file is missing or invalid.
+     */
+    std::vector<CachedBlock> load(u32 romChecksum) const;
+
+    /**
+     * Replaces blocks stored for the ROM, creating the directory if needed.
+     *
+     * @param romChecksum CRC32 checksum of the ROM.
+     * @param blocks Blocks to be stored.
+     * @return True if the file was written.
+     */
+    bool save(u32 romChecksum, const std::vector<CachedBlock>& blocks) const;
+
+    /**
+     * Returns path of the file storing blocks of the ROM.
+     *
+     * @param romChecksum CRC32 checksum of the ROM.
+     * @return Path of the file.
+     */
+    std::string getPath(u32 romChecksum) const;
+
+private:
+    static constexpr u32 MAGIC_NUMBER = 0x43363143;    // "C16C"
+    static constexpr unsigned HEADER_SIZE = 20;
+    static constexpr unsigned BLOCK_SIZE = 8;
+
+    std::string directory;
+    static Logger LOG;
+};
@@ -1,3 +1,36 @@
 #include "Random.hpp"
 
-std::default_random_engine Random::randomEngine{ std::random_device{}() };
\ No newline at end of file
+#include <random>
+
+Random::Random()
+    : Random((std::uint64_t{ std::random_device{}() } << 32) | std::random_device{}())
+{
+}
+
+Random::Random(std::uint64_t seed)
+{
+    setSeed(seed);
+}
+
+void Random::setSeed(std::uint64_t seed)
+{
+    this->seed = seed;
+    state = 0;
+    next();
+    state += seed;
+    next();
+}
+
+std::uint64_t Random::getSeed() const
+{
+    return seed;
+}
+
+std::uint32_t Random::next()
+{
+    const auto previous = state;
+    state = previous * MULTIPLIER + INCREMENT;
+    const auto xorShifted = static_cast<std::uint32_t>(((previous >> 18) ^ previous) >> 27);
+    const auto rotation = static_cast<unsigned>(previous >> 59);
+    return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
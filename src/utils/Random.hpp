@@ -1,18 +1,60 @@
 #pragma once
 
-#include <random>
+#include <cstdint>
 #include <type_traits>
 
+/**
+ * Seedable PCG32 generator. Every emulated machine owns its own instance,
+ * so runs started with the same seed are reproducible.
+ */
 class Random
 {
 public:
+    /**
+     * Creates generator seeded from the non-deterministic source of the host.
+     */
+    Random();
+
+    explicit Random(std::uint64_t seed);
+
+    void setSeed(std::uint64_t seed);
+
+    std::uint64_t getSeed() const;
+
+    std::uint32_t next();
+
+    /**
+     * Returns uniformly distributed value from the closed range.
+     * Multiplication by the range size keeps the result unbiased without division
+     * in the common case, see Lemire, "Fast Random Integer Generation in an Interval".
+     */
     template <typename IntType, std::enable_if_t<std::is_integral_v<IntType>, IntType> = 0>
-    static IntType get(IntType min, IntType max)
-    {
-        std::uniform_int_distribution<IntType> dist(min, max);
-        return dist(randomEngine);
-    }
+    IntType get(IntType min, IntType max);
 
 private:
-    static std::default_random_engine randomEngine;
-};
\ No newline at end of file
+    std::uint64_t seed;
+    std::uint64_t state;
+
+    static constexpr std::uint64_t MULTIPLIER = 6364136223846793005u;
+    static constexpr std::uint64_t INCREMENT = 1442695040888963407u;
+};
+
+template <typename IntType, std::enable_if_t<std::is_integral_v<IntType>, IntType>>
+inline IntType Random::get(IntType min, IntType max)
+{
+    static_assert(sizeof(IntType) <= sizeof(std::uint32_t), "Range has to fit into generated values");
+
+    const std::uint64_t range = static_cast<std::int64_t>(max) - static_cast<std::int64_t>(min) + 1;
+    if (range > UINT32_MAX)
+        return static_cast<IntType>(next());
+
+    std::uint64_t product = std::uint64_t{ next() } * range;
+    if (static_cast<std::uint32_t>(product) < range)
+    {
+        // Values below threshold would make some results more likely than others
+        const auto threshold = static_cast<std::uint32_t>((UINT32_MAX - range + 1) % range);
+        while (static_cast<std::uint32_t>(product) < threshold)
+            product = std::uint64_t{ next() } * range;
+    }
+    return static_cast<IntType>(min + static_cast<IntType>(product >> 32));
+}
@@ -11,11 +11,20 @@ EmulationSFMLView::EmulationSFMLView(const std::shared_ptr<GraphicsFacade<sf::Re
 
 void EmulationSFMLView::update(const double dt)
 {
-    updateTimeCounter+=dt;
-    if(updateTimeCounter > 1/60)
+    // Frames are executed when host time reaches their vertical blank
+    updateTimeCounter += dt;
+    unsigned executedFrames = 0;
+    while (updateTimeCounter >= FRAME_DURATION && executedFrames < MAX_FRAMES_PER_UPDATE)
     {
-        graphicsFacade->renderCurrentChip16State(graphicsBuffer);
-        updateTimeCounter = 0;
+        instructionExecutionFacade->runFrame();
+        updateTimeCounter -= FRAME_DURATION;
+        executedFrames++;
     }
-    instructionExecutionFacade->executeInstruction();
+
+    // Emulation that cannot keep up with host time is slowed down instead of catching up
+    if (updateTimeCounter >= FRAME_DURATION)
+        updateTimeCounter = 0;
+
+    if (executedFrames > 0)
+        graphicsFacade->renderCurrentChip16State(graphicsBuffer);
 }
\ No newline at end of file
@@ -18,6 +18,9 @@ public:
     void update(const double dt) override;
 
 private:
+    static constexpr double FRAME_DURATION = 1.0 / 60;
+    static constexpr unsigned MAX_FRAMES_PER_UPDATE = 4;
+
     double updateTimeCounter;
 
     std::shared_ptr<GraphicsFacade<sf::RenderTexture>> graphicsFacade;
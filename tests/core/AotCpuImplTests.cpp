@@ -0,0 +1,170 @@
+#include <memory>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../../src/core/AotCpuImpl.hpp"
+#include "../../src/core/MemoryImpl.hpp"
+#include "../../src/core/BusImpl.hpp"
+#include "../../src/core/GraphicsImpl.hpp"
+#include "../../src/utils/Crc32.hpp"
+
+namespace
+{
+    bool lastInterpretResult;
+
+    // LDI R0, 0x1234; JMP 0x100 with R1 marking execution of translated code
+    void block0x0000(AotCpuImpl& cpu)
+    {
+        auto& registers = cpu.getRawRegisters();
+        registers.r[0] = 0x1234;
+        registers.r[1] = 0x5678;
+        registers.pc = 0x0100;
+    }
+
+    // STM R0, 0x2; JMP 0x100 overwriting its own code
+    void block0x0200(AotCpuImpl& cpu)
+    {
+        lastInterpretResult = cpu.interpret(0x0200, 0x3000, 0x0202);
+        if (!lastInterpretResult)
+            return;
+        cpu.getRawRegisters().pc = 0x0100;
+    }
+
+    // LDM R0, 0x200; TSTI R0, 1; JZ 0x300 polling memory
+    void block0x0300(AotCpuImpl& cpu)
+    {
+        auto& registers = cpu.getRawRegisters();
+        if (!cpu.interpret(0x0300, 0x2200, 0x0200))
+            return;
+        cpu.updateLogicalFlags(registers.r[0] & 0x0001);
+        registers.pc = cpu.evaluateCondition(0) ? 0x0300 : 0x030C;
+        cpu.noteIdleLoop(0x0300, 3);
+    }
+
+    class AotCpuImplTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            memory = std::make_shared<MemoryImpl>();
+            bus = std::make_shared<StaticBusImpl>(std::make_shared<GraphicsImpl>());
+            memory->writeData(0x0000, 0x00, 0x20, 0x34, 0x12, 0x00, 0x10, 0x00, 0x01);
+            memory->writeData(0x0200, 0x00, 0x30, 0x02, 0x02, 0x00, 0x10, 0x00, 0x01);
+            memory->writeData(0x0300, 0x00, 0x22, 0x00, 0x02, 0x00, 0x63, 0x01, 0x00, 0x00, 0x12, 0x00, 0x03);
+            blocks = {
+                { 0x0000, 0x0008, checksum(0x0000, 0x0008), &block0x0000 },
+                { 0x0200, 0x0208, checksum(0x0200, 0x0208), &block0x0200 },
+                { 0x0300, 0x030C, checksum(0x0300, 0x030C), &block0x0300 }
+            };
+            program = { blocks.data(), blocks.size() };
+            testedCpu = std::make_unique<AotCpuImpl>(memory, bus, program);
+        }
+
+        u32 checksum(u16 start, u16 end)
+        {
+            std::vector<u8> code;
+            for (auto addr = start; addr < end; addr++)
+                code.push_back(memory->readByte(addr));
+            return Crc32::checksum(code.begin(), code.end());
+        }
+
+        std::unique_ptr<AotCpuImpl> testedCpu;
+        std::shared_ptr<MemoryImpl> memory;
+        std::shared_ptr<StaticBusImpl> bus;
+        std::vector<TranslatedBlock> blocks;
+        TranslatedProgram program;
+    };
+}
+
+TEST_F(AotCpuImplTests, stepExecutesTranslatedBlockTest)
+{
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->step();
+    EXPECT_EQ(0x1234, regs.r[0]);
+    EXPECT_EQ(0x5678, regs.r[1]);
+    EXPECT_EQ(0x0100, regs.pc);
+}
+
+TEST_F(AotCpuImplTests, stepInterpretsBlockNotMatchingMemoryTest)
+{
+    auto& regs = testedCpu->getRegisters();
+    memory->writeData(0x0002, 0x11, 0x11);
+    testedCpu->step();
+    EXPECT_EQ(0x1111, regs.r[0]);
+    EXPECT_EQ(0x0000, regs.r[1]);
+    EXPECT_EQ(0x0004, regs.pc);
+}
+
+TEST_F(AotCpuImplTests, stepInterpretsUntranslatedAddressTest)
+{
+    auto& regs = testedCpu->getRegisters();
+    regs.pc = 0x0100;
+    testedCpu->step();
+    EXPECT_EQ(0x0104, regs.pc);
+}
+
+TEST_F(AotCpuImplTests, stepVerifiesBlockAgainAfterWriteTest)
+{
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->step();
+    memory->writeWord(0x0002, 0x1111);
+    regs = CpuRegisters{};
+    testedCpu->step();
+    EXPECT_EQ(0x1111, regs.r[0]);
+    EXPECT_EQ(0x0000, regs.r[1]);
+    EXPECT_EQ(0x0004, regs.pc);
+}
+
+TEST_F(AotCpuImplTests, interpretStopsBlockOverwritingItselfTest)
+{
+    auto& regs = testedCpu->getRegisters();
+    regs.pc = 0x0200;
+    regs.r[0] = 0xABCD;
+    testedCpu->step();
+    EXPECT_FALSE(lastInterpretResult);
+    EXPECT_EQ(0x0204, regs.pc);
+    EXPECT_EQ(0xABCD, memory->readWord(0x0202));
+    EXPECT_EQ(1, testedCpu->getCycles());
+}
+
+TEST_F(AotCpuImplTests, runSkipsIterationsOfIdleLoopTest)
+{
+    memory->writeData(0x0400, 0x00, 0x22, 0x00, 0x02);  // LDM R0, 0x200
+    memory->writeData(0x0404, 0x00, 0x63, 0x01, 0x00);  // TSTI R0, 1
+    memory->writeData(0x0408, 0x00, 0x12, 0x00, 0x04);  // JZ 0x400
+    testedCpu->getRegisters().pc = 0x0400;
+    testedCpu->setIdleLoopDetection(true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::IDLE_LOOP, result);
+    EXPECT_EQ(99, testedCpu->getCycles());
+    EXPECT_EQ(0x0400, testedCpu->getRegisters().pc);
+    ASSERT_EQ(1, testedCpu->getIdleLoopStatistics().size());
+    EXPECT_EQ(0x0400, testedCpu->getIdleLoopStatistics()[0].first);
+    EXPECT_EQ(93, testedCpu->getIdleLoopStatistics()[0].second);
+}
+
+TEST_F(AotCpuImplTests, runSkipsIterationsOfTranslatedIdleLoopTest)
+{
+    testedCpu->getRegisters().pc = 0x0300;
+    testedCpu->setIdleLoopDetection(true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::IDLE_LOOP, result);
+    EXPECT_EQ(99, testedCpu->getCycles());
+    EXPECT_EQ(0x0300, testedCpu->getRegisters().pc);
+    ASSERT_EQ(1, testedCpu->getIdleLoopStatistics().size());
+    EXPECT_EQ(0x0300, testedCpu->getIdleLoopStatistics()[0].first);
+    EXPECT_EQ(93, testedCpu->getIdleLoopStatistics()[0].second);
+}
+
+TEST_F(AotCpuImplTests, translatedBlockKeepsFlagsPendingTest)
+{
+    auto& regs = testedCpu->getRawRegisters();
+    testedCpu->setLazyFlags(true);
+    regs.flags.raw = 0;
+    regs.pendingFlags = PendingFlags{ FlagsOperation::ADDITION, 0xFFFF, 0x0001, 0x10000 };
+    testedCpu->step();
+    EXPECT_EQ(0x0100, regs.pc);
+    EXPECT_EQ(FlagsOperation::ADDITION, regs.pendingFlags.operation);
+    EXPECT_EQ(0, regs.flags.raw);
+}
@@ -59,14 +59,14 @@ TEST_F(BusImplTests, testSetSpriteDimensions)
 TEST_F(BusImplTests, testDrawSprite_notCollided)
 {
     EXPECT_CALL(*graphics, drawSprite(98, 21, _)).Times(1).WillOnce(Return(false));
-    auto result = testedBus->drawSprite(98, 21, std::vector<u8>::iterator());
+    auto result = testedBus->drawSprite(98, 21, nullptr);
     EXPECT_FALSE(result);
 }
 
 TEST_F(BusImplTests, testDrawSprite_collided)
 {
     EXPECT_CALL(*graphics, drawSprite(98, 21, _)).Times(1).WillOnce(Return(true));
-    auto result = testedBus->drawSprite(98, 21, std::vector<u8>::iterator());
+    auto result = testedBus->drawSprite(98, 21, nullptr);
     EXPECT_TRUE(result);
 }
 
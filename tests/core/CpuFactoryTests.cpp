@@ -0,0 +1,53 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../../src/core/CpuFactory.hpp"
+#include "../../src/core/JitCpuImpl.hpp"
+#include "../../src/core/MemoryImpl.hpp"
+#include "../../src/core/BusImpl.hpp"
+#include "../../src/core/GraphicsImpl.hpp"
+
+namespace
+{
+    class CpuFactoryTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            memory = std::make_shared<MemoryImpl>();
+            bus = std::make_shared<StaticBusImpl>(std::make_shared<GraphicsImpl>());
+        }
+
+        std::shared_ptr<MemoryImpl> memory;
+        std::shared_ptr<StaticBusImpl> bus;
+    };
+}
+
+TEST_F(CpuFactoryTests, createInterpreterTest)
+{
+    auto cpu = CpuFactory::create(CpuBackend::INTERPRETER, memory, bus);
+    ASSERT_NE(nullptr, cpu);
+#if CHIP16_JIT_SUPPORTED
+    EXPECT_EQ(nullptr, dynamic_cast<JitCpuImpl*>(cpu.get()));
+#endif
+}
+
+TEST_F(CpuFactoryTests, createJitFallsBackToInterpreterWhenNotSupportedTest)
+{
+    auto cpu = CpuFactory::create(CpuBackend::JIT, memory, bus);
+    ASSERT_NE(nullptr, cpu);
+#if CHIP16_JIT_SUPPORTED
+    EXPECT_TRUE(CpuFactory::isSupported(CpuBackend::JIT));
+    EXPECT_NE(nullptr, dynamic_cast<JitCpuImpl*>(cpu.get()));
+#else
+    EXPECT_FALSE(CpuFactory::isSupported(CpuBackend::JIT));
+#endif
+}
+
+TEST_F(CpuFactoryTests, parseBackendTest)
+{
+    EXPECT_EQ(CpuBackend::INTERPRETER, CpuFactory::parseBackend("interpreter", CpuBackend::JIT));
+    EXPECT_EQ(CpuBackend::JIT, CpuFactory::parseBackend("jit", CpuBackend::INTERPRETER));
+    EXPECT_EQ(CpuBackend::JIT, CpuFactory::parseBackend("unknown", CpuBackend::JIT));
+}
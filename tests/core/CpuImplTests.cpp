@@ -52,4 +52,250 @@ TEST_F(CpuImplTests, pushIntoStackTest)
     EXPECT_CALL(*memory, writeWord(0xFFE0, 0x7777)).Times(1);
     testedCpu->pushIntoStack(0x7777);
     EXPECT_EQ(0xFFE2, regs.sp);
-}
\ No newline at end of file
+}
+
+TEST_F(CpuImplTests, stepTest)
+{
+    // LDI R5, 0x1234
+    auto& regs = testedCpu->getRegisters();
+    regs.pc = 0x120;
+    EXPECT_CALL(*memory, readInstruction(0x120)).Times(1).WillOnce(Return(0x12342005));
+    testedCpu->step();
+    EXPECT_EQ(0x1234, regs.r[5]);
+    EXPECT_EQ(0x124, regs.pc);
+}
+
+TEST_F(CpuImplTests, stepUsesDecodedInstructionTest)
+{
+    // LDI R5, 0x1234 executed twice is decoded once
+    auto& regs = testedCpu->getRegisters();
+    EXPECT_CALL(*memory, readInstruction(0x120)).Times(1).WillOnce(Return(0x12342005));
+    regs.pc = 0x120;
+    testedCpu->step();
+    regs.r[5] = 0;
+    regs.pc = 0x120;
+    testedCpu->step();
+    EXPECT_EQ(0x1234, regs.r[5]);
+}
+
+TEST_F(CpuImplTests, stepDecodesAgainAfterMemoryWriteTest)
+{
+    // LDI R5, 0x1234 overwritten with LDI R5, 0x4321
+    auto& regs = testedCpu->getRegisters();
+    EXPECT_CALL(*memory, readInstruction(0x120)).Times(2)
+        .WillOnce(Return(0x12342005))
+        .WillOnce(Return(0x43212005));
+    regs.pc = 0x120;
+    testedCpu->step();
+    testedCpu->onMemoryWrite(0x122, 2);
+    regs.pc = 0x120;
+    testedCpu->step();
+    EXPECT_EQ(0x4321, regs.r[5]);
+}
+
+TEST_F(CpuImplTests, lazyFlagsMaterializedByGetRegistersTest)
+{
+    // ADDI R0, 1 with R0 = 0xFFFF sets carry and zero
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setLazyFlags(true);
+    regs.pc = 0x120;
+    regs.r[0] = 0xFFFF;
+    regs.flags.raw = 0;
+    EXPECT_CALL(*memory, readWord(0x120)).Times(1).WillOnce(Return(0x0001));
+    testedCpu->executeInstruction(0x4000);
+    EXPECT_EQ(0, regs.flags.raw);
+    auto& materialized = testedCpu->getRegisters();
+    EXPECT_EQ(1, materialized.flags.c);
+    EXPECT_EQ(1, materialized.flags.z);
+    EXPECT_EQ(0, materialized.flags.o);
+    EXPECT_EQ(0, materialized.flags.n);
+}
+
+TEST_F(CpuImplTests, lazyFlagsLogicalOperationPreservesCarryTest)
+{
+    // ADDI R0, 1 with R0 = 0xFFFF followed by ORI R0, 0x8000
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setLazyFlags(true);
+    regs.pc = 0x120;
+    regs.r[0] = 0xFFFF;
+    regs.flags.raw = 0;
+    EXPECT_CALL(*memory, readWord(0x120)).Times(1).WillOnce(Return(0x0001));
+    testedCpu->executeInstruction(0x4000);
+    regs.pc = 0x120;
+    EXPECT_CALL(*memory, readWord(0x120)).Times(1).WillOnce(Return(0x8000));
+    testedCpu->executeInstruction(0x7000);
+    auto& materialized = testedCpu->getRegisters();
+    EXPECT_EQ(1, materialized.flags.c);
+    EXPECT_EQ(0, materialized.flags.z);
+    EXPECT_EQ(1, materialized.flags.n);
+}
+
+TEST_F(CpuImplTests, lazyFlagsBranchConditionTest)
+{
+    // CMPI R0, 5 with R0 = 5 followed by JZ 0x300
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setLazyFlags(true);
+    regs.pc = 0x120;
+    regs.r[0] = 5;
+    EXPECT_CALL(*memory, readWord(0x120)).Times(2)
+        .WillOnce(Return(0x0005))
+        .WillOnce(Return(0x0300));
+    testedCpu->executeInstruction(0x5300);
+    regs.pc = 0x120;
+    testedCpu->executeInstruction(0x1200);
+    EXPECT_EQ(0x300, regs.pc);
+}
+
+TEST_F(CpuImplTests, deadFlagsEliminationSkipsOverwrittenFlagsTest)
+{
+    // ADDI R0, 1 followed by CMPI R1, 2 and JZ 0x300
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setDeadFlagsElimination(true);
+    ON_CALL(*memory, readWord(0x120)).WillByDefault(Return(0x4000));
+    ON_CALL(*memory, readWord(0x122)).WillByDefault(Return(0x0001));
+    ON_CALL(*memory, readWord(0x124)).WillByDefault(Return(0x5301));
+    ON_CALL(*memory, readWord(0x126)).WillByDefault(Return(0x0002));
+    ON_CALL(*memory, readWord(0x128)).WillByDefault(Return(0x1200));
+    ON_CALL(*memory, readWord(0x12A)).WillByDefault(Return(0x0300));
+    regs.pc = 0x120;
+    regs.r[0] = 0xFFFF;
+    regs.r[1] = 2;
+    regs.flags.raw = 0;
+    testedCpu->step();
+    EXPECT_EQ(0, regs.r[0]);
+    EXPECT_EQ(0, regs.flags.raw);
+    testedCpu->step();
+    EXPECT_EQ(1, regs.flags.z);
+    testedCpu->step();
+    EXPECT_EQ(0x300, regs.pc);
+}
+
+TEST_F(CpuImplTests, deadFlagsCrossCheckEvaluatesAllFlagsTest)
+{
+    // ADDI R0, 1 followed by CMPI R1, 2 and JZ 0x300
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setDeadFlagsElimination(true);
+    testedCpu->setDeadFlagsCrossCheck(true);
+    ON_CALL(*memory, readWord(0x120)).WillByDefault(Return(0x4000));
+    ON_CALL(*memory, readWord(0x122)).WillByDefault(Return(0x0001));
+    ON_CALL(*memory, readWord(0x124)).WillByDefault(Return(0x5301));
+    ON_CALL(*memory, readWord(0x126)).WillByDefault(Return(0x0002));
+    ON_CALL(*memory, readWord(0x128)).WillByDefault(Return(0x1200));
+    ON_CALL(*memory, readWord(0x12A)).WillByDefault(Return(0x0300));
+    regs.pc = 0x120;
+    regs.r[0] = 0xFFFF;
+    regs.r[1] = 2;
+    regs.flags.raw = 0;
+    testedCpu->step();
+    EXPECT_EQ(1, regs.flags.c);
+    testedCpu->step();
+    testedCpu->step();
+    EXPECT_EQ(0x300, regs.pc);
+    EXPECT_EQ(0, testedCpu->getDeadFlagsCheckFailures());
+}
+
+TEST_F(CpuImplTests, fusedCompareAndJumpExecutesInOneStepTest)
+{
+    // CMPI R1, 2 followed by JZ 0x300
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setInstructionFusion(true);
+    ON_CALL(*memory, readWord(0x120)).WillByDefault(Return(0x5301));
+    ON_CALL(*memory, readWord(0x122)).WillByDefault(Return(0x0002));
+    ON_CALL(*memory, readWord(0x124)).WillByDefault(Return(0x1200));
+    ON_CALL(*memory, readWord(0x126)).WillByDefault(Return(0x0300));
+    regs.pc = 0x120;
+    regs.r[1] = 2;
+    testedCpu->step();
+    EXPECT_EQ(0x300, regs.pc);
+    EXPECT_EQ(1, regs.flags.z);
+    const auto statistics = testedCpu->getFusionStatistics();
+    ASSERT_EQ(4, statistics.size());
+    EXPECT_STREQ("CMPI+Jx", statistics[0].first);
+    EXPECT_EQ(1, statistics[0].second);
+}
+
+TEST_F(CpuImplTests, fusedCompareAndJumpKeepsFlagsPendingTest)
+{
+    // CMPI R1, 2 followed by JB 0x300 with R1 = 1
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setInstructionFusion(true);
+    testedCpu->setLazyFlags(true);
+    ON_CALL(*memory, readWord(0x120)).WillByDefault(Return(0x5301));
+    ON_CALL(*memory, readWord(0x122)).WillByDefault(Return(0x0002));
+    ON_CALL(*memory, readWord(0x124)).WillByDefault(Return(0x1209));
+    ON_CALL(*memory, readWord(0x126)).WillByDefault(Return(0x0300));
+    regs.pc = 0x120;
+    regs.r[1] = 1;
+    regs.flags.raw = 0;
+    testedCpu->step();
+    EXPECT_EQ(0x300, regs.pc);
+    EXPECT_EQ(FlagsOperation::SUBTRACTION, regs.pendingFlags.operation);
+    EXPECT_EQ(0, regs.flags.raw);
+    auto& materialized = testedCpu->getRegisters();
+    EXPECT_EQ(1, materialized.flags.c);
+    EXPECT_EQ(0, materialized.flags.z);
+    EXPECT_EQ(1, materialized.flags.n);
+}
+
+// Sequences accessing memory before their last instruction are not fused with watchpoints
+#if !defined(CHIP16_WATCHPOINTS)
+TEST_F(CpuImplTests, fusedLoadAddStoreExecutesInOneStepTest)
+{
+    // LDM R2, 0x500 followed by ADDI R2, 3 and STM R2, 0x500
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setInstructionFusion(true);
+    ON_CALL(*memory, readWord(0x120)).WillByDefault(Return(0x2202));
+    ON_CALL(*memory, readWord(0x122)).WillByDefault(Return(0x0500));
+    ON_CALL(*memory, readWord(0x124)).WillByDefault(Return(0x4002));
+    ON_CALL(*memory, readWord(0x126)).WillByDefault(Return(0x0003));
+    ON_CALL(*memory, readWord(0x128)).WillByDefault(Return(0x3002));
+    ON_CALL(*memory, readWord(0x12A)).WillByDefault(Return(0x0500));
+    ON_CALL(*memory, readWord(0x500)).WillByDefault(Return(0x0040));
+    EXPECT_CALL(*memory, writeWord(0x500, 0x0043)).Times(1);
+    regs.pc = 0x120;
+    testedCpu->step();
+    EXPECT_EQ(0x0043, regs.r[2]);
+    EXPECT_EQ(0x12C, regs.pc);
+    EXPECT_EQ(1, testedCpu->getFusionStatistics()[3].second);
+}
+#endif
+
+TEST_F(CpuImplTests, jumpIntoFusedSequenceExecutesSingleInstructionTest)
+{
+    // LDI R0, 5 followed by ADD R1, R0, entered at ADD
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->setInstructionFusion(true);
+    ON_CALL(*memory, readWord(0x120)).WillByDefault(Return(0x2000));
+    ON_CALL(*memory, readWord(0x122)).WillByDefault(Return(0x0005));
+    ON_CALL(*memory, readWord(0x124)).WillByDefault(Return(0x4101));
+    ON_CALL(*memory, readWord(0x126)).WillByDefault(Return(0x0000));
+    regs.pc = 0x120;
+    regs.r[1] = 1;
+    testedCpu->step();
+    EXPECT_EQ(0x128, regs.pc);
+    EXPECT_EQ(6, regs.r[1]);
+    regs.pc = 0x124;
+    testedCpu->step();
+    EXPECT_EQ(0x128, regs.pc);
+    EXPECT_EQ(11, regs.r[1]);
+    EXPECT_EQ(1, testedCpu->getFusionStatistics()[2].second);
+}
+
+TEST_F(CpuImplTests, randomIsReproducibleWithSeedTest)
+{
+    // RND R0, 0x7FFF executed by two cpus seeded the same way
+    auto otherCpu = std::make_unique<CpuImpl>(memory, bus);
+    testedCpu->setRandomSeed(0x1234);
+    otherCpu->setRandomSeed(0x1234);
+    EXPECT_EQ(0x1234, testedCpu->getRandomSeed());
+    ON_CALL(*memory, readWord(0x120)).WillByDefault(Return(0x7FFF));
+    for (auto i = 0; i < 16; i++)
+    {
+        testedCpu->getRegisters().pc = 0x120;
+        otherCpu->getRegisters().pc = 0x120;
+        testedCpu->executeInstruction(0x0700);
+        otherCpu->executeInstruction(0x0700);
+        EXPECT_EQ(testedCpu->getRegisters().r[0], otherCpu->getRegisters().r[0]);
+        EXPECT_GE(0x7FFF, testedCpu->getRegisters().r[0]);
+    }
+}
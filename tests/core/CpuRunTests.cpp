@@ -0,0 +1,274 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../mocks/BusMock.hpp"
+
+#include "../helpers/InstructionWriter.hpp"
+
+#include "../../src/core/CpuImpl.hpp"
+#include "../../src/core/MemoryImpl.hpp"
+
+namespace
+{
+    using ::testing::Return;
+
+    class CpuRunTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            memory = std::make_shared<MemoryImpl>();
+            bus = std::make_shared<BusMock>();
+            testedCpu = std::make_unique<CpuImpl>(memory, bus);
+        }
+
+        std::unique_ptr<CpuImpl> testedCpu;
+        std::shared_ptr<MemoryImpl> memory;
+        std::shared_ptr<BusMock> bus;
+    };
+}
+
+TEST_F(CpuRunTests, runStopsWhenBudgetIsExhaustedTest)
+{
+    // Memory is filled with NOPs
+    auto result = testedCpu->run(10);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(0x0028, testedCpu->getRegisters().pc);
+}
+
+TEST_F(CpuRunTests, runStopsWhenWaitingForVBlankTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x1234);  // LDI R0, 0x1234
+    writeInstruction(*memory, 0x04, 0x0200, 0x0000);  // VBLNK
+    EXPECT_CALL(*bus, isVBlank()).WillOnce(Return(false));
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::VBLANK, result);
+    EXPECT_EQ(0x1234, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(0x0004, testedCpu->getRegisters().pc);
+}
+
+TEST_F(CpuRunTests, runPassesVBlnkDuringVBlankTest)
+{
+    writeInstruction(*memory, 0x00, 0x0200, 0x0000);  // VBLNK
+    EXPECT_CALL(*bus, isVBlank()).WillOnce(Return(true));
+    EXPECT_CALL(*bus, setVBlank(false)).Times(1);
+    auto result = testedCpu->run(3);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(0x000C, testedCpu->getRegisters().pc);
+}
+
+TEST_F(CpuRunTests, runStopsAtBreakpointAndResumesTest)
+{
+    testedCpu->setBreakpoint(0x0008, true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::BREAKPOINT, result);
+    EXPECT_EQ(0x0008, testedCpu->getRegisters().pc);
+
+    result = testedCpu->run(2);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(0x0010, testedCpu->getRegisters().pc);
+
+    testedCpu->setBreakpoint(0x0008, false);
+    testedCpu->getRegisters().pc = 0x0000;
+    result = testedCpu->run(4);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(0x0010, testedCpu->getRegisters().pc);
+}
+
+TEST_F(CpuRunTests, runStopsAtInvalidOpcodeTest)
+{
+    writeInstruction(*memory, 0x04, 0xFF00, 0x0000);  // Invalid opcode
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::INVALID_OPCODE, result);
+}
+
+TEST_F(CpuRunTests, runStopsAtBreakpointInsideFusedSequenceTest)
+{
+    writeInstruction(*memory, 0x00, 0x5300, 0x0001);  // CMPI R0, 1
+    writeInstruction(*memory, 0x04, 0x1200, 0x0100);  // JZ 0x100
+    testedCpu->setInstructionFusion(true);
+    testedCpu->setBreakpoint(0x0004, true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::BREAKPOINT, result);
+    EXPECT_EQ(0x0004, testedCpu->getRegisters().pc);
+    EXPECT_EQ(0, testedCpu->getFusionStatistics()[0].second);
+}
+
+TEST_F(CpuRunTests, cycleCounterCountsExecutedInstructionsTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x0001);  // LDI R0, 1
+    writeInstruction(*memory, 0x04, 0x2001, 0x0002);  // LDI R1, 2
+    writeInstruction(*memory, 0x08, 0x4101, 0x0000);  // ADD R1, R0
+    testedCpu->setInstructionFusion(true);
+    testedCpu->step();
+    EXPECT_EQ(1, testedCpu->getCycles());
+    testedCpu->step();
+    EXPECT_EQ(3, testedCpu->getCycles());
+    testedCpu->run(5);
+    EXPECT_EQ(8, testedCpu->getCycles());
+}
+
+TEST_F(CpuRunTests, fusedCompareAndJumpMatchesSeparateInstructionsTest)
+{
+    const std::vector<std::pair<u16, u16>> OPERANDS = {
+        { 0x0000, 0x0000 }, { 0x0000, 0x0001 }, { 0x0001, 0x0000 }, { 0x8000, 0x0000 },
+        { 0x8000, 0x0001 }, { 0x7FFF, 0xFFFF }, { 0x8000, 0x8000 }, { 0x0003, 0x8000 }
+    };
+    for (u16 condition = 0; condition < 15; condition++)
+    {
+        for (const auto& [value, immediate] : OPERANDS)
+        {
+            writeInstruction(*memory, 0x00, 0x5300, immediate);            // CMPI R0, immediate
+            writeInstruction(*memory, 0x04, 0x1200 | condition, 0x0100);   // Jx 0x100
+            CpuImpl separateCpu(memory, bus);
+            CpuImpl fusedCpu(memory, bus);
+            fusedCpu.setInstructionFusion(true);
+            fusedCpu.setLazyFlags(true);
+            separateCpu.getRegisters().r[0] = value;
+            fusedCpu.getRegisters().r[0] = value;
+            separateCpu.run(2);
+            fusedCpu.run(2);
+            EXPECT_EQ(separateCpu.getRegisters().pc, fusedCpu.getRegisters().pc)
+                << "condition " << condition << ", operands " << value << ", " << immediate;
+            EXPECT_EQ(separateCpu.getRegisters().flags.raw, fusedCpu.getRegisters().flags.raw);
+        }
+    }
+}
+
+TEST_F(CpuRunTests, skipCyclesAdvancesCycleCounterOnlyTest)
+{
+    testedCpu->skipCycles(1000);
+    EXPECT_EQ(1000, testedCpu->getCycles());
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().pc);
+}
+
+TEST_F(CpuRunTests, runSkipsIterationsOfIdleLoopTest)
+{
+    writeInstruction(*memory, 0x00, 0x2200, 0x0200);  // LDM R0, 0x200
+    writeInstruction(*memory, 0x04, 0x6300, 0x0001);  // TSTI R0, 1
+    writeInstruction(*memory, 0x08, 0x1200, 0x0000);  // JZ 0x0
+    testedCpu->setIdleLoopDetection(true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::IDLE_LOOP, result);
+    EXPECT_EQ(99, testedCpu->getCycles());
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().pc);
+    ASSERT_EQ(1, testedCpu->getIdleLoopStatistics().size());
+    EXPECT_EQ(0x0000, testedCpu->getIdleLoopStatistics()[0].first);
+    EXPECT_EQ(93, testedCpu->getIdleLoopStatistics()[0].second);
+
+    // Remaining budget is executed the same way as without detection
+    result = testedCpu->run(1);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(0x0004, testedCpu->getRegisters().pc);
+}
+
+TEST_F(CpuRunTests, runLeavesIdleLoopWhenPolledMemoryChangesTest)
+{
+    writeInstruction(*memory, 0x00, 0x2200, 0x0200);  // LDM R0, 0x200
+    writeInstruction(*memory, 0x04, 0x5300, 0x0000);  // CMPI R0, 0
+    writeInstruction(*memory, 0x08, 0x1200, 0x0000);  // JZ 0x0
+    testedCpu->setIdleLoopDetection(true);
+    testedCpu->setInstructionFusion(true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::IDLE_LOOP, result);
+
+    memory->writeWord(0x200, 1);
+    result = testedCpu->run(10);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(0x0001, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(0x0028, testedCpu->getRegisters().pc);
+}
+
+TEST_F(CpuRunTests, runExecutesLoopModifyingRegistersTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->setIdleLoopDetection(true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(50, testedCpu->getRegisters().r[0]);
+    EXPECT_TRUE(testedCpu->getIdleLoopStatistics().empty());
+}
+
+TEST_F(CpuRunTests, exportedCodeIsImportedWhileMemoryContainsItTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->run(4);
+    const auto blocks = testedCpu->exportCode();
+    ASSERT_EQ(1, blocks.size());
+    EXPECT_EQ(0x0000, blocks[0].startAddress);
+    EXPECT_EQ(8, blocks[0].size);
+
+    auto importingCpu = std::make_unique<CpuImpl>(memory, bus);
+    EXPECT_EQ(1, importingCpu->importCode(blocks));
+    const auto imported = importingCpu->exportCode();
+    ASSERT_EQ(1, imported.size());
+    EXPECT_EQ(blocks[0].size, imported[0].size);
+    EXPECT_EQ(blocks[0].checksum, imported[0].checksum);
+
+    writeInstruction(*memory, 0x00, 0x4000, 0x0002);  // ADDI R0, 2
+    EXPECT_EQ(0, importingCpu->importCode(blocks));
+}
+
+TEST_F(CpuRunTests, restoredSnapshotRepeatsExecutionTest)
+{
+    writeInstruction(*memory, 0x00, 0x0700, 0xFFFF);  // RND R0, 0xFFFF
+    writeInstruction(*memory, 0x04, 0x4001, 0x0001);  // ADDI R1, 1
+    writeInstruction(*memory, 0x08, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->run(4);
+    const auto snapshot = testedCpu->takeSnapshot();
+
+    testedCpu->run(30);
+    const auto registers = testedCpu->getRegisters();
+    const auto cycles = testedCpu->getCycles();
+
+    testedCpu->restoreSnapshot(snapshot);
+    EXPECT_EQ(4, testedCpu->getCycles());
+    testedCpu->run(30);
+    EXPECT_EQ(registers.r[0], testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(registers.r[1], testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(registers.pc, testedCpu->getRegisters().pc);
+    EXPECT_EQ(cycles, testedCpu->getCycles());
+}
+
+#if defined(CHIP16_WATCHPOINTS)
+TEST_F(CpuRunTests, runStopsAfterInstructionWritingWatchedRangeTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x1234);  // LDI R0, 0x1234
+    writeInstruction(*memory, 0x04, 0x3000, 0x0400);  // STM R0, 0x400
+    writeInstruction(*memory, 0x08, 0x4001, 0x0001);  // ADDI R1, 1
+    memory->addWatchpoint(0x0400, 2, MemoryImpl::WatchAccess::WRITE);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::WATCHPOINT, result);
+    EXPECT_EQ(0x1234, memory->readWord(0x0400));
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(0x0008, testedCpu->getRegisters().pc);
+    const auto hit = testedCpu->getWatchpointHit();
+    EXPECT_EQ(0x0004, hit.pc);
+    EXPECT_EQ(0x0400, hit.addr);
+    EXPECT_TRUE(hit.write);
+
+    result = testedCpu->run(1);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(0x0001, testedCpu->getRegisters().r[1]);
+}
+
+TEST_F(CpuRunTests, watchpointStopsBeforeRestOfFusableSequenceTest)
+{
+    writeInstruction(*memory, 0x00, 0x2200, 0x0400);  // LDM R0, 0x400
+    writeInstruction(*memory, 0x04, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x08, 0x3000, 0x0400);  // STM R0, 0x400
+    testedCpu->setInstructionFusion(true);
+    memory->addWatchpoint(0x0400, 2, MemoryImpl::WatchAccess::READ_WRITE);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::WATCHPOINT, result);
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(0x0004, testedCpu->getRegisters().pc);
+    EXPECT_EQ(0x0000, memory->readWord(0x0400));
+    const auto hit = testedCpu->getWatchpointHit();
+    EXPECT_EQ(0x0000, hit.pc);
+    EXPECT_FALSE(hit.write);
+}
+#endif
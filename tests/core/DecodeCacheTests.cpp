@@ -0,0 +1,61 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../../src/core/DecodeCache.hpp"
+
+namespace
+{
+    class DecodeCacheTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            testedCache = std::make_unique<DecodeCache<u16>>();
+        }
+
+        std::unique_ptr<DecodeCache<u16>> testedCache;
+    };
+}
+
+TEST_F(DecodeCacheTests, testFindNotDecoded)
+{
+    EXPECT_EQ(nullptr, testedCache->find(0x100));
+}
+
+TEST_F(DecodeCacheTests, testInsertAndFind)
+{
+    testedCache->insert(0x100, 0x5555);
+    ASSERT_NE(nullptr, testedCache->find(0x100));
+    EXPECT_EQ(0x5555, *testedCache->find(0x100));
+    EXPECT_EQ(nullptr, testedCache->find(0x104));
+}
+
+TEST_F(DecodeCacheTests, testInvalidateOverlappingInstructions)
+{
+    testedCache->insert(0xFC, 0x1111);
+    testedCache->insert(0x100, 0x2222);
+    testedCache->insert(0x104, 0x3333);
+
+    testedCache->invalidate(0x103, 1);
+
+    EXPECT_NE(nullptr, testedCache->find(0xFC));
+    EXPECT_EQ(nullptr, testedCache->find(0x100));
+    EXPECT_NE(nullptr, testedCache->find(0x104));
+}
+
+TEST_F(DecodeCacheTests, testInvalidateWrapsAroundAddressSpace)
+{
+    testedCache->insert(0xFFFE, 0x1111);
+    testedCache->invalidate(0x0001, 1);
+    EXPECT_EQ(nullptr, testedCache->find(0xFFFE));
+}
+
+TEST_F(DecodeCacheTests, testInvalidateWholeMemory)
+{
+    testedCache->insert(0x0000, 0x1111);
+    testedCache->insert(0x8000, 0x2222);
+    testedCache->invalidate(0x0000, 0x10000);
+    EXPECT_EQ(nullptr, testedCache->find(0x0000));
+    EXPECT_EQ(nullptr, testedCache->find(0x8000));
+}
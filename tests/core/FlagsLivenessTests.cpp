@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include "../../src/core/FlagsLiveness.hpp"
+
+TEST(FlagsLivenessTests, testFlagsOverwrittenBeforeReadAreDead)
+{
+    const auto deadFlags = FlagsLiveness::findDeadFlags({
+        Operation::ADD_IMMEDIATE, Operation::COMPARE_IMMEDIATE, Operation::JUMP_CONDITIONALLY });
+    EXPECT_EQ(InstructionSet::ALL_FLAGS, deadFlags[0]);
+    EXPECT_EQ(0, deadFlags[1]);
+    EXPECT_EQ(0, deadFlags[2]);
+}
+
+TEST(FlagsLivenessTests, testPartiallyOverwrittenFlagsStayLive)
+{
+    const auto deadFlags = FlagsLiveness::findDeadFlags({
+        Operation::ADD_REGISTER, Operation::BITWISE_AND_IMMEDIATE, Operation::JUMP_CARRY });
+    EXPECT_EQ(InstructionSet::ZERO_FLAG | InstructionSet::NEGATIVE_FLAG, deadFlags[0]);
+    EXPECT_EQ(0, deadFlags[1]);
+}
+
+TEST(FlagsLivenessTests, testFlagsAreLiveAtTheEndOfSequence)
+{
+    const auto deadFlags = FlagsLiveness::findDeadFlags({
+        Operation::SUBTRACT_IMMEDIATE, Operation::LOAD_REGISTER_IMMEDIATE });
+    EXPECT_EQ(0, deadFlags[0]);
+}
+
+TEST(FlagsLivenessTests, testFlagsAreLiveBeforeMemoryWrite)
+{
+    const auto deadFlags = FlagsLiveness::findDeadFlags({
+        Operation::ADD_IMMEDIATE, Operation::STORE_INDIRECT, Operation::COMPARE_IMMEDIATE, Operation::JUMP });
+    EXPECT_EQ(0, deadFlags[0]);
+    EXPECT_EQ(0, deadFlags[2]);
+}
+
+TEST(FlagsLivenessTests, testPushFlagsReadsAllFlags)
+{
+    const auto deadFlags = FlagsLiveness::findDeadFlags({
+        Operation::MULTIPLY_IMMEDIATE, Operation::PUSH_FLAGS, Operation::POP_FLAGS, Operation::RETURN });
+    EXPECT_EQ(0, deadFlags[0]);
+}
@@ -71,7 +71,7 @@ TEST_F(GraphicsImplTests, testDrawSprite_noFlip)
 
     const auto SPRITE1_POSX = 3;
     const auto SPRITE1_POSY = 0;
-    auto result = testedGraphics->drawSprite(SPRITE1_POSX, SPRITE1_POSY, TEST_SPRITE.begin());
+    auto result = testedGraphics->drawSprite(SPRITE1_POSX, SPRITE1_POSY, TEST_SPRITE.data());
     EXPECT_EQ(0, result);
     auto screenBuffer = testedGraphics->getScreenBuffer();
     EXPECT_EQ(0x03, screenBuffer[1]);
@@ -82,7 +82,7 @@ TEST_F(GraphicsImplTests, testDrawSprite_noFlip)
 
     const auto SPRITE2_POSX = 6;
     const auto SPRITE2_POSY = 0;
-    result = testedGraphics->drawSprite(SPRITE2_POSX, SPRITE2_POSY, TEST_SPRITE.begin());
+    result = testedGraphics->drawSprite(SPRITE2_POSX, SPRITE2_POSY, TEST_SPRITE.data());
     EXPECT_EQ(1, result);
     screenBuffer = testedGraphics->getScreenBuffer();
     EXPECT_EQ(0x03, screenBuffer[1]);
@@ -106,7 +106,7 @@ TEST_F(GraphicsImplTests, testDrawSprite_hFlip)
 
     const auto SPRITE1_POSX = 3;
     const auto SPRITE1_POSY = 0;
-    auto result = testedGraphics->drawSprite(SPRITE1_POSX, SPRITE1_POSY, TEST_SPRITE.begin());
+    auto result = testedGraphics->drawSprite(SPRITE1_POSX, SPRITE1_POSY, TEST_SPRITE.data());
     EXPECT_EQ(0, result);
     auto screenBuffer = testedGraphics->getScreenBuffer();
     EXPECT_EQ(0x0A, screenBuffer[1]);
@@ -117,7 +117,7 @@ TEST_F(GraphicsImplTests, testDrawSprite_hFlip)
 
     const auto SPRITE2_POSX = 6;
     const auto SPRITE2_POSY = 0;
-    result = testedGraphics->drawSprite(SPRITE2_POSX, SPRITE2_POSY, TEST_SPRITE.begin());
+    result = testedGraphics->drawSprite(SPRITE2_POSX, SPRITE2_POSY, TEST_SPRITE.data());
     EXPECT_EQ(1, result);
     screenBuffer = testedGraphics->getScreenBuffer();
     EXPECT_EQ(0x0A, screenBuffer[1]);
@@ -142,7 +142,7 @@ TEST_F(GraphicsImplTests, testDrawSprite_vFlip)
 
     const auto SPRITE1_POSX = 3;
     const auto SPRITE1_POSY = 0;
-    auto result = testedGraphics->drawSprite(SPRITE1_POSX, SPRITE1_POSY, TEST_SPRITE.begin());
+    auto result = testedGraphics->drawSprite(SPRITE1_POSX, SPRITE1_POSY, TEST_SPRITE.data());
     EXPECT_EQ(0, result);
     auto screenBuffer = testedGraphics->getScreenBuffer();
     EXPECT_EQ(0x0A, screenBuffer[1]);
@@ -153,7 +153,7 @@ TEST_F(GraphicsImplTests, testDrawSprite_vFlip)
 
     const auto SPRITE2_POSX = 6;
     const auto SPRITE2_POSY = 0;
-    result = testedGraphics->drawSprite(SPRITE2_POSX, SPRITE2_POSY, TEST_SPRITE.begin());
+    result = testedGraphics->drawSprite(SPRITE2_POSX, SPRITE2_POSY, TEST_SPRITE.data());
     EXPECT_EQ(1, result);
     screenBuffer = testedGraphics->getScreenBuffer();
     EXPECT_EQ(0x0A, screenBuffer[1]);
@@ -178,7 +178,7 @@ TEST_F(GraphicsImplTests, testDrawSprite_hvFlip)
 
     const auto SPRITE1_POSX = 3;
     const auto SPRITE1_POSY = 0;
-    auto result = testedGraphics->drawSprite(SPRITE1_POSX, SPRITE1_POSY, TEST_SPRITE.begin());
+    auto result = testedGraphics->drawSprite(SPRITE1_POSX, SPRITE1_POSY, TEST_SPRITE.data());
     EXPECT_EQ(0, result);
     auto screenBuffer = testedGraphics->getScreenBuffer();
     EXPECT_EQ(0x03, screenBuffer[1]);
@@ -189,7 +189,7 @@ TEST_F(GraphicsImplTests, testDrawSprite_hvFlip)
 
     const auto SPRITE2_POSX = 6;
     const auto SPRITE2_POSY = 0;
-    result = testedGraphics->drawSprite(SPRITE2_POSX, SPRITE2_POSY, TEST_SPRITE.begin());
+    result = testedGraphics->drawSprite(SPRITE2_POSX, SPRITE2_POSY, TEST_SPRITE.data());
     EXPECT_EQ(1, result);
     screenBuffer = testedGraphics->getScreenBuffer();
     EXPECT_EQ(0x03, screenBuffer[1]);
@@ -198,4 +198,22 @@ TEST_F(GraphicsImplTests, testDrawSprite_hvFlip)
     EXPECT_EQ(0x56, screenBuffer[4]);
     EXPECT_EQ(0x78, screenBuffer[5]);
     EXPECT_EQ(0x9A, screenBuffer[6]);
-}
\ No newline at end of file
+}
+
+TEST_F(GraphicsImplTests, testRestoreSnapshot)
+{
+    const std::vector<u8> TEST_SPRITE = { 0x34 };
+    testedGraphics->setSpriteDimensions(1, 1);
+    const auto snapshot = testedGraphics->takeSnapshot();
+    EXPECT_EQ(snapshot.buffer, testedGraphics->takeSnapshot().buffer);
+
+    testedGraphics->drawSprite(0, 0, TEST_SPRITE.data());
+    testedGraphics->setBackgroundColorIndex(5);
+    testedGraphics->setVBlank(true);
+    testedGraphics->restoreSnapshot(snapshot);
+
+    EXPECT_EQ(0x00, testedGraphics->getScreenBuffer()[0]);
+    EXPECT_EQ(0, testedGraphics->getBackgroundColorIndex());
+    EXPECT_EQ(1, testedGraphics->getRegisters().spritew);
+    EXPECT_FALSE(testedGraphics->isVBlank());
+}
@@ -80,8 +80,8 @@ TEST_F(GraphicsInstructionsTests, testDrawSpriteImmedate_notCollided)
     regs.pc = 0x102;
     regs.flags.c = 1;
     EXPECT_CALL(*memory, readWord(0x102)).Times(1).WillOnce(Return(0x2000));
-    EXPECT_CALL(*memory, readByteReference(0x2000)).Times(1).WillOnce(Return(TEST_SPRITE.begin()));
-    EXPECT_CALL(*bus, drawSprite(1, 5, Eq(TEST_SPRITE.begin()))).Times(1).WillOnce(Return(false));
+    EXPECT_CALL(*memory, readByteReference(0x2000)).Times(1).WillOnce(Return(TEST_SPRITE.data()));
+    EXPECT_CALL(*bus, drawSprite(1, 5, Eq(TEST_SPRITE.data()))).Times(1).WillOnce(Return(false));
     testedCpu->executeInstruction(DRAW_SPRITE_IMMEDATE_INSTRUCTION_OPCODE
         + REG_INDEX_X + (REG_INDEX_Y << 4));
     EXPECT_EQ(0, regs.flags.c);
@@ -104,8 +104,8 @@ TEST_F(GraphicsInstructionsTests, testDrawSpriteImmedate_collided)
     regs.pc = 0x102;
     regs.flags.c = 0;
     EXPECT_CALL(*memory, readWord(0x102)).Times(1).WillOnce(Return(0x2000));
-    EXPECT_CALL(*memory, readByteReference(0x2000)).Times(1).WillOnce(Return(TEST_SPRITE.begin()));
-    EXPECT_CALL(*bus, drawSprite(1, 5, Eq(TEST_SPRITE.begin()))).Times(1).WillOnce(Return(true));
+    EXPECT_CALL(*memory, readByteReference(0x2000)).Times(1).WillOnce(Return(TEST_SPRITE.data()));
+    EXPECT_CALL(*bus, drawSprite(1, 5, Eq(TEST_SPRITE.data()))).Times(1).WillOnce(Return(true));
     testedCpu->executeInstruction(DRAW_SPRITE_IMMEDATE_INSTRUCTION_OPCODE
         + REG_INDEX_X + (REG_INDEX_Y << 4));
     EXPECT_EQ(1, regs.flags.c);
@@ -130,8 +130,8 @@ TEST_F(GraphicsInstructionsTests, testDrawSpriteIndirect_notCollided)
     regs.pc = 0x102;
     regs.flags.c = 1;
     EXPECT_CALL(*memory, readWord(0x102)).Times(1).WillOnce(Return(REG_INDEX_Z << 8));
-    EXPECT_CALL(*memory, readByteReference(0x2000)).Times(1).WillOnce(Return(TEST_SPRITE.begin()));
-    EXPECT_CALL(*bus, drawSprite(1, 5, Eq(TEST_SPRITE.begin()))).Times(1).WillOnce(Return(false));
+    EXPECT_CALL(*memory, readByteReference(0x2000)).Times(1).WillOnce(Return(TEST_SPRITE.data()));
+    EXPECT_CALL(*bus, drawSprite(1, 5, Eq(TEST_SPRITE.data()))).Times(1).WillOnce(Return(false));
     testedCpu->executeInstruction(DRAW_SPRITE_INDIRECT_INSTRUCTION_OPCODE
         + REG_INDEX_X + (REG_INDEX_Y << 4));
     EXPECT_EQ(0, regs.flags.c);
@@ -156,8 +156,8 @@ TEST_F(GraphicsInstructionsTests, testDrawSpriteIndirect_collided)
     regs.pc = 0x102;
     regs.flags.c = 0;
     EXPECT_CALL(*memory, readWord(0x102)).Times(1).WillOnce(Return(REG_INDEX_Z << 8));
-    EXPECT_CALL(*memory, readByteReference(0x2000)).Times(1).WillOnce(Return(TEST_SPRITE.begin()));
-    EXPECT_CALL(*bus, drawSprite(1, 5, Eq(TEST_SPRITE.begin()))).Times(1).WillOnce(Return(true));
+    EXPECT_CALL(*memory, readByteReference(0x2000)).Times(1).WillOnce(Return(TEST_SPRITE.data()));
+    EXPECT_CALL(*bus, drawSprite(1, 5, Eq(TEST_SPRITE.data()))).Times(1).WillOnce(Return(true));
     testedCpu->executeInstruction(DRAW_SPRITE_INDIRECT_INSTRUCTION_OPCODE
         + REG_INDEX_X + (REG_INDEX_Y << 4));
     EXPECT_EQ(1, regs.flags.c);
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include "../../src/core/IdleLoopAnalysis.hpp"
+
+TEST(IdleLoopAnalysisTests, testLoopPollingMemoryIsIdle)
+{
+    EXPECT_TRUE(IdleLoopAnalysis::isIdleLoop({
+        { 0x2200, 0xFFF0 },     // LDM R0, 0xFFF0
+        { 0x6300, 0x0001 },     // TSTI R0, 1
+        { 0x1200, 0x0100 } })); // JZ 0x100
+}
+
+TEST(IdleLoopAnalysisTests, testJumpToItselfIsIdle)
+{
+    EXPECT_TRUE(IdleLoopAnalysis::isIdleLoop({ { 0x1000, 0x0100 } }));  // JMP 0x100
+}
+
+TEST(IdleLoopAnalysisTests, testLoopModifyingRegisterReadInNextIterationIsNotIdle)
+{
+    EXPECT_FALSE(IdleLoopAnalysis::isIdleLoop({
+        { 0x4000, 0x0001 },     // ADDI R0, 1
+        { 0x5300, 0x0010 },     // CMPI R0, 0x10
+        { 0x1201, 0x0100 } })); // JNZ 0x100
+}
+
+TEST(IdleLoopAnalysisTests, testLoopReadingFlagsWrittenInPreviousIterationIsNotIdle)
+{
+    EXPECT_FALSE(IdleLoopAnalysis::isIdleLoop({
+        { 0x1100, 0x0200 },     // JMC 0x200
+        { 0x6300, 0x0001 },     // TSTI R0, 1
+        { 0x1000, 0x0100 } })); // JMP 0x100
+}
+
+TEST(IdleLoopAnalysisTests, testLoopWithSideEffectsIsNotIdle)
+{
+    EXPECT_FALSE(IdleLoopAnalysis::isIdleLoop({
+        { 0x2200, 0xFFF0 },     // LDM R0, 0xFFF0
+        { 0x3000, 0x0200 },     // STM R0, 0x200
+        { 0x1000, 0x0100 } })); // JMP 0x100
+    EXPECT_FALSE(IdleLoopAnalysis::isIdleLoop({
+        { 0x0700, 0x0010 },     // RND R0, 0x10
+        { 0x1000, 0x0100 } })); // JMP 0x100
+}
+
+TEST(IdleLoopAnalysisTests, testLoopBranchingInsideBodyIsNotIdle)
+{
+    EXPECT_FALSE(IdleLoopAnalysis::isIdleLoop({
+        { 0x2200, 0xFFF0 },     // LDM R0, 0xFFF0
+        { 0x1000, 0x0200 },     // JMP 0x200
+        { 0x1000, 0x0100 } })); // JMP 0x100
+}
@@ -0,0 +1,30 @@
+#include <gtest/gtest.h>
+
+#include "../../src/core/InstructionSet.hpp"
+
+TEST(InstructionSetTests, testDescribeInstructionWithoutOperand)
+{
+    const auto& descriptor = InstructionSet::describe(0x00);
+    EXPECT_EQ(Operation::NOP, descriptor.operation);
+    EXPECT_FALSE(descriptor.usesOperandWord);
+}
+
+TEST(InstructionSetTests, testDescribeInstructionWithOperand)
+{
+    const auto& descriptor = InstructionSet::describe(0x40);
+    EXPECT_EQ(Operation::ADD_IMMEDIATE, descriptor.operation);
+    EXPECT_TRUE(descriptor.usesOperandWord);
+}
+
+TEST(InstructionSetTests, testDescribeUndefinedOpcode)
+{
+    EXPECT_EQ(Operation::INVALID, InstructionSet::describe(0x0F).operation);
+    EXPECT_EQ(Operation::INVALID, InstructionSet::describe(0x43).operation);
+    EXPECT_EQ(Operation::INVALID, InstructionSet::describe(0xF0).operation);
+}
+
+TEST(InstructionSetTests, testDescribeIsConstantExpression)
+{
+    static_assert(InstructionSet::describe(0xE5).operation == Operation::NEG_REGISTER_INDIRECT, "");
+    static_assert(InstructionSet::describe(0xFF).operation == Operation::INVALID, "");
+}
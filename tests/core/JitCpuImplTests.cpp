@@ -0,0 +1,380 @@
+#include "../../src/core/JitCpuImpl.hpp"
+
+#if CHIP16_JIT_SUPPORTED
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <regex>
+#include <string>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../helpers/InstructionWriter.hpp"
+
+#include "../../src/core/MemoryImpl.hpp"
+#include "../../src/core/BusImpl.hpp"
+#include "../../src/core/GraphicsImpl.hpp"
+
+namespace
+{
+    class JitCpuImplTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            memory = std::make_shared<MemoryImpl>();
+            bus = std::make_shared<StaticBusImpl>(std::make_shared<GraphicsImpl>());
+            testedCpu = std::make_unique<JitCpuImpl>(memory, bus);
+            // Blocks are compiled on their first execution unless the test sets tiers
+            testedCpu->setTierThresholds(0, 0);
+        }
+
+        std::unique_ptr<JitCpuImpl> testedCpu;
+        std::shared_ptr<MemoryImpl> memory;
+        std::shared_ptr<StaticBusImpl> bus;
+    };
+}
+
+TEST_F(JitCpuImplTests, stepExecutesBlockUntilJumpTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x1234);  // LDI R0, 0x1234
+    writeInstruction(*memory, 0x04, 0x2401, 0x0000);  // MOV R1, R0
+    writeInstruction(*memory, 0x08, 0x4001, 0x0001);  // ADDI R1, 1
+    writeInstruction(*memory, 0x0C, 0x1000, 0x0100);  // JMP 0x100
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->step();
+    EXPECT_EQ(0x1234, regs.r[0]);
+    EXPECT_EQ(0x1235, regs.r[1]);
+    EXPECT_EQ(0x100, regs.pc);
+}
+
+TEST_F(JitCpuImplTests, stepUpdatesProgramCounterOfInterpretedInstructionTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x5678);  // LDI R0, 0x5678
+    writeInstruction(*memory, 0x04, 0x3000, 0x0200);  // STM R0, 0x200
+    writeInstruction(*memory, 0x08, 0x1000, 0x0008);  // JMP 0x8
+    testedCpu->step();
+    EXPECT_EQ(0x5678, memory->readWord(0x200));
+    EXPECT_EQ(0x0008, testedCpu->getRegisters().pc);
+}
+
+TEST_F(JitCpuImplTests, stepRecompilesBlockModifiedBySelfTest)
+{
+    writeInstruction(*memory, 0x00, 0x2001, 0x2222);  // LDI R1, 0x2222
+    writeInstruction(*memory, 0x04, 0x3001, 0x000A);  // STM R1, 0xA (operand of the next instruction)
+    writeInstruction(*memory, 0x08, 0x2002, 0x1111);  // LDI R2, 0x1111
+    writeInstruction(*memory, 0x0C, 0x1000, 0x0100);  // JMP 0x100
+    auto& regs = testedCpu->getRegisters();
+    testedCpu->step();
+    EXPECT_EQ(0x0008, regs.pc);
+    testedCpu->step();
+    EXPECT_EQ(0x2222, regs.r[2]);
+    EXPECT_EQ(0x0100, regs.pc);
+}
+
+TEST_F(JitCpuImplTests, stepRecompilesBlockAfterRomLoadTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x1111);  // LDI R0, 0x1111
+    writeInstruction(*memory, 0x04, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->step();
+    EXPECT_EQ(0x1111, testedCpu->getRegisters().r[0]);
+
+    std::stringstream rom;
+    rom << '\x00' << '\x20' << '\x22' << '\x22';      // LDI R0, 0x2222
+    memory->loadRomFromStream(rom);
+    testedCpu->step();
+    EXPECT_EQ(0x2222, testedCpu->getRegisters().r[0]);
+}
+
+TEST_F(JitCpuImplTests, runStopsAtBreakpointInsideBlockTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x1111);  // LDI R0, 0x1111
+    writeInstruction(*memory, 0x04, 0x2001, 0x2222);  // LDI R1, 0x2222
+    writeInstruction(*memory, 0x08, 0x2002, 0x3333);  // LDI R2, 0x3333
+    writeInstruction(*memory, 0x0C, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->step();
+    testedCpu->getRegisters() = CpuRegisters{};
+    testedCpu->setBreakpoint(0x0004, true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::BREAKPOINT, result);
+    EXPECT_EQ(0x1111, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(0x0004, testedCpu->getRegisters().pc);
+}
+
+#if defined(CHIP16_WATCHPOINTS)
+TEST_F(JitCpuImplTests, runLeavesBlockAfterWatchpointHitTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x1111);  // LDI R0, 0x1111
+    writeInstruction(*memory, 0x04, 0x3000, 0x0400);  // STM R0, 0x400
+    writeInstruction(*memory, 0x08, 0x2001, 0x2222);  // LDI R1, 0x2222
+    writeInstruction(*memory, 0x0C, 0x1000, 0x0000);  // JMP 0x0
+    memory->addWatchpoint(0x0400, 2, MemoryImpl::WatchAccess::WRITE);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::WATCHPOINT, result);
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(0x0008, testedCpu->getRegisters().pc);
+    EXPECT_EQ(0x0004, testedCpu->getWatchpointHit().pc);
+}
+
+TEST_F(JitCpuImplTests, exportDoesNotHitReadWatchpointsTest)
+{
+    writeInstruction(*memory, 0x0100, 0x2000, 0x1111);  // LDI R0, 0x1111
+    writeInstruction(*memory, 0x0104, 0x1000, 0x0100);  // JMP 0x100
+    testedCpu->getRegisters().pc = 0x0100;
+    testedCpu->step();
+    memory->addWatchpoint(0x0100, 8, MemoryImpl::WatchAccess::READ);
+    EXPECT_EQ(1, testedCpu->exportCode().size());
+    EXPECT_EQ(0x0000, testedCpu->getWatchpointHit().addr);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, testedCpu->run(10));
+}
+#endif
+
+TEST_F(JitCpuImplTests, runCountsCyclesOfWholeBlocksTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x1111);  // LDI R0, 0x1111
+    writeInstruction(*memory, 0x04, 0x1000, 0x0000);  // JMP 0x0
+    auto result = testedCpu->run(5);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().pc);
+}
+
+TEST_F(JitCpuImplTests, stepCountsCyclesOfExecutedPartOfLeftBlockTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x0000);  // LDI R0, 0x0
+    writeInstruction(*memory, 0x04, 0x3000, 0x0008);  // STM R0, 0x8
+    writeInstruction(*memory, 0x08, 0x2001, 0x2222);  // LDI R1, 0x2222
+    writeInstruction(*memory, 0x0C, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->step();
+    EXPECT_EQ(2, testedCpu->getCycles());
+    EXPECT_EQ(0x0008, testedCpu->getRegisters().pc);
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().r[1]);
+}
+
+TEST_F(JitCpuImplTests, runEntersSuccessorsThroughLinksTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1000, 0x0010);  // JMP 0x10
+    writeInstruction(*memory, 0x10, 0x4001, 0x0001);  // ADDI R1, 1
+    writeInstruction(*memory, 0x14, 0x1000, 0x0000);  // JMP 0x0
+    auto result = testedCpu->run(40);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(10, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(10, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(17, testedCpu->getChainedBlocksCount());
+}
+
+TEST_F(JitCpuImplTests, stepDoesNotEnterSuccessorThroughLinkTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1000, 0x0010);  // JMP 0x10
+    writeInstruction(*memory, 0x10, 0x4001, 0x0001);  // ADDI R1, 1
+    writeInstruction(*memory, 0x14, 0x1000, 0x0000);  // JMP 0x0
+    for (auto i = 0; i < 4; i++)
+        testedCpu->step();
+    EXPECT_EQ(2, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(2, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(0, testedCpu->getChainedBlocksCount());
+}
+
+TEST_F(JitCpuImplTests, runDropsLinkToModifiedSuccessorTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1000, 0x0010);  // JMP 0x10
+    writeInstruction(*memory, 0x10, 0x4001, 0x0001);  // ADDI R1, 1
+    writeInstruction(*memory, 0x14, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->run(8);
+    EXPECT_EQ(2, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(1, testedCpu->getChainedBlocksCount());
+
+    memory->writeWord(0x12, 0x0005);                  // ADDI R1, 5
+    testedCpu->run(8);
+    EXPECT_EQ(4, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(12, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(2, testedCpu->getChainedBlocksCount());
+}
+
+TEST_F(JitCpuImplTests, runStopsAtBreakpointInLinkedBlockTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1000, 0x0010);  // JMP 0x10
+    writeInstruction(*memory, 0x10, 0x4001, 0x0001);  // ADDI R1, 1
+    writeInstruction(*memory, 0x14, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->run(20);
+
+    testedCpu->setBreakpoint(0x0010, true);
+    auto result = testedCpu->run(20);
+    EXPECT_EQ(StopReason::BREAKPOINT, result);
+    EXPECT_EQ(0x0010, testedCpu->getRegisters().pc);
+    EXPECT_EQ(6, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(5, testedCpu->getRegisters().r[1]);
+}
+
+TEST_F(JitCpuImplTests, runEntersReturnAddressThroughLinkTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x0001);  // LDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1400, 0x0020);  // CALL 0x20
+    writeInstruction(*memory, 0x08, 0x1000, 0x0004);  // JMP 0x4
+    writeInstruction(*memory, 0x20, 0x4101, 0x0000);  // ADD R1, R0
+    writeInstruction(*memory, 0x24, 0x1500, 0x0000);  // RET
+    auto result = testedCpu->run(40);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(10, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(24, testedCpu->getChainedBlocksCount());
+}
+
+TEST_F(JitCpuImplTests, runPromotesBlockThroughTiersTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->setTierThresholds(2, 4);
+    auto result = testedCpu->run(10);
+    EXPECT_EQ(StopReason::BUDGET_EXHAUSTED, result);
+    EXPECT_EQ(5, testedCpu->getRegisters().r[0]);
+
+    const auto statistics = testedCpu->getTierStatistics();
+    ASSERT_EQ(3, statistics.size());
+    EXPECT_EQ(1, statistics[0].blocks);
+    EXPECT_EQ(4, statistics[0].cycles);
+    EXPECT_EQ(1, statistics[1].blocks);
+    EXPECT_EQ(4, statistics[1].cycles);
+    EXPECT_EQ(1, statistics[2].blocks);
+    EXPECT_EQ(2, statistics[2].cycles);
+}
+
+TEST_F(JitCpuImplTests, runDoesNotCompileColdCodeTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0x1111);  // LDI R0, 0x1111
+    writeInstruction(*memory, 0x04, 0x1000, 0x0010);  // JMP 0x10
+    writeInstruction(*memory, 0x10, 0x4001, 0x0001);  // ADDI R1, 1
+    writeInstruction(*memory, 0x14, 0x1000, 0x0010);  // JMP 0x10
+    testedCpu->setTierThresholds(1, 3);
+    testedCpu->run(20);
+    EXPECT_EQ(0x1111, testedCpu->getRegisters().r[0]);
+    EXPECT_EQ(9, testedCpu->getRegisters().r[1]);
+
+    // Only the loop has been compiled
+    const auto statistics = testedCpu->getTierStatistics();
+    EXPECT_EQ(2, statistics[0].blocks);
+    EXPECT_EQ(1, statistics[2].blocks);
+}
+
+TEST_F(JitCpuImplTests, importCompilesBlocksBeforeTheirExecutionTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x1000, 0x0000);  // JMP 0x0
+    testedCpu->run(4);
+    const auto blocks = testedCpu->exportCode();
+    ASSERT_EQ(1, blocks.size());
+    EXPECT_EQ(0x0000, blocks[0].startAddress);
+    EXPECT_EQ(8, blocks[0].size);
+
+    // Default thresholds would interpret the loop during its first entries
+    auto importingCpu = std::make_unique<JitCpuImpl>(memory, bus);
+    EXPECT_EQ(1, importingCpu->importCode(blocks));
+    importingCpu->run(4);
+    EXPECT_EQ(2, importingCpu->getRegisters().r[0]);
+
+    const auto statistics = importingCpu->getTierStatistics();
+    EXPECT_EQ(0, statistics[0].cycles);
+    EXPECT_EQ(0, statistics[1].cycles);
+    EXPECT_EQ(4, statistics[2].cycles);
+}
+
+TEST_F(JitCpuImplTests, perfMapNamesAddressRangeOfCompiledBlockTest)
+{
+    const std::string path = "/tmp/chip16-jit-perf-map-test.map";
+    writeInstruction(*memory, 0x100, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x104, 0x1000, 0x0100);  // JMP 0x100
+    testedCpu->getRegisters().pc = 0x100;
+    ASSERT_TRUE(testedCpu->setPerfMap(true, path));
+    testedCpu->step();
+    testedCpu->step();
+    testedCpu->setPerfMap(false);
+
+    std::ifstream map(path);
+    std::string line;
+    ASSERT_TRUE(std::getline(map, line));
+    EXPECT_TRUE(std::regex_match(line, std::regex("[0-9a-f]+ [0-9a-f]+ chip16_block_0100_0108"))) << line;
+    EXPECT_FALSE(std::getline(map, line));
+    std::remove(path.c_str());
+}
+
+TEST_F(JitCpuImplTests, runSkipsIterationsOfIdleLoopTest)
+{
+    writeInstruction(*memory, 0x00, 0x2200, 0x0200);  // LDM R0, 0x200
+    writeInstruction(*memory, 0x04, 0x6300, 0x0001);  // TSTI R0, 1
+    writeInstruction(*memory, 0x08, 0x1200, 0x0000);  // JZ 0x0
+    testedCpu->setIdleLoopDetection(true);
+    auto result = testedCpu->run(100);
+    EXPECT_EQ(StopReason::IDLE_LOOP, result);
+    EXPECT_EQ(99, testedCpu->getCycles());
+    EXPECT_EQ(0x0000, testedCpu->getRegisters().pc);
+}
+
+TEST_F(JitCpuImplTests, deadFlagsEliminationKeepsObservedFlagsTest)
+{
+    writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+    writeInstruction(*memory, 0x04, 0x9001, 0x0003);  // MULI R1, 3
+    writeInstruction(*memory, 0x08, 0x5301, 0x0006);  // CMPI R1, 6
+    writeInstruction(*memory, 0x0C, 0x1200, 0x0100);  // JZ 0x100
+    testedCpu->setDeadFlagsElimination(true);
+    testedCpu->setDeadFlagsCrossCheck(true);
+    auto& regs = testedCpu->getRegisters();
+    regs.r[0] = 0xFFFF;
+    regs.r[1] = 2;
+    testedCpu->step();
+    EXPECT_EQ(0x0000, regs.r[0]);
+    EXPECT_EQ(0x0006, regs.r[1]);
+    EXPECT_EQ(0x0100, regs.pc);
+    EXPECT_EQ(0, testedCpu->getDeadFlagsCheckFailures());
+}
+
+TEST_F(JitCpuImplTests, translatedInstructionsMatchInterpreterTest)
+{
+    const u16 values[] = { 0x0000, 0x0001, 0x0002, 0x1234, 0x7FFF, 0x8000, 0x8001, 0xFFFE, 0xFFFF };
+    const u16 opcodes[] = {
+        0x4010, 0x4110, 0x4210,                 // ADDI R0, ADD R0 R1, ADD R0 R1 R2
+        0x5010, 0x5110, 0x5210, 0x5310, 0x5410, // SUBI, SUB, SUB, CMPI, CMP
+        0x6010, 0x6110, 0x6210, 0x6310, 0x6410, // ANDI, AND, AND, TSTI, TST
+        0x7010, 0x7110, 0x7210,                 // ORI, OR, OR
+        0x8010, 0x8110, 0x8210,                 // XORI, XOR, XOR
+        0xB010, 0xB110, 0xB210                  // SHL, SHR, SAR
+    };
+
+    for (auto opcode : opcodes)
+    {
+        for (auto value1 : values)
+        {
+            for (auto value2 : values)
+            {
+                // Operand holds immediate value or index of destination/shift count in its third nibble
+                const u16 operand = (opcode >> 12) == 0xB ? 0x0500 : value2 & 0xFF0F;
+                auto interpreterMemory = std::make_shared<MemoryImpl>();
+                CpuImpl interpreter(interpreterMemory, bus);
+                writeInstruction(*memory, 0x00, opcode, operand);
+                writeInstruction(*memory, 0x04, 0x1000, 0x0000);
+                writeInstruction(*interpreterMemory, 0x00, opcode, operand);
+                // Direct writes bypass write observer, drop previously compiled block explicitly
+                testedCpu->onMemoryWrite(0x0000, 0x10000);
+                auto& expected = interpreter.getRegisters();
+                auto& actual = testedCpu->getRegisters();
+                expected = CpuRegisters{};
+                actual = CpuRegisters{};
+                expected.r[0] = actual.r[0] = value1;
+                expected.r[1] = actual.r[1] = value2;
+                expected.flags.raw = actual.flags.raw = 0x39;
+
+                interpreter.step();
+                testedCpu->step();
+
+                for (auto i = 0; i < 16; i++)
+                    EXPECT_EQ(expected.r[i], actual.r[i]) << "opcode " << opcode << " register " << i;
+                EXPECT_EQ(expected.flags.raw, actual.flags.raw) << "opcode " << opcode;
+            }
+        }
+    }
+}
+
+#endif
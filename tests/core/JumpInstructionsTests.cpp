@@ -26,7 +26,7 @@ namespace
         {
             std::va_list args;
             va_start(args, startAddr);
-            ON_CALL(*memory, readWord(startAddr)).WillByDefault(Return(va_arg(args, u16)));
+            ON_CALL(*memory, readWord(startAddr)).WillByDefault(Return(static_cast<u16>(va_arg(args, int))));
             startAddr += 2;
             va_end(args);
         }
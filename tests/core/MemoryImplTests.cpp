@@ -7,6 +7,18 @@
 
 namespace
 {
+    using ::testing::_;
+    using ::testing::ElementsAre;
+
+    class WriteObserverMock : public MemoryWriteObserver
+    {
+    public:
+        MOCK_METHOD2(onMemoryWrite, void(u16, unsigned));
+#if defined(CHIP16_WATCHPOINTS)
+        MOCK_METHOD2(onWatchpointHit, void(u16, bool));
+#endif
+    };
+
     class MemoryImplTests : public ::testing::Test
     {
     protected:
@@ -48,6 +60,52 @@ TEST_F(MemoryImplTests, testWriteWord)
     EXPECT_EQ(0x25, testedMemory->readByte(0x1));
 }
 
+TEST_F(MemoryImplTests, testReadWordWrapsAround)
+{
+    testedMemory->writeData(0xFFFF, 0x77);
+    testedMemory->writeData(0x0000, 0x87);
+    EXPECT_EQ(0x8777, testedMemory->readWord(0xFFFF));
+}
+
+TEST_F(MemoryImplTests, testWriteWordWrapsAround)
+{
+    testedMemory->writeWord(0xFFFF, 0x2587);
+    EXPECT_EQ(0x87, testedMemory->readByte(0xFFFF));
+    EXPECT_EQ(0x25, testedMemory->readByte(0x0000));
+}
+
+TEST_F(MemoryImplTests, testReadInstruction)
+{
+    testedMemory->writeData(0x100, 0x20, 0x05, 0x34, 0x12);
+    EXPECT_EQ(0x12340520, testedMemory->readInstruction(0x100));
+}
+
+TEST_F(MemoryImplTests, testReadInstructionWrapsAround)
+{
+    testedMemory->writeData(0xFFFE, 0x20, 0x05);
+    testedMemory->writeData(0x0000, 0x34, 0x12);
+    EXPECT_EQ(0x12340520, testedMemory->readInstruction(0xFFFE));
+}
+
+TEST_F(MemoryImplTests, testReadBytes)
+{
+    testedMemory->writeData(0x100, 0x11, 0x22, 0x33);
+    u8 data[3];
+    testedMemory->readBytes(0x100, data, 3);
+    EXPECT_EQ(0x11, data[0]);
+    EXPECT_EQ(0x22, data[1]);
+    EXPECT_EQ(0x33, data[2]);
+}
+
+TEST_F(MemoryImplTests, testWriteBytesWrapsAround)
+{
+    const u8 data[] = { 0x11, 0x22, 0x33 };
+    testedMemory->writeBytes(0xFFFF, data, 3);
+    EXPECT_EQ(0x11, testedMemory->readByte(0xFFFF));
+    EXPECT_EQ(0x22, testedMemory->readByte(0x0000));
+    EXPECT_EQ(0x33, testedMemory->readByte(0x0001));
+}
+
 TEST_F(MemoryImplTests, testReadControllerState)
 {
     testedMemory->writeData(0xFFF0, 0x00, 0x89);
@@ -77,4 +135,222 @@ TEST_F(MemoryImplTests, testLoadRomFromStream)
 
     EXPECT_EQ(0x42, byte1);
     EXPECT_EQ(0x21, byte2);
-}
\ No newline at end of file
+}
+
+TEST_F(MemoryImplTests, testLoadRomFromStreamStopsAtEndOfStream)
+{
+    testedMemory->writeData(0x0002, 0x55);
+    std::istringstream rom(std::string("\x31\x11", 2));
+    testedMemory->loadRomFromStream(rom);
+    EXPECT_EQ(0x1131, testedMemory->readWord(0x0000));
+    EXPECT_EQ(0x55, testedMemory->readByte(0x0002));
+}
+
+TEST_F(MemoryImplTests, testLoadRom)
+{
+    const u8 ROM[] = { 0x31, 0x11, 0x02, 0x24 };
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    EXPECT_CALL(observer, onMemoryWrite(0, 0x10000)).Times(1);
+    testedMemory->loadRom(ROM, sizeof(ROM));
+    EXPECT_EQ(0x1131, testedMemory->readWord(0x0000));
+    EXPECT_EQ(0x2402, testedMemory->readWord(0x0002));
+    EXPECT_EQ(0x00, testedMemory->readByte(0x0004));
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testWriteIntoCodeIsReported)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->markCode(0x1FC, 8);
+    EXPECT_CALL(observer, onMemoryWrite(0x100, 1)).Times(1);
+    EXPECT_CALL(observer, onMemoryWrite(0x2FF, 1)).Times(1);
+    testedMemory->writeByte(0x100, 0x11);
+    testedMemory->writeByte(0x2FF, 0x22);
+
+    const auto statistics = testedMemory->getCodeWriteStatistics();
+    ASSERT_EQ(2, statistics.size());
+    EXPECT_EQ(0x100, statistics[0].first);
+    EXPECT_EQ(1, statistics[0].second);
+    EXPECT_EQ(0x200, statistics[1].first);
+    EXPECT_EQ(1, statistics[1].second);
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testWriteWordIntoCodeIsReportedOnce)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->markCode(0x100, 4);
+    EXPECT_CALL(observer, onMemoryWrite(0x102, 2)).Times(1);
+    testedMemory->writeWord(0x102, 0x1234);
+    EXPECT_EQ(0x1234, testedMemory->readWord(0x102));
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testWriteIntoDataIsNotReported)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->markCode(0x100, 4);
+    EXPECT_CALL(observer, onMemoryWrite(_, _)).Times(0);
+    testedMemory->writeWord(0x0FE, 0x1234);
+    const u8 data[] = { 0x11, 0x22 };
+    testedMemory->writeBytes(0x200, data, 2);
+    EXPECT_TRUE(testedMemory->getCodeWriteStatistics().empty());
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testLoadRomFromStreamForgetsCode)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->markCode(0x100, 4);
+    EXPECT_CALL(observer, onMemoryWrite(0, 0x10000)).Times(1);
+    std::istringstream rom("\x01\x02");
+    testedMemory->loadRomFromStream(rom);
+
+    EXPECT_CALL(observer, onMemoryWrite(0x100, 1)).Times(0);
+    testedMemory->writeByte(0x100, 0x11);
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testWrittenPagesAreDirty)
+{
+    const auto epoch = testedMemory->finishEpoch();
+    EXPECT_TRUE(testedMemory->getDirtyPages(epoch).empty());
+
+    testedMemory->writeByte(0x0110, 0x11);
+    testedMemory->writeWord(0x02FF, 0x2222);
+    const u8 data[] = { 0x33, 0x44 };
+    testedMemory->writeBytes(0xFFFF, data, 2);
+
+    EXPECT_THAT(testedMemory->getDirtyPages(epoch), ElementsAre(0x0000, 0x0100, 0x0200, 0x0300, 0xFF00));
+    EXPECT_TRUE(testedMemory->isPageDirty(0x01FF, epoch));
+    EXPECT_FALSE(testedMemory->isPageDirty(0x0400, epoch));
+}
+
+TEST_F(MemoryImplTests, testEpochsOfConsumersAreIndependent)
+{
+    const auto firstEpoch = testedMemory->finishEpoch();
+    testedMemory->writeByte(0x0100, 0x11);
+    const auto secondEpoch = testedMemory->finishEpoch();
+    testedMemory->writeByte(0x0200, 0x22);
+
+    EXPECT_THAT(testedMemory->getDirtyPages(firstEpoch), ElementsAre(0x0100, 0x0200));
+    EXPECT_THAT(testedMemory->getDirtyPages(secondEpoch), ElementsAre(0x0200));
+}
+
+TEST_F(MemoryImplTests, testLoadRomMakesAllPagesDirty)
+{
+    const auto epoch = testedMemory->finishEpoch();
+    const u8 ROM[] = { 0x31, 0x11 };
+    testedMemory->loadRom(ROM, sizeof(ROM));
+    EXPECT_EQ(0x10000 / MemoryImpl::PAGE_SIZE, testedMemory->getDirtyPages(epoch).size());
+}
+
+TEST_F(MemoryImplTests, testSnapshotSharesUnwrittenPages)
+{
+    testedMemory->writeByte(0x0100, 0x11);
+    const auto first = testedMemory->takeSnapshot();
+    testedMemory->writeByte(0x0200, 0x22);
+    const auto second = testedMemory->takeSnapshot();
+
+    EXPECT_EQ(first.pages[0x01], second.pages[0x01]);
+    EXPECT_NE(first.pages[0x02], second.pages[0x02]);
+    EXPECT_EQ(0x00, (*first.pages[0x02])[0]);
+    EXPECT_EQ(0x22, (*second.pages[0x02])[0]);
+}
+
+TEST_F(MemoryImplTests, testRestoreSnapshotReportsRestoredCode)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->markCode(0x0100, 4);
+    testedMemory->writeData(0x0100, 0x11);
+    const auto snapshot = testedMemory->takeSnapshot();
+
+    EXPECT_CALL(observer, onMemoryWrite(0x0100, 1)).Times(1);
+    testedMemory->writeByte(0x0100, 0x22);
+    testedMemory->writeByte(0x0300, 0x33);
+    const auto epoch = testedMemory->finishEpoch();
+
+    EXPECT_CALL(observer, onMemoryWrite(0x0100, MemoryImpl::PAGE_SIZE)).Times(1);
+    testedMemory->restoreSnapshot(snapshot);
+    EXPECT_EQ(0x11, testedMemory->readByte(0x0100));
+    EXPECT_EQ(0x00, testedMemory->readByte(0x0300));
+    EXPECT_THAT(testedMemory->getDirtyPages(epoch), ElementsAre(0x0100, 0x0300));
+    testedMemory->setWriteObserver(nullptr);
+}
+
+#if defined(CHIP16_WATCHPOINTS)
+TEST_F(MemoryImplTests, testAccessOfWatchedRangeIsReported)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->addWatchpoint(0x1234, 2, MemoryImpl::WatchAccess::READ);
+    EXPECT_CALL(observer, onWatchpointHit(0x1235, false)).Times(1);
+    EXPECT_CALL(observer, onWatchpointHit(0x1233, false)).Times(1);
+    testedMemory->readByte(0x1235);
+    testedMemory->readWord(0x1233);
+    testedMemory->readByte(0x1236);
+    testedMemory->readInstruction(0x1234);
+    testedMemory->writeWord(0x1234, 0x5678);
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testWordEnteringWatchedPageIsReported)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->addWatchpoint(0x0200, 1, MemoryImpl::WatchAccess::READ_WRITE);
+    EXPECT_CALL(observer, onWatchpointHit(0x01FF, false)).Times(1);
+    // Word crossing a page is written by bytes
+    EXPECT_CALL(observer, onWatchpointHit(0x0200, true)).Times(1);
+    testedMemory->readWord(0x01FE);
+    testedMemory->readWord(0x01FF);
+    testedMemory->writeWord(0x01FE, 0x1111);
+    testedMemory->writeWord(0x01FF, 0x2222);
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testWatchpointWrapsAroundEndOfMemory)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->addWatchpoint(0xFFFF, 2, MemoryImpl::WatchAccess::READ_WRITE);
+    EXPECT_CALL(observer, onWatchpointHit(0x0000, true)).Times(1);
+    EXPECT_CALL(observer, onWatchpointHit(0xFFF0, false)).Times(1);
+    testedMemory->writeByte(0x0000, 0x11);
+    u8 data[0x10];
+    testedMemory->readBytes(0xFFF0, data, sizeof(data));
+    testedMemory->readByte(0x0002);
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testInstructionWrappingAroundIsNotWatched)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->writeData(0xFFFE, 0x11, 0x22);
+    testedMemory->writeData(0x0000, 0x33, 0x44);
+    testedMemory->addWatchpoint(0xFFFE, 4, MemoryImpl::WatchAccess::READ);
+    EXPECT_CALL(observer, onWatchpointHit(_, _)).Times(0);
+    EXPECT_EQ(0x44332211u, testedMemory->readInstruction(0xFFFE));
+    testedMemory->setWriteObserver(nullptr);
+}
+
+TEST_F(MemoryImplTests, testRemovedWatchpointIsNotReported)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->addWatchpoint(0x0300, 4, MemoryImpl::WatchAccess::WRITE);
+    testedMemory->addWatchpoint(0x0380, 4, MemoryImpl::WatchAccess::WRITE);
+    testedMemory->removeWatchpoint(0x0300, 4);
+    EXPECT_CALL(observer, onWatchpointHit(0x0380, true)).Times(1);
+    testedMemory->writeByte(0x0300, 0x11);
+    testedMemory->writeByte(0x0380, 0x22);
+    testedMemory->setWriteObserver(nullptr);
+}
+#endif
@@ -0,0 +1,106 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../mocks/BusMock.hpp"
+#include "../mocks/CpuMock.hpp"
+
+#include "../../src/core/SchedulerImpl.hpp"
+
+namespace
+{
+    using ::testing::Return;
+    using ::testing::Invoke;
+    using ::testing::InSequence;
+    using ::testing::_;
+
+    class SchedulerImplTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            cpu = std::make_shared<CpuMock>();
+            bus = std::make_shared<BusMock>();
+            ON_CALL(*cpu, getCycles()).WillByDefault(Invoke([this]() { return cycles; }));
+            ON_CALL(*cpu, skipCycles(_)).WillByDefault(Invoke([this](std::uint64_t count) { cycles += count; }));
+            EXPECT_CALL(*cpu, getCycles()).Times(::testing::AnyNumber());
+            testedScheduler = std::make_unique<SchedulerImpl>(cpu, bus);
+        }
+
+        // Simulates cpu executing given number of cycles
+        auto executeCycles(std::uint64_t count, StopReason reason)
+        {
+            return Invoke([this, count, reason](unsigned) { cycles += count; return reason; });
+        }
+
+        std::uint64_t cycles = 0;
+        std::unique_ptr<SchedulerImpl> testedScheduler;
+        std::shared_ptr<CpuMock> cpu;
+        std::shared_ptr<BusMock> bus;
+    };
+}
+
+TEST_F(SchedulerImplTests, runFrameRaisesVBlankAfterFrameCyclesTest)
+{
+    EXPECT_CALL(*cpu, run(16666)).Times(1).WillOnce(executeCycles(16666, StopReason::BUDGET_EXHAUSTED));
+    EXPECT_CALL(*bus, setVBlank(true)).Times(1);
+    EXPECT_EQ(StopReason::VBLANK, testedScheduler->runFrame());
+    EXPECT_EQ(16666, testedScheduler->getCycles());
+    EXPECT_EQ(1, testedScheduler->getFrames());
+}
+
+TEST_F(SchedulerImplTests, runFrameContinuesWhileCpuWaitsForVBlankTest)
+{
+    InSequence sequence;
+    testedScheduler->setIdleFastForward(false);
+    EXPECT_CALL(*cpu, run(16666)).WillOnce(executeCycles(16000, StopReason::VBLANK));
+    EXPECT_CALL(*cpu, run(666)).WillOnce(executeCycles(1, StopReason::VBLANK));
+    EXPECT_CALL(*cpu, run(665)).WillOnce(executeCycles(665, StopReason::VBLANK));
+    EXPECT_CALL(*bus, setVBlank(true)).Times(1);
+    EXPECT_EQ(StopReason::VBLANK, testedScheduler->runFrame());
+}
+
+TEST_F(SchedulerImplTests, runFrameSkipsCyclesOfCpuWaitingForVBlankTest)
+{
+    InSequence sequence;
+    EXPECT_CALL(*cpu, run(16666)).WillOnce(executeCycles(16000, StopReason::VBLANK));
+    EXPECT_CALL(*cpu, skipCycles(666)).Times(1);
+    EXPECT_CALL(*bus, setVBlank(true)).Times(1);
+    EXPECT_EQ(StopReason::VBLANK, testedScheduler->runFrame());
+    EXPECT_EQ(16666, testedScheduler->getCycles());
+    EXPECT_EQ(666, testedScheduler->getIdleCycles());
+}
+
+TEST_F(SchedulerImplTests, runFrameKeepsDeadlinesWhenCpuOverrunsTest)
+{
+    InSequence sequence;
+    EXPECT_CALL(*cpu, run(16666)).WillOnce(executeCycles(16670, StopReason::BUDGET_EXHAUSTED));
+    EXPECT_CALL(*bus, setVBlank(true)).Times(1);
+    EXPECT_CALL(*cpu, run(16662)).WillOnce(executeCycles(16662, StopReason::BUDGET_EXHAUSTED));
+    EXPECT_CALL(*bus, setVBlank(true)).Times(1);
+    testedScheduler->runFrame();
+    testedScheduler->runFrame();
+    EXPECT_EQ(2, testedScheduler->getFrames());
+}
+
+TEST_F(SchedulerImplTests, runFrameStopsAtBreakpointTest)
+{
+    InSequence sequence;
+    EXPECT_CALL(*cpu, run(16666)).WillOnce(executeCycles(100, StopReason::BREAKPOINT));
+    EXPECT_CALL(*bus, setVBlank(_)).Times(0);
+    EXPECT_EQ(StopReason::BREAKPOINT, testedScheduler->runFrame());
+    EXPECT_CALL(*cpu, run(16566)).WillOnce(executeCycles(16566, StopReason::BUDGET_EXHAUSTED));
+    EXPECT_CALL(*bus, setVBlank(true)).Times(1);
+    EXPECT_EQ(StopReason::VBLANK, testedScheduler->runFrame());
+}
+
+TEST_F(SchedulerImplTests, runFrameStopsAtWatchpointTest)
+{
+    InSequence sequence;
+    EXPECT_CALL(*cpu, run(16666)).WillOnce(executeCycles(200, StopReason::WATCHPOINT));
+    EXPECT_CALL(*bus, setVBlank(_)).Times(0);
+    EXPECT_EQ(StopReason::WATCHPOINT, testedScheduler->runFrame());
+    EXPECT_CALL(*cpu, run(16466)).WillOnce(executeCycles(16466, StopReason::BUDGET_EXHAUSTED));
+    EXPECT_CALL(*bus, setVBlank(true)).Times(1);
+    EXPECT_EQ(StopReason::VBLANK, testedScheduler->runFrame());
+}
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <memory>
+#include <vector>
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -10,6 +12,9 @@
 namespace
 {
     using ::testing::Return;
+    using ::testing::Invoke;
+    using ::testing::ElementsAre;
+    using ::testing::_;
 
     class StackInstructionsTests : public ::testing::Test
     {
@@ -73,26 +78,16 @@ TEST_F(StackInstructionsTests, testPushAll)
     for (auto i = 0; i < 16; i++)
         regs.r[i] = i * 0x10;
 
-    EXPECT_CALL(*memory, writeWord(0x10, 0x00)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x12, 0x10)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x14, 0x20)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x16, 0x30)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x18, 0x40)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x1A, 0x50)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x1C, 0x60)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x1E, 0x70)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x20, 0x80)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x22, 0x90)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x24, 0xA0)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x26, 0xB0)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x28, 0xC0)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x2A, 0xD0)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x2C, 0xE0)).Times(1);
-    EXPECT_CALL(*memory, writeWord(0x2E, 0xF0)).Times(1);
+    std::vector<u8> pushed;
+    EXPECT_CALL(*memory, writeBytes(0x10, _, 32)).Times(1)
+        .WillOnce(Invoke([&pushed](u16, const u8* data, unsigned size) { pushed.assign(data, data + size); }));
 
     testedCpu->executeInstruction(PUSH_ALL_INSTRUCTION_OPCODE);
     EXPECT_EQ(0x30, regs.sp);
     EXPECT_EQ(0x104, regs.pc);
+    EXPECT_THAT(pushed, ElementsAre(
+        0x00, 0x00, 0x10, 0x00, 0x20, 0x00, 0x30, 0x00, 0x40, 0x00, 0x50, 0x00, 0x60, 0x00, 0x70, 0x00,
+        0x80, 0x00, 0x90, 0x00, 0xA0, 0x00, 0xB0, 0x00, 0xC0, 0x00, 0xD0, 0x00, 0xE0, 0x00, 0xF0, 0x00));
 }
 
 TEST_F(StackInstructionsTests, testPopAll)
@@ -105,22 +100,11 @@ TEST_F(StackInstructionsTests, testPopAll)
     for (auto i = 0; i < 16; i++)
         regs.r[i] = 0;
 
-    EXPECT_CALL(*memory, readWord(0x2E)).Times(1).WillOnce(Return(0x2000));
-    EXPECT_CALL(*memory, readWord(0x2C)).Times(1).WillOnce(Return(0x2001));
-    EXPECT_CALL(*memory, readWord(0x2A)).Times(1).WillOnce(Return(0x2002));
-    EXPECT_CALL(*memory, readWord(0x28)).Times(1).WillOnce(Return(0x2003));
-    EXPECT_CALL(*memory, readWord(0x26)).Times(1).WillOnce(Return(0x2004));
-    EXPECT_CALL(*memory, readWord(0x24)).Times(1).WillOnce(Return(0x2005));
-    EXPECT_CALL(*memory, readWord(0x22)).Times(1).WillOnce(Return(0x2006));
-    EXPECT_CALL(*memory, readWord(0x20)).Times(1).WillOnce(Return(0x2007));
-    EXPECT_CALL(*memory, readWord(0x1E)).Times(1).WillOnce(Return(0x2008));
-    EXPECT_CALL(*memory, readWord(0x1C)).Times(1).WillOnce(Return(0x2009));
-    EXPECT_CALL(*memory, readWord(0x1A)).Times(1).WillOnce(Return(0x200A));
-    EXPECT_CALL(*memory, readWord(0x18)).Times(1).WillOnce(Return(0x200B));
-    EXPECT_CALL(*memory, readWord(0x16)).Times(1).WillOnce(Return(0x200C));
-    EXPECT_CALL(*memory, readWord(0x14)).Times(1).WillOnce(Return(0x200D));
-    EXPECT_CALL(*memory, readWord(0x12)).Times(1).WillOnce(Return(0x200E));
-    EXPECT_CALL(*memory, readWord(0x10)).Times(1).WillOnce(Return(0x200F));
+    const u8 STACK[] = {
+        0x0F, 0x20, 0x0E, 0x20, 0x0D, 0x20, 0x0C, 0x20, 0x0B, 0x20, 0x0A, 0x20, 0x09, 0x20, 0x08, 0x20,
+        0x07, 0x20, 0x06, 0x20, 0x05, 0x20, 0x04, 0x20, 0x03, 0x20, 0x02, 0x20, 0x01, 0x20, 0x00, 0x20 };
+    EXPECT_CALL(*memory, readBytes(0x10, _, 32)).Times(1)
+        .WillOnce(Invoke([&STACK](u16, u8* data, unsigned size) { std::copy(STACK, STACK + size, data); }));
 
     testedCpu->executeInstruction(POP_ALL_INSTRUCTION_OPCODE);
     EXPECT_EQ(0x10, regs.sp);
@@ -0,0 +1,65 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../helpers/InstructionWriter.hpp"
+
+#include "../../src/core/CpuImpl.hpp"
+#include "../../src/core/MemoryImpl.hpp"
+#include "../../src/core/BusImpl.hpp"
+#include "../../src/core/GraphicsImpl.hpp"
+
+namespace
+{
+    class StaticCpuImplTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            memory = std::make_shared<MemoryImpl>();
+            graphics = std::make_shared<GraphicsImpl>();
+            bus = std::make_shared<StaticBusImpl>(graphics);
+            testedCpu = std::make_unique<StaticCpuImpl>(memory, bus);
+        }
+
+        std::unique_ptr<StaticCpuImpl> testedCpu;
+        std::shared_ptr<MemoryImpl> memory;
+        std::shared_ptr<GraphicsImpl> graphics;
+        std::shared_ptr<StaticBusImpl> bus;
+    };
+}
+
+TEST_F(StaticCpuImplTests, stepAccessesMemoryTest)
+{
+    writeInstruction(*memory, 0x00, 0x2000, 0xBEEF);  // LDI R0, 0xBEEF
+    writeInstruction(*memory, 0x04, 0x3000, 0x0200);  // STM R0, 0x200
+    writeInstruction(*memory, 0x08, 0x2201, 0x0200);  // LDM R1, 0x200
+    for (auto i = 0; i < 3; i++)
+        testedCpu->step();
+    EXPECT_EQ(0xBEEF, memory->readWord(0x200));
+    EXPECT_EQ(0xBEEF, testedCpu->getRegisters().r[1]);
+    EXPECT_EQ(0x000C, testedCpu->getRegisters().pc);
+}
+
+TEST_F(StaticCpuImplTests, stepExecutesCodeModifiedBySelfTest)
+{
+    writeInstruction(*memory, 0x00, 0x2001, 0x2222);  // LDI R1, 0x2222
+    writeInstruction(*memory, 0x04, 0x3001, 0x000A);  // STM R1, 0xA (operand of the next instruction)
+    writeInstruction(*memory, 0x08, 0x2002, 0x1111);  // LDI R2, 0x1111
+    testedCpu->step();
+    testedCpu->step();
+    testedCpu->step();
+    EXPECT_EQ(0x2222, testedCpu->getRegisters().r[2]);
+}
+
+TEST_F(StaticCpuImplTests, stepAccessesGraphicsThroughBusTest)
+{
+    writeInstruction(*memory, 0x00, 0x0300, 0x0500);  // BGC 5
+    writeInstruction(*memory, 0x04, 0x0200, 0x0000);  // VBLNK
+    graphics->setVBlank(true);
+    testedCpu->step();
+    testedCpu->step();
+    EXPECT_EQ(5, graphics->getBackgroundColorIndex());
+    EXPECT_FALSE(graphics->isVBlank());
+    EXPECT_EQ(0x0008, testedCpu->getRegisters().pc);
+}
@@ -0,0 +1,55 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../../src/core/TracingMemory.hpp"
+
+namespace
+{
+    using ::testing::_;
+
+    class WriteObserverMock : public MemoryWriteObserver
+    {
+    public:
+        MOCK_METHOD2(onMemoryWrite, void(u16, unsigned));
+#if defined(CHIP16_WATCHPOINTS)
+        MOCK_METHOD2(onWatchpointHit, void(u16, bool));
+#endif
+    };
+
+    class TracingMemoryTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            memory = std::make_shared<MemoryImpl>();
+            testedMemory = std::make_unique<TracingMemory>(memory);
+        }
+
+        std::shared_ptr<MemoryImpl> memory;
+        std::unique_ptr<TracingMemory> testedMemory;
+    };
+}
+
+TEST_F(TracingMemoryTests, testAccessesAreForwarded)
+{
+    testedMemory->writeWord(0x100, 0x2587);
+    testedMemory->writeByte(0x102, 0x11);
+    EXPECT_EQ(0x2587, memory->readWord(0x100));
+    EXPECT_EQ(0x11, memory->readByte(0x102));
+
+    memory->writeData(0x200, 0x20, 0x05, 0x34, 0x12);
+    EXPECT_EQ(0x0520, testedMemory->readWord(0x200));
+    EXPECT_EQ(0x12340520, testedMemory->readInstruction(0x200));
+    EXPECT_EQ(memory->readByteReference(0x200), testedMemory->readByteReference(0x200));
+}
+
+TEST_F(TracingMemoryTests, testWriteIntoCodeIsReported)
+{
+    WriteObserverMock observer;
+    testedMemory->setWriteObserver(&observer);
+    testedMemory->markCode(0x100, 4);
+    EXPECT_CALL(observer, onMemoryWrite(0x100, 1)).Times(1);
+    testedMemory->writeByte(0x100, 0x11);
+    testedMemory->setWriteObserver(nullptr);
+}
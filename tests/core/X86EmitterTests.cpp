@@ -0,0 +1,72 @@
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../../src/core/X86Emitter.hpp"
+
+namespace
+{
+    using ::testing::ElementsAre;
+    using Reg = X86Emitter::Reg;
+
+    class X86EmitterTests : public ::testing::Test
+    {
+    protected:
+        X86Emitter emitter;
+    };
+}
+
+TEST_F(X86EmitterTests, testPushPop)
+{
+    emitter.push(Reg::RBX);
+    emitter.push(Reg::R12);
+    emitter.pop(Reg::R12);
+    emitter.pop(Reg::RBX);
+    EXPECT_THAT(emitter.getCode(), ElementsAre(0x53, 0x41, 0x54, 0x41, 0x5C, 0x5B));
+}
+
+TEST_F(X86EmitterTests, testMovRegReg64)
+{
+    emitter.movRegReg64(Reg::RBX, Reg::RDI);
+    EXPECT_THAT(emitter.getCode(), ElementsAre(0x48, 0x89, 0xFB));
+}
+
+TEST_F(X86EmitterTests, testMemoryOperands)
+{
+    emitter.movzxRegMem16(Reg::RAX, Reg::RBP, 0x04);
+    emitter.movMemImm16(Reg::RBP, 0x00, 0x1234);
+    emitter.movMemReg8(Reg::RBP, 0x24, Reg::RSI);
+    EXPECT_THAT(emitter.getCode(), ElementsAre(
+        0x0F, 0xB7, 0x45, 0x04,
+        0x66, 0xC7, 0x45, 0x00, 0x34, 0x12,
+        0x40, 0x88, 0x75, 0x24));
+}
+
+TEST_F(X86EmitterTests, testMemoryOperandsBasedOnR12)
+{
+    emitter.movMemReg64(Reg::R12, 0x08, Reg::RAX);
+    emitter.aluMemImm32(X86Emitter::AluOperation::CMP, Reg::R12, 0x00, 0);
+    EXPECT_THAT(emitter.getCode(), ElementsAre(
+        0x49, 0x89, 0x44, 0x24, 0x08,
+        0x41, 0x81, 0x7C, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00));
+}
+
+TEST_F(X86EmitterTests, testByteRegistersRequireRex)
+{
+    emitter.setcc(X86Emitter::Condition::EQUAL, Reg::RDI);
+    emitter.setcc(X86Emitter::Condition::EQUAL, Reg::RCX);
+    EXPECT_THAT(emitter.getCode(), ElementsAre(0x40, 0x0F, 0x94, 0xC7, 0x0F, 0x94, 0xC1));
+}
+
+TEST_F(X86EmitterTests, testJumpToLabels)
+{
+    const auto backward = emitter.createLabel();
+    const auto forward = emitter.createLabel();
+    emitter.bind(backward);
+    emitter.jmp(backward);
+    emitter.jcc(X86Emitter::Condition::NOT_EQUAL, forward);
+    emitter.bind(forward);
+    EXPECT_THAT(emitter.getCode(), ElementsAre(
+        0xE9, 0xFB, 0xFF, 0xFF, 0xFF,
+        0x0F, 0x85, 0x00, 0x00, 0x00, 0x00));
+}
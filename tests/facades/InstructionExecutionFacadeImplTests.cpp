@@ -0,0 +1,66 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../mocks/CpuMock.hpp"
+#include "../mocks/SchedulerMock.hpp"
+
+#include "../helpers/InstructionWriter.hpp"
+
+#include "../../src/core/BusImpl.hpp"
+#include "../../src/core/GraphicsImpl.hpp"
+#include "../../src/core/MemoryImpl.hpp"
+#include "../../src/facades/InstructionExecutionFacadeImpl.hpp"
+
+namespace
+{
+    using ::testing::Return;
+
+    class InstructionExecutionFacadeImplTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            cpu = std::make_shared<CpuMock>();
+            scheduler = std::make_shared<SchedulerMock>();
+            testedFacade = std::make_unique<InstructionExecutionFacadeImpl>(cpu, scheduler);
+        }
+
+        std::unique_ptr<InstructionExecutionFacadeImpl> testedFacade;
+        std::shared_ptr<CpuMock> cpu;
+        std::shared_ptr<SchedulerMock> scheduler;
+    };
+}
+
+TEST_F(InstructionExecutionFacadeImplTests, executeInstructionStepsCpuTest)
+{
+    EXPECT_CALL(*cpu, step()).Times(1);
+    testedFacade->executeInstruction();
+}
+
+TEST_F(InstructionExecutionFacadeImplTests, runUntilVBlankRunsSingleFrameTest)
+{
+    EXPECT_CALL(*cpu, run(16666)).Times(1).WillOnce(Return(StopReason::VBLANK));
+    EXPECT_EQ(StopReason::VBLANK, testedFacade->runUntilVBlank());
+}
+
+TEST_F(InstructionExecutionFacadeImplTests, runFrameUsesSchedulerTest)
+{
+    EXPECT_CALL(*scheduler, runFrame()).Times(1).WillOnce(Return(StopReason::VBLANK));
+    EXPECT_EQ(StopReason::VBLANK, testedFacade->runFrame());
+}
+
+TEST_F(InstructionExecutionFacadeImplTests, createExecutesCodeWithEachBackendTest)
+{
+    for (auto backend : { CpuBackend::INTERPRETER, CpuBackend::JIT })
+    {
+        auto memory = std::make_shared<MemoryImpl>();
+        auto bus = std::make_shared<StaticBusImpl>(std::make_shared<GraphicsImpl>());
+        writeInstruction(*memory, 0x00, 0x4000, 0x0001);  // ADDI R0, 1
+        writeInstruction(*memory, 0x04, 0x3000, 0x0500);  // STM R0, 0x500
+        writeInstruction(*memory, 0x08, 0x0200, 0x0000);  // VBLNK
+        auto facade = InstructionExecutionFacadeImpl::create(backend, memory, bus);
+        EXPECT_EQ(StopReason::VBLANK, facade->runUntilVBlank());
+        EXPECT_EQ(0x0001, memory->readWord(0x500));
+    }
+}
@@ -0,0 +1,64 @@
+#include "../../src/facades/MappedRomInputStream.hpp"
+
+#if CHIP16_MMAP_SUPPORTED
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace
+{
+    class MappedRomInputStreamTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            std::ofstream file(PATH, std::ios::binary);
+            file.write(ROM.data(), ROM.size());
+        }
+
+        void TearDown() override
+        {
+            std::remove(PATH);
+        }
+
+        static constexpr const char* PATH = "/tmp/chip16-mapped-rom-test.c16";
+        const std::string ROM = std::string("CH16\x00\x11\x20\x00\x00\x00", 10);
+    };
+}
+
+TEST_F(MappedRomInputStreamTests, testDataContainsFile)
+{
+    MappedRomInputStream testedStream(PATH);
+    ASSERT_NE(nullptr, testedStream.getData());
+    ASSERT_EQ(ROM.size(), testedStream.getSize());
+    EXPECT_EQ(ROM, std::string(reinterpret_cast<const char*>(testedStream.getData()), testedStream.getSize()));
+}
+
+TEST_F(MappedRomInputStreamTests, testStreamReadsMappedData)
+{
+    MappedRomInputStream testedStream(PATH);
+    auto& stream = testedStream.getStream();
+    ASSERT_FALSE(stream.fail());
+
+    const std::string content{ std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+    EXPECT_EQ(ROM, content);
+
+    stream.clear();
+    stream.seekg(4, stream.beg);
+    EXPECT_EQ(0x00, stream.get());
+    EXPECT_EQ(0x11, stream.get());
+}
+
+TEST_F(MappedRomInputStreamTests, testMissingFileFails)
+{
+    MappedRomInputStream testedStream("/tmp/chip16-missing-rom-test.c16");
+    EXPECT_TRUE(testedStream.getStream().fail());
+    EXPECT_EQ(nullptr, testedStream.getData());
+    EXPECT_EQ(0, testedStream.getSize());
+}
+
+#endif
@@ -1,3 +1,4 @@
+#include <filesystem>
 #include <memory>
 #include <sstream>
 #include <gtest/gtest.h>
@@ -11,9 +12,11 @@
 
 namespace
 {
+    using ::testing::NiceMock;
     using ::testing::Return;
     using ::testing::ReturnRef;
     using ::testing::Eq;
+    using ::testing::SizeIs;
     using ::testing::_;
 
     class RomFacadeImplTests : public ::testing::Test
@@ -44,7 +47,7 @@ TEST_F(RomFacadeImplTests, testLoadRomWithoutHeader)
     std::stringstream romWithoutHeaderStream;
     romWithoutHeaderStream.write(&ROM_WITHOUT_HEADER_STR[0], ROM_WITHOUT_HEADER_STR.size());
 
-    auto romInputStream = std::make_shared<RomInputStreamMock>();
+    auto romInputStream = std::make_shared<NiceMock<RomInputStreamMock>>();
     EXPECT_CALL(*romInputStream, getStream()).Times(1).WillOnce(ReturnRef(romWithoutHeaderStream));
     testCpuRegisters.pc = 0xFFFF;
 
@@ -65,7 +68,7 @@ TEST_F(RomFacadeImplTests, testLoadRomWithCorrectHeader)
     std::stringstream romWithCorrectHeader;
     romWithCorrectHeader.write(&ROM_WITH_CORRECT_HEADER_STR[0], ROM_WITH_CORRECT_HEADER_STR.size());
 
-    auto romInputStream = std::make_shared<RomInputStreamMock>();
+    auto romInputStream = std::make_shared<NiceMock<RomInputStreamMock>>();
     EXPECT_CALL(*romInputStream, getStream()).Times(1).WillOnce(ReturnRef(romWithCorrectHeader));
     testCpuRegisters.pc = 0xFFFF;
 
@@ -86,7 +89,7 @@ TEST_F(RomFacadeImplTests, testLoadRomWithIncorrectChecksum)
     std::stringstream romWithIncorrectChecksum;
     romWithIncorrectChecksum.write(&INCORRECT_CHECKSUM_ROM_STR[0], INCORRECT_CHECKSUM_ROM_STR.size());
 
-    auto romInputStream = std::make_shared<RomInputStreamMock>();
+    auto romInputStream = std::make_shared<NiceMock<RomInputStreamMock>>();
     EXPECT_CALL(*romInputStream, getStream()).Times(1).WillOnce(ReturnRef(romWithIncorrectChecksum));
     testCpuRegisters.pc = 0xFFFF;
 
@@ -106,7 +109,7 @@ TEST_F(RomFacadeImplTests, testLoadRomWithNonZeroStartAddr)
     std::stringstream romWithNonZeroStartAddr;
     romWithNonZeroStartAddr.write(&NON_ZERO_START_ADDR_ROM_STR[0], NON_ZERO_START_ADDR_ROM_STR.size());
 
-    auto romInputStream = std::make_shared<RomInputStreamMock>();
+    auto romInputStream = std::make_shared<NiceMock<RomInputStreamMock>>();
     EXPECT_CALL(*romInputStream, getStream()).Times(1).WillOnce(ReturnRef(romWithNonZeroStartAddr));
     testCpuRegisters.pc = 0xFFFF;
 
@@ -115,4 +118,76 @@ TEST_F(RomFacadeImplTests, testLoadRomWithNonZeroStartAddr)
 
     EXPECT_TRUE(result);
     EXPECT_EQ(0x16, testCpuRegisters.pc);
-}
\ No newline at end of file
+}
+
+TEST_F(RomFacadeImplTests, testLoadRomImportsSavedTranslationCache)
+{
+    const auto directory = std::filesystem::temp_directory_path() / "chip16-rom-facade-tests";
+    std::filesystem::remove_all(directory);
+    testedFacade->setTranslationCache(std::make_shared<TranslationCache>(directory.string()));
+
+    const char * ROM_WITHOUT_HEADER =
+        "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00" // 8 NOP instructions
+        "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00";// 8 NOP instructions
+    const std::string ROM_WITHOUT_HEADER_STR(ROM_WITHOUT_HEADER, 32);
+    std::stringstream romWithoutHeaderStream;
+    romWithoutHeaderStream.write(&ROM_WITHOUT_HEADER_STR[0], ROM_WITHOUT_HEADER_STR.size());
+
+    auto romInputStream = std::make_shared<NiceMock<RomInputStreamMock>>();
+    EXPECT_CALL(*romInputStream, getStream()).Times(2).WillRepeatedly(ReturnRef(romWithoutHeaderStream));
+    EXPECT_CALL(*memory, loadRomFromStream(_)).Times(2);
+    EXPECT_CALL(*cpu, exportCode()).WillOnce(Return(std::vector<CachedBlock>{ { 0x0000, 0x0020, 0x12345678 } }));
+    // Nothing is cached before the first run
+    EXPECT_CALL(*cpu, importCode(SizeIs(1))).WillOnce(Return(1));
+
+    EXPECT_TRUE(testedFacade->loadRomIntoMemory(romInputStream));
+    testedFacade->saveTranslationCache();
+    EXPECT_TRUE(testedFacade->loadRomIntoMemory(romInputStream));
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_F(RomFacadeImplTests, testLoadRomFromDataWithCorrectHeader)
+{
+    const char * NON_ZERO_START_ADDR_ROM =
+        "\x43\x48\x31\x36\x00\x11\x20\x00\x00\x00\x16\x00\xAD\x55\x0A\x19" // Magic number, Version 1.1, Rom size 32B, Start addr 0x16, checksum 0x190A55AD
+        "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00" // 8 NOP instructions
+        "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00";// 8 NOP instructions
+    const auto* romData = reinterpret_cast<const u8*>(NON_ZERO_START_ADDR_ROM);
+    std::stringstream unusedStream;
+
+    auto romInputStream = std::make_shared<NiceMock<RomInputStreamMock>>();
+    ON_CALL(*romInputStream, getStream()).WillByDefault(ReturnRef(unusedStream));
+    ON_CALL(*romInputStream, getData()).WillByDefault(Return(romData));
+    ON_CALL(*romInputStream, getSize()).WillByDefault(Return(48));
+    testCpuRegisters.pc = 0xFFFF;
+
+    // ROM is copied directly from the data, skipping the header
+    EXPECT_CALL(*memory, loadRomFromStream(_)).Times(0);
+    EXPECT_CALL(*memory, loadRom(romData + 16, 32)).Times(1);
+    auto result = testedFacade->loadRomIntoMemory(romInputStream);
+
+    EXPECT_TRUE(result);
+    EXPECT_EQ(0x16, testCpuRegisters.pc);
+}
+
+TEST_F(RomFacadeImplTests, testLoadRomFromDataWithIncorrectChecksum)
+{
+    const char * ROM_WITH_INCORRECT_CHECKSUM =
+        "\x43\x48\x31\x36\x00\x11\x20\x00\x00\x00\x16\x00\xAD\x55\x0A\x19" // Magic number, Version 1.1, Rom size 32B, Start addr 0x16, checksum 0x190A55AD
+        "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00" // 8 NOP instructions
+        "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x01";// 7 NOP instructions, corrupted NOP
+    std::stringstream unusedStream;
+
+    auto romInputStream = std::make_shared<NiceMock<RomInputStreamMock>>();
+    ON_CALL(*romInputStream, getStream()).WillByDefault(ReturnRef(unusedStream));
+    ON_CALL(*romInputStream, getData()).WillByDefault(Return(reinterpret_cast<const u8*>(ROM_WITH_INCORRECT_CHECKSUM)));
+    ON_CALL(*romInputStream, getSize()).WillByDefault(Return(48));
+    testCpuRegisters.pc = 0xFFFF;
+
+    EXPECT_CALL(*memory, loadRom(_, _)).Times(0);
+    auto result = testedFacade->loadRomIntoMemory(romInputStream);
+
+    EXPECT_FALSE(result);
+    EXPECT_EQ(0xFFFF, testCpuRegisters.pc);
+}
@@ -0,0 +1,59 @@
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../helpers/InstructionWriter.hpp"
+
+#include "../../src/core/BusImpl.hpp"
+#include "../../src/core/CpuImpl.hpp"
+#include "../../src/facades/SnapshotFacadeImpl.hpp"
+
+namespace
+{
+    class SnapshotFacadeImplTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            memory = std::make_shared<MemoryImpl>();
+            graphics = std::make_shared<GraphicsImpl>();
+            auto bus = std::make_shared<BusImpl>(graphics);
+            cpu = std::make_shared<CpuImpl>(memory, bus);
+            scheduler = std::make_shared<SchedulerImpl>(cpu, bus);
+            testedFacade = std::make_unique<SnapshotFacadeImpl>(cpu, memory, graphics, scheduler);
+        }
+
+        std::shared_ptr<MemoryImpl> memory;
+        std::shared_ptr<GraphicsImpl> graphics;
+        std::shared_ptr<CpuImpl> cpu;
+        std::shared_ptr<SchedulerImpl> scheduler;
+        std::unique_ptr<SnapshotFacadeImpl> testedFacade;
+    };
+}
+
+TEST_F(SnapshotFacadeImplTests, testRestoredMachineRepeatsFrame)
+{
+    writeInstruction(*memory, 0x00, 0x0700, 0xFFFF);  // RND R0, 0xFFFF
+    writeInstruction(*memory, 0x04, 0x3000, 0x1000);  // STM R0, 0x1000
+    writeInstruction(*memory, 0x08, 0x4001, 0x0001);  // ADDI R1, 1
+    writeInstruction(*memory, 0x0C, 0x1000, 0x0000);  // JMP 0x0
+    const auto snapshot = testedFacade->takeSnapshot();
+
+    scheduler->runFrame();
+    const auto stored = memory->readWord(0x1000);
+    const auto registers = cpu->getRegisters();
+    EXPECT_EQ(1, scheduler->getFrames());
+    EXPECT_TRUE(graphics->isVBlank());
+
+    testedFacade->restoreSnapshot(snapshot);
+    EXPECT_EQ(0, memory->readWord(0x1000));
+    EXPECT_EQ(0, cpu->getCycles());
+    EXPECT_EQ(0, scheduler->getFrames());
+    EXPECT_FALSE(graphics->isVBlank());
+
+    scheduler->runFrame();
+    EXPECT_EQ(stored, memory->readWord(0x1000));
+    EXPECT_EQ(registers.r[0], cpu->getRegisters().r[0]);
+    EXPECT_EQ(registers.r[1], cpu->getRegisters().r[1]);
+    EXPECT_EQ(1, scheduler->getFrames());
+}
@@ -0,0 +1,95 @@
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../../src/facades/TranslationCache.hpp"
+
+namespace
+{
+    class TranslationCacheTests : public ::testing::Test
+    {
+    protected:
+        void SetUp() override
+        {
+            directory = std::filesystem::temp_directory_path() / "chip16-translation-cache-tests";
+            std::filesystem::remove_all(directory);
+            testedCache = std::make_unique<TranslationCache>(directory.string());
+        }
+
+        void TearDown() override
+        {
+            std::filesystem::remove_all(directory);
+        }
+
+        void overwriteByte(u32 romChecksum, std::streamoff offset, char value)
+        {
+            std::fstream file(testedCache->getPath(romChecksum), std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(offset);
+            file.put(value);
+        }
+
+        static constexpr u32 ROM_CHECKSUM = 0x12345678;
+        const std::vector<CachedBlock> BLOCKS = {
+            { 0x0000, 0x0010, 0xCAFEBABE },
+            { 0x0200, 0x0004, 0xDEADBEEF }
+        };
+
+        std::filesystem::path directory;
+        std::unique_ptr<TranslationCache> testedCache;
+    };
+}
+
+TEST_F(TranslationCacheTests, loadReturnsSavedBlocksTest)
+{
+    ASSERT_TRUE(testedCache->save(ROM_CHECKSUM, BLOCKS));
+    const auto blocks = testedCache->load(ROM_CHECKSUM);
+    ASSERT_EQ(BLOCKS.size(), blocks.size());
+    for (auto i = 0u; i < blocks.size(); i++)
+    {
+        EXPECT_EQ(BLOCKS[i].startAddress, blocks[i].startAddress);
+        EXPECT_EQ(BLOCKS[i].size, blocks[i].size);
+        EXPECT_EQ(BLOCKS[i].checksum, blocks[i].checksum);
+    }
+}
+
+TEST_F(TranslationCacheTests, loadIgnoresMissingFileTest)
+{
+    EXPECT_TRUE(testedCache->load(ROM_CHECKSUM).empty());
+}
+
+TEST_F(TranslationCacheTests, loadIgnoresFileOfOtherRomTest)
+{
+    ASSERT_TRUE(testedCache->save(ROM_CHECKSUM, BLOCKS));
+    std::filesystem::rename(testedCache->getPath(ROM_CHECKSUM), testedCache->getPath(0x87654321));
+    EXPECT_TRUE(testedCache->load(0x87654321).empty());
+}
+
+TEST_F(TranslationCacheTests, loadIgnoresFileOfOtherVersionTest)
+{
+    ASSERT_TRUE(testedCache->save(ROM_CHECKSUM, BLOCKS));
+    overwriteByte(ROM_CHECKSUM, 4, TranslationCache::FORMAT_VERSION + 1);
+    EXPECT_TRUE(testedCache->load(ROM_CHECKSUM).empty());
+}
+
+TEST_F(TranslationCacheTests, loadIgnoresCorruptedFileTest)
+{
+    ASSERT_TRUE(testedCache->save(ROM_CHECKSUM, BLOCKS));
+    overwriteByte(ROM_CHECKSUM, 21, 0x7F);
+    EXPECT_TRUE(testedCache->load(ROM_CHECKSUM).empty());
+}
+
+TEST_F(TranslationCacheTests, loadIgnoresTruncatedFileTest)
+{
+    ASSERT_TRUE(testedCache->save(ROM_CHECKSUM, BLOCKS));
+    std::filesystem::resize_file(testedCache->getPath(ROM_CHECKSUM), 24);
+    EXPECT_TRUE(testedCache->load(ROM_CHECKSUM).empty());
+}
+
+TEST_F(TranslationCacheTests, saveRemovesTemporaryFileWhenReplacingFailsTest)
+{
+    // Non-empty directory in place of the cache file cannot be replaced
+    std::filesystem::create_directories(std::filesystem::path(testedCache->getPath(ROM_CHECKSUM)) / "entry");
+    EXPECT_FALSE(testedCache->save(ROM_CHECKSUM, BLOCKS));
+    EXPECT_FALSE(std::filesystem::exists(testedCache->getPath(ROM_CHECKSUM) + ".tmp"));
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../../src/core/MemoryImpl.hpp"
+
+/**
+ * Writes instruction into memory in the byte order fetched by cpu.
+ *
+ * @param memory Memory receiving the instruction.
+ * @param addr Address of the instruction.
+ * @param opcode First word of the instruction, opcode in its low byte.
+ * @param operand Second word of the instruction.
+ */
+inline void writeInstruction(MemoryImpl& memory, u16 addr, u16 opcode, u16 operand)
+{
+    memory.writeData(addr, opcode & 0xFF, opcode >> 8, operand & 0xFF, operand >> 8);
+}
@@ -12,5 +12,19 @@ public:
     MOCK_METHOD0(popFromStack, u16());
     MOCK_METHOD1(pushIntoStack, void(u16));
     MOCK_METHOD1(executeInstruction, void(u16));
+    MOCK_METHOD0(step, void());
+    MOCK_METHOD1(run, StopReason(unsigned));
+    MOCK_METHOD2(setBreakpoint, void(u16, bool));
+    MOCK_CONST_METHOD0(getCycles, std::uint64_t());
+    MOCK_METHOD1(skipCycles, void(std::uint64_t));
+    MOCK_METHOD1(setRandomSeed, void(std::uint64_t));
+    MOCK_CONST_METHOD0(getRandomSeed, std::uint64_t());
+    MOCK_CONST_METHOD0(exportCode, std::vector<CachedBlock>());
+    MOCK_METHOD1(importCode, unsigned(const std::vector<CachedBlock>&));
+    MOCK_CONST_METHOD0(takeSnapshot, Snapshot());
+    MOCK_METHOD1(restoreSnapshot, void(const Snapshot&));
     MOCK_METHOD0(getRegisters, CpuRegisters& ());
+#if defined(CHIP16_WATCHPOINTS)
+    MOCK_CONST_METHOD0(getWatchpointHit, WatchpointHit());
+#endif
 };
\ No newline at end of file
@@ -8,11 +8,31 @@
 class MemoryMock : public Memory
 {
 public:
+    MemoryMock()
+    {
+        // Tests may stub words of the instruction separately
+        ON_CALL(*this, readInstruction(::testing::_)).WillByDefault(::testing::Invoke([this](u16 addr) {
+            return readWord(addr) + readWord(addr + 2) * 0x10000u;
+        }));
+        // Tests may stub or expect individual bytes of the block
+        ON_CALL(*this, readBytes(::testing::_, ::testing::_, ::testing::_)).WillByDefault(::testing::Invoke(
+            [this](u16 addr, u8* data, unsigned size) {
+                for (auto i = 0u; i < size; i++)
+                    data[i] = readByte(addr + i);
+            }));
+    }
+
     MOCK_CONST_METHOD1(readByte, u8(u16));
     MOCK_METHOD2(writeByte, void(u16, u8));
     MOCK_CONST_METHOD1(readWord, u16(u16));
     MOCK_METHOD2(writeWord, void(u16, u16));
+    MOCK_CONST_METHOD1(readInstruction, u32(u16));
+    MOCK_CONST_METHOD3(readBytes, void(u16, u8*, unsigned));
+    MOCK_METHOD3(writeBytes, void(u16, const u8*, unsigned));
     MOCK_CONST_METHOD1(readControllerState, ControllerState(unsigned));
-    MOCK_CONST_METHOD1(readByteReference, std::vector<u8>::const_iterator(u16));
+    MOCK_CONST_METHOD1(readByteReference, const u8*(u16));
     MOCK_METHOD1(loadRomFromStream, void(std::istream&));
+    MOCK_METHOD2(loadRom, void(const u8*, std::size_t));
+    MOCK_METHOD1(setWriteObserver, void(MemoryWriteObserver*));
+    MOCK_METHOD2(markCode, void(u16, unsigned));
 };
\ No newline at end of file
@@ -9,4 +9,6 @@ class RomInputStreamMock : public RomInputStream
 {
 public:
     MOCK_METHOD0(getStream, std::istream& ());
+    MOCK_CONST_METHOD0(getData, const u8*());
+    MOCK_CONST_METHOD0(getSize, std::size_t());
 };
\ No newline at end of file
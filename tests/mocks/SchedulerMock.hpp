@@ -0,0 +1,14 @@
+#pragma once
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "../../src/core/Scheduler.hpp"
+
+class SchedulerMock : public Scheduler
+{
+public:
+    MOCK_METHOD0(runFrame, StopReason());
+    MOCK_CONST_METHOD0(getCycles, std::uint64_t());
+    MOCK_CONST_METHOD0(getFrames, std::uint64_t());
+};
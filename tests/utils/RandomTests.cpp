@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <array>
+#include "../../src/utils/Random.hpp"
+
+TEST(RandomTests, testSameSeedGivesSameSequence)
+{
+    Random first(42);
+    Random second(7);
+    second.setSeed(42);
+    EXPECT_EQ(42u, second.getSeed());
+    for (auto i = 0; i < 100; i++)
+        EXPECT_EQ(first.next(), second.next());
+}
+
+TEST(RandomTests, testDifferentSeedsGiveDifferentSequences)
+{
+    Random first(1);
+    Random second(2);
+    auto differences = 0;
+    for (auto i = 0; i < 100; i++)
+        differences += first.next() != second.next();
+    EXPECT_LT(90, differences);
+}
+
+TEST(RandomTests, testGetReturnsEveryValueOfRange)
+{
+    Random random(1);
+    std::array<unsigned, 6> counts = {};
+    for (auto i = 0; i < 6000; i++)
+    {
+        const auto value = random.get(std::uint16_t(0), std::uint16_t(5));
+        ASSERT_GE(5, value);
+        counts[value]++;
+    }
+    for (auto count : counts)
+        EXPECT_NEAR(1000, count, 150);
+}
+
+TEST(RandomTests, testGetSingleValueRange)
+{
+    Random random(1);
+    EXPECT_EQ(0, random.get(std::uint16_t(0), std::uint16_t(0)));
+    EXPECT_EQ(-3, random.get(-3, -3));
+}
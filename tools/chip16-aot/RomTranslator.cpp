@@ -0,0 +1,385 @@
+#include "RomTranslator.hpp"
+
+#include <deque>
+#include <iomanip>
+#include <sstream>
+
+#include "../../src/core/ConditionalBranch.hpp"
+#include "../../src/core/FlagsLiveness.hpp"
+#include "../../src/core/IdleLoopAnalysis.hpp"
+#include "../../src/utils/Crc32.hpp"
+#include "../../src/log/HexModificator.hpp"
+
+Logger RomTranslator::LOG(STRINGIFY(RomTranslator));
+
+RomTranslator::RomTranslator(const Memory& memory)
+    : memory(memory)
+{
+}
+
+void RomTranslator::translate(u16 entryAddress)
+{
+    std::deque<u16> pending{ entryAddress };
+    while (!pending.empty())
+    {
+        const auto addr = pending.front();
+        pending.pop_front();
+        if (blocks.count(addr) != 0)
+            continue;
+
+        auto block = decodeBlock(addr);
+        if (block.instructions.empty())
+            continue;
+
+        for (auto successor : findSuccessors(block))
+            pending.push_back(successor);
+        blocks.emplace(addr, std::move(block));
+    }
+    LOG.info("Translated ", blocks.size(), " blocks reachable from ", logHex(entryAddress));
+}
+
+void RomTranslator::writeProgram(std::ostream& os, const std::string& romName) const
+{
+    os << "// Generated by chip16-aot from " << romName << ". Do not edit.\n"
+       << "#include <iterator>\n"
+       << "\n"
+       << "#include \"core/AotCpuImpl.hpp\"\n"
+       << "\n"
+       << "namespace\n"
+       << "{\n";
+
+    for (const auto& [addr, block] : blocks)
+        writeBlock(os, block);
+
+    os << "    const TranslatedBlock BLOCKS[] = {\n";
+    for (const auto& [addr, block] : blocks)
+    {
+        os << "        { " << hex(block.startAddress) << ", " << hex(block.endAddress) << ", "
+           << hex(calculateChecksum(block)) << ", &block" << hex(addr) << " },\n";
+    }
+    os << "    };\n"
+       << "}\n"
+       << "\n"
+       << "const TranslatedProgram& getTranslatedProgram()\n"
+       << "{\n"
+       << "    static const TranslatedProgram PROGRAM = { BLOCKS, std::size(BLOCKS) };\n"
+       << "    return PROGRAM;\n"
+       << "}\n";
+}
+
+std::size_t RomTranslator::getBlocksCount() const
+{
+    return blocks.size();
+}
+
+RomTranslator::Block RomTranslator::decodeBlock(u16 addr) const
+{
+    Block block;
+    block.startAddress = addr;
+
+    u32 current = addr;
+    while (block.instructions.size() < MAX_BLOCK_INSTRUCTIONS && current + 4 <= 0x10000)
+    {
+        const auto word = memory.readInstruction(current);
+        Instruction instruction{ static_cast<u16>(current), static_cast<u16>(word & 0xFFFF), static_cast<u16>(word >> 16) };
+        block.instructions.push_back(instruction);
+        current += 4;
+        if (InstructionSet::endsBasicBlock(getOperation(instruction)))
+            break;
+    }
+    block.endAddress = current;
+    return block;
+}
+
+std::vector<u16> RomTranslator::findSuccessors(const Block& block) const
+{
+    const auto& last = block.instructions.back();
+    const u32 next = last.addr + 4;
+    std::vector<u16> successors;
+
+    switch (getOperation(last))
+    {
+    case Operation::JUMP:
+        successors.push_back(last.operand);
+        break;
+    case Operation::JUMP_CARRY:
+    case Operation::JUMP_CONDITIONALLY:
+    case Operation::JUMP_REGS_EQUAL:
+    case Operation::CALL:
+    case Operation::CALL_CONDITIONALLY:
+        successors.push_back(last.operand);
+        if (next < 0x10000)
+            successors.push_back(next);
+        break;
+    case Operation::VBLNK:
+        // Waiting for vertical blank repeats the instruction
+        successors.push_back(last.addr);
+        if (next < 0x10000)
+            successors.push_back(next);
+        break;
+    case Operation::CALL_INDIRECT:
+        if (next < 0x10000)
+            successors.push_back(next);
+        break;
+    case Operation::RETURN:
+    case Operation::JUMP_INDIRECT:
+    case Operation::INVALID:
+        break;
+    default:
+        if (next < 0x10000)
+            successors.push_back(next);
+        break;
+    }
+    return successors;
+}
+
+u32 RomTranslator::calculateChecksum(const Block& block) const
+{
+    std::vector<u8> code;
+    for (u32 addr = block.startAddress; addr < block.endAddress; addr++)
+        code.push_back(memory.readByte(addr));
+    return Crc32::checksum(code.begin(), code.end());
+}
+
+unsigned RomTranslator::findIdleLoopLength(const Instruction& jump) const
+{
+    const u16 start = jump.operand;
+    if (start > jump.addr || (jump.addr - start) % 4 != 0
+        || static_cast<unsigned>(jump.addr - start) / 4 >= IdleLoopAnalysis::MAX_LOOP_INSTRUCTIONS)
+        return 0;
+
+    std::vector<std::pair<u16, u16>> loop;
+    for (u16 current = start; current != jump.addr; current += 4)
+    {
+        const auto word = memory.readInstruction(current);
+        loop.emplace_back(word & 0xFFFF, word >> 16);
+    }
+    loop.emplace_back(jump.opcode, jump.operand);
+    return IdleLoopAnalysis::isIdleLoop(loop) ? loop.size() : 0;
+}
+
+void RomTranslator::writeBlock(std::ostream& os, const Block& block) const
+{
+    os << "    void block" << hex(block.startAddress) << "(AotCpuImpl& cpu)\n"
+       << "    {\n"
+       << "        [[maybe_unused]] auto& registers = cpu.getRawRegisters();\n";
+
+    std::vector<Operation> operations;
+    for (const auto& instruction : block.instructions)
+        operations.push_back(getOperation(instruction));
+    const auto deadFlags = FlagsLiveness::findDeadFlags(operations);
+
+    for (auto i = 0u; i < block.instructions.size(); i++)
+    {
+        const auto written = InstructionSet::flagsWritten(operations[i]);
+        writeInstruction(os, block.instructions[i], written == 0 || deadFlags[i] != written);
+    }
+
+    if (!InstructionSet::endsBasicBlock(getOperation(block.instructions.back())))
+        os << "        registers.pc = " << hex(block.endAddress & 0xFFFF) << ";\n";
+
+    os << "    }\n"
+       << "\n";
+}
+
+void RomTranslator::writeInstruction(std::ostream& os, const Instruction& instruction, bool evaluateFlags) const
+{
+    const auto operation = getOperation(instruction);
+    const auto x = instruction.opcode & 0xF;
+    const auto y = (instruction.opcode >> 4) & 0xF;
+    const auto z = (instruction.operand >> 8) & 0xF;
+    const auto imm = hex(instruction.operand);
+    const auto next = hex((instruction.addr + 4) & 0xFFFF);
+    const auto rx = "registers.r[" + std::to_string(x) + "]";
+    const auto ry = "registers.r[" + std::to_string(y) + "]";
+    const auto rz = "registers.r[" + std::to_string(z) + "]";
+
+    os << "        // " << hex(instruction.addr) << ": "
+       << InstructionSet::describe(instruction.opcode >> 8).mnemonic << "\n";
+
+    // Instructions with dead flags compute only the result
+    const auto add = [evaluateFlags](const std::string& operand1, const std::string& operand2) {
+        return evaluateFlags ? "cpu.add(" + operand1 + ", " + operand2 + ")"
+                             : "static_cast<u16>(" + operand1 + " + " + operand2 + ")";
+    };
+    const auto subtract = [evaluateFlags](const std::string& operand1, const std::string& operand2) {
+        return evaluateFlags ? "cpu.subtract(" + operand1 + ", " + operand2 + ")"
+                             : "static_cast<u16>(" + operand1 + " - " + operand2 + ")";
+    };
+    const auto logical = [evaluateFlags](const std::string& result) {
+        return evaluateFlags ? "cpu.updateLogicalFlags(static_cast<u16>(" + result + "))"
+                             : "static_cast<u16>(" + result + ")";
+    };
+
+    std::ostringstream code;
+    bool translated = true;
+    switch (operation)
+    {
+    case Operation::NOP:
+        break;
+    case Operation::LOAD_REGISTER_IMMEDIATE:
+        code << rx << " = " << imm << ";";
+        break;
+    case Operation::LOAD_SP_IMMEDIATE:
+        code << "registers.sp = " << imm << ";";
+        break;
+    case Operation::MOVE_REGISTER:
+        code << rx << " = " << ry << ";";
+        break;
+
+    case Operation::ADD_IMMEDIATE:
+        code << rx << " = " << add(rx, imm) << ";";
+        break;
+    case Operation::ADD_REGISTER:
+        code << rx << " = " << add(rx, ry) << ";";
+        break;
+    case Operation::ADD_REGISTERS:
+        code << rz << " = " << add(rx, ry) << ";";
+        break;
+    case Operation::SUBTRACT_IMMEDIATE:
+        code << rx << " = " << subtract(rx, imm) << ";";
+        break;
+    case Operation::SUBTRACT_REGISTER:
+        code << rx << " = " << subtract(rx, ry) << ";";
+        break;
+    case Operation::SUBTRACT_REGISTERS:
+        code << rz << " = " << subtract(rx, ry) << ";";
+        break;
+    case Operation::COMPARE_IMMEDIATE:
+        if (evaluateFlags)
+            code << "cpu.subtract(" << rx << ", " << imm << ");";
+        break;
+    case Operation::COMPARE_REGISTER:
+        if (evaluateFlags)
+            code << "cpu.subtract(" << rx << ", " << ry << ");";
+        break;
+
+    case Operation::BITWISE_AND_IMMEDIATE:
+        code << rx << " = " << logical(rx + " & " + imm) << ";";
+        break;
+    case Operation::BITWISE_AND_REGISTER:
+        code << rx << " = " << logical(rx + " & " + ry) << ";";
+        break;
+    case Operation::BITWISE_AND_REGISTERS:
+        code << rz << " = " << logical(rx + " & " + ry) << ";";
+        break;
+    case Operation::BITWISE_TEST_IMMEDIATE:
+        if (evaluateFlags)
+            code << "cpu.updateLogicalFlags(" << rx << " & " << imm << ");";
+        break;
+    case Operation::BITWISE_TEST_REGISTER:
+        if (evaluateFlags)
+            code << "cpu.updateLogicalFlags(" << rx << " & " << ry << ");";
+        break;
+    case Operation::BITWISE_OR_IMMEDIATE:
+        code << rx << " = " << logical(rx + " | " + imm) << ";";
+        break;
+    case Operation::BITWISE_OR_REGISTER:
+        code << rx << " = " << logical(rx + " | " + ry) << ";";
+        break;
+    case Operation::BITWISE_OR_REGISTERS:
+        code << rz << " = " << logical(rx + " | " + ry) << ";";
+        break;
+    case Operation::BITWISE_XOR_IMMEDIATE:
+        code << rx << " = " << logical(rx + " ^ " + imm) << ";";
+        break;
+    case Operation::BITWISE_XOR_REGISTER:
+        code << rx << " = " << logical(rx + " ^ " + ry) << ";";
+        break;
+    case Operation::BITWISE_XOR_REGISTERS:
+        code << rz << " = " << logical(rx + " ^ " + ry) << ";";
+        break;
+    case Operation::LOGICAL_SHIFT_LEFT_IMMEDIATE:
+        code << rx << " = " << logical(rx + " << " + std::to_string(z)) << ";";
+        break;
+    case Operation::LOGICAL_SHIFT_RIGHT_IMMEDIATE:
+        code << rx << " = " << logical(rx + " >> " + std::to_string(z)) << ";";
+        break;
+
+    case Operation::JUMP:
+        code << "registers.pc = " << imm << ";";
+        break;
+    case Operation::JUMP_CARRY:
+        // Carry is set exactly when the condition below is met
+        code << "registers.pc = cpu.evaluateCondition(" << static_cast<unsigned>(ConditionalBranch::BELOW) << ") ? "
+             << imm << " : " << next << ";";
+        break;
+    case Operation::JUMP_REGS_EQUAL:
+        code << "registers.pc = " << rx << " == " << ry << " ? " << imm << " : " << next << ";";
+        break;
+    case Operation::CALL:
+        // Stack is accessed with program counter past the instruction, as in the interpreter
+        code << "registers.pc = " << next << ";\n"
+             << "        cpu.pushIntoStack(" << next << ");\n"
+             << "        registers.pc = " << imm << ";";
+        break;
+    case Operation::RETURN:
+        code << "registers.pc = " << next << ";\n"
+             << "        registers.pc = cpu.popFromStack();";
+        break;
+    case Operation::JUMP_INDIRECT:
+        code << "registers.pc = " << rx << ";";
+        break;
+    case Operation::CALL_INDIRECT:
+        code << "const u16 target = " << rx << ";\n"
+             << "        registers.pc = " << next << ";\n"
+             << "        cpu.pushIntoStack(" << next << ");\n"
+             << "        registers.pc = target;";
+        break;
+    case Operation::JUMP_CONDITIONALLY:
+        if (x == 0xF)
+        {
+            translated = false;
+            break;
+        }
+        code << "registers.pc = cpu.evaluateCondition(" << x << ") ? " << imm << " : " << next << ";";
+        break;
+    case Operation::CALL_CONDITIONALLY:
+        if (x == 0xF)
+        {
+            translated = false;
+            break;
+        }
+        code << "const bool condition = cpu.evaluateCondition(" << x << ");\n"
+             << "        registers.pc = " << next << ";\n"
+             << "        if (condition)\n"
+             << "            cpu.pushIntoStack(" << next << ");\n"
+             << "        registers.pc = condition ? " << imm << " : " << next << ";";
+        break;
+
+    default:
+        translated = false;
+        break;
+    }
+
+    // Remaining instructions are executed by the interpreter
+    if (!translated)
+    {
+        const auto arguments = hex(instruction.addr) + ", " + hex(instruction.opcode) + ", " + imm;
+        if (InstructionSet::endsBasicBlock(operation))
+            code << "cpu.interpret(" << arguments << ");";
+        else
+            code << "if (!cpu.interpret(" << arguments << "))\n"
+                 << "            return;";
+    }
+
+    // Jumps closing idle loops are noted whether taken or not, as in the interpreter
+    const auto idleLoopLength = translated && InstructionSet::endsBasicBlock(operation) ? findIdleLoopLength(instruction) : 0;
+    if (idleLoopLength != 0)
+        code << "\n        cpu.noteIdleLoop(" << imm << ", " << idleLoopLength << ");";
+
+    if (!code.str().empty())
+        os << "        " << code.str() << "\n";
+}
+
+Operation RomTranslator::getOperation(const Instruction& instruction)
+{
+    return InstructionSet::describe(instruction.opcode >> 8).operation;
+}
+
+std::string RomTranslator::hex(unsigned value)
+{
+    std::ostringstream os;
+    os << "0x" << std::uppercase << std::hex << std::setw(4) << std::setfill('0') << value;
+    return os.str();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <ostream>
+#include <string>
+
+#include "../../src/core/Memory.hpp"
+#include "../../src/core/InstructionSet.hpp"
+#include "../../src/log/Logger.hpp"
+
+/**
+ * Translates chip16 code reachable from entry address into C++ translation unit
+ * with one function per basic block, executed at runtime by AotCpuImpl.
+ */
+class RomTranslator
+{
+public:
+    RomTranslator(const Memory& memory);
+
+    ~RomTranslator() = default;
+
+    /**
+     * Walks code reachable from given address through direct jumps, calls and fall-through.
+     * Targets of computed jumps are not followed.
+     *
+     * @param entryAddress Address at which the execution starts.
+     */
+    void translate(u16 entryAddress);
+
+    /**
+     * Writes translation unit defining translated program.
+     *
+     * @param os Stream to write translation unit into.
+     * @param romName Name of the ROM written into the header comment.
+     */
+    void writeProgram(std::ostream& os, const std::string& romName) const;
+
+    /**
+     * Returns number of translated blocks.
+     *
+     * @return Number of blocks.
+     */
+    std::size_t getBlocksCount() const;
+
+private:
+    struct Instruction
+    {
+        u16 addr;
+        u16 opcode;
+        u16 operand;
+    };
+
+    struct Block
+    {
+        u16 startAddress;
+        u32 endAddress;
+        std::vector<Instruction> instructions;
+    };
+
+    Block decodeBlock(u16 addr) const;
+    std::vector<u16> findSuccessors(const Block& block) const;
+    u32 calculateChecksum(const Block& block) const;
+    unsigned findIdleLoopLength(const Instruction& jump) const;
+
+    void writeBlock(std::ostream& os, const Block& block) const;
+    void writeInstruction(std::ostream& os, const Instruction& instruction, bool evaluateFlags) const;
+
+    static Operation getOperation(const Instruction& instruction);
+    static std::string hex(unsigned value);
+
+    static constexpr unsigned MAX_BLOCK_INSTRUCTIONS = 256;
+
+    const Memory& memory;
+    std::map<u16, Block> blocks;
+
+    static Logger LOG;
+};
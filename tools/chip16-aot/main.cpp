@@ -0,0 +1,37 @@
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+#include "RomTranslator.hpp"
+
+#include "../../src/core/CpuImpl.hpp"
+#include "../../src/core/MemoryImpl.hpp"
+#include "../../src/facades/RomFacadeImpl.hpp"
+#include "../../src/facades/RomFileInputStream.hpp"
+
+int main(int argc, char ** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: chip16-aot <rom.c16> <output.cpp>" << std::endl;
+        return 1;
+    }
+
+    auto memory = std::make_shared<MemoryImpl>();
+    auto cpu = std::make_shared<CpuImpl>(memory, nullptr);
+    RomFacadeImpl romFacade(cpu, memory);
+    if (!romFacade.loadRomIntoMemory(std::make_shared<RomFileInputStream>(argv[1])))
+        return 1;
+
+    RomTranslator translator(*memory);
+    translator.translate(cpu->getRegisters().pc);
+
+    std::ofstream output(argv[2]);
+    translator.writeProgram(output, argv[1]);
+    if (!output)
+    {
+        std::cerr << "Could not write " << argv[2] << std::endl;
+        return 1;
+    }
+    return 0;
+}